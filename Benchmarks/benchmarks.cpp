@@ -0,0 +1,579 @@
+#include "benchmarks.h"
+
+#include <core/defines.h>
+#include <core/engine.h>
+#include <core/platform.h>
+#include <core/memory.h>
+#include <core/logging.h>
+#include <core/cvars.h>
+#include <core/job_system.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <immintrin.h>
+
+// usage: Benchmarks [--threads max_worker_count] [--filter benchmark_name] [--sizes memory_stats.csv]
+// every job benchmark runs for 1, 2, 4 ... max_worker_count workers and prints one line per worker count,
+// the arena benchmarks run once on the main thread, the memory benchmarks are in memory_benchmarks.cpp.
+// the output has no timestamps so runs from two commits on the same machine can be diffed directly.
+
+#define HE_BENCHMARK_JOBS_PER_ROUND 2048 // stays below the job pool capacity of a single worker.
+#define HE_BENCHMARK_CHAIN_COUNT 8
+#define HE_BENCHMARK_FAN_OUT_COUNT 256
+#define HE_BENCHMARK_SUBMITTER_THREAD_COUNT 4
+#define HE_BENCHMARK_MAX_PAYLOAD_SIZE 1024
+#define HE_BENCHMARK_STAGING_SIZE HE_MEGA_BYTES(64) // about a sponza texture set.
+#define HE_BENCHMARK_RANDOM_READ_SIZE HE_MEGA_BYTES(512)
+#define HE_BENCHMARK_RANDOM_READ_COUNT (4 * 1024 * 1024)
+
+struct Job_Sample
+{
+    U64 submit_time;
+    U64 start_time;
+    U64 end_time;
+
+    // latency is measured from the later of submit_time and the end of the dependency.
+    Job_Sample *dependency;
+};
+
+struct Sample_Job_Parameters
+{
+    Job_Sample *sample;
+};
+
+// returns the elapsed performance counter ticks of the measured part.
+typedef U64 (*Benchmark_Proc)(Job_Sample *samples, U32 job_count);
+
+struct Benchmark
+{
+    const char *name;
+    Benchmark_Proc proc;
+    U32 job_count;
+};
+
+static volatile U64 payload_checksum;
+
+static Job_Result sample_job(const Job_Parameters &params)
+{
+    Sample_Job_Parameters *sample_job_params = (Sample_Job_Parameters *)params.data;
+    Job_Sample *sample = sample_job_params->sample;
+    sample->start_time = platform_get_performance_counter();
+
+    // payload jobs read their parameters the way a real job would.
+    if (params.size > sizeof(Sample_Job_Parameters))
+    {
+        const U8 *payload = (const U8 *)params.data;
+        U64 checksum = 0;
+        for (U64 byte_index = sizeof(Sample_Job_Parameters); byte_index < params.size; byte_index++)
+        {
+            checksum += payload[byte_index];
+        }
+        payload_checksum = payload_checksum + checksum;
+    }
+
+    sample->end_time = platform_get_performance_counter();
+    return Job_Result::SUCCEEDED;
+}
+
+static Job_Data make_sample_job(Sample_Job_Parameters *params, U64 size = sizeof(Sample_Job_Parameters))
+{
+    return
+    {
+        .parameters =
+        {
+            .data = params,
+            .size = size,
+            .alignment = alignof(Sample_Job_Parameters)
+        },
+        .proc = &sample_job,
+        .name = "benchmark"
+    };
+}
+
+static Job_Handle submit_sample_job(Job_Sample *sample, Array_View< Job_Handle > wait_for_jobs = { 0, nullptr })
+{
+    Sample_Job_Parameters params = { .sample = sample };
+    sample->submit_time = platform_get_performance_counter();
+    return execute_job(make_sample_job(&params), wait_for_jobs);
+}
+
+static U64 empty_jobs_benchmark(Job_Sample *samples, U32 job_count)
+{
+    U64 begin = platform_get_performance_counter();
+
+    for (U32 round_start = 0; round_start < job_count; round_start += HE_BENCHMARK_JOBS_PER_ROUND)
+    {
+        U32 round_end = HE_MIN(round_start + HE_BENCHMARK_JOBS_PER_ROUND, job_count);
+        for (U32 job_index = round_start; job_index < round_end; job_index++)
+        {
+            submit_sample_job(&samples[job_index]);
+        }
+        wait_for_all_jobs_to_finish();
+    }
+
+    return platform_get_performance_counter() - begin;
+}
+
+static U64 dependency_chain_benchmark(Job_Sample *samples, U32 job_count)
+{
+    U32 depth = HE_BENCHMARK_JOBS_PER_ROUND / HE_BENCHMARK_CHAIN_COUNT;
+
+    U64 begin = platform_get_performance_counter();
+
+    for (U32 round_start = 0; round_start < job_count; round_start += HE_BENCHMARK_JOBS_PER_ROUND)
+    {
+        Job_Handle previous_jobs[HE_BENCHMARK_CHAIN_COUNT];
+        Job_Sample *previous_samples[HE_BENCHMARK_CHAIN_COUNT] = {};
+
+        // chains are submitted interleaved so they run concurrently.
+        for (U32 depth_index = 0; depth_index < depth; depth_index++)
+        {
+            for (U32 chain_index = 0; chain_index < HE_BENCHMARK_CHAIN_COUNT; chain_index++)
+            {
+                Job_Sample *sample = &samples[round_start + depth_index * HE_BENCHMARK_CHAIN_COUNT + chain_index];
+                sample->dependency = previous_samples[chain_index];
+
+                Array_View< Job_Handle > wait_for_jobs = { depth_index ? 1u : 0u, &previous_jobs[chain_index] };
+                previous_jobs[chain_index] = submit_sample_job(sample, wait_for_jobs);
+                previous_samples[chain_index] = sample;
+            }
+        }
+
+        wait_for_all_jobs_to_finish();
+    }
+
+    return platform_get_performance_counter() - begin;
+}
+
+static U64 fan_out_fan_in_benchmark(Job_Sample *samples, U32 job_count)
+{
+    U32 round_job_count = HE_BENCHMARK_FAN_OUT_COUNT + 2;
+
+    U64 begin = platform_get_performance_counter();
+
+    for (U32 round_start = 0; round_start + round_job_count <= job_count; round_start += round_job_count)
+    {
+        Job_Sample *root_sample = &samples[round_start];
+        Job_Sample *join_sample = &samples[round_start + round_job_count - 1];
+
+        Job_Counter counter;
+        init_job_counter(&counter, HE_BENCHMARK_FAN_OUT_COUNT);
+
+        Job_Handle root_job = submit_sample_job(root_sample);
+
+        U64 last_child_end_time = 0;
+        for (U32 child_index = 0; child_index < HE_BENCHMARK_FAN_OUT_COUNT; child_index++)
+        {
+            Job_Sample *sample = &samples[round_start + 1 + child_index];
+            sample->dependency = root_sample;
+
+            Sample_Job_Parameters params = { .sample = sample };
+            Job_Data job_data = make_sample_job(&params);
+            job_data.signal_counter = &counter;
+
+            sample->submit_time = platform_get_performance_counter();
+            execute_job(job_data, { 1, &root_job });
+        }
+
+        Sample_Job_Parameters params = { .sample = join_sample };
+        join_sample->submit_time = platform_get_performance_counter();
+        Job_Handle join_job = execute_job(make_sample_job(&params), &counter);
+        wait_for_job_to_finish(join_job);
+
+        // the join job depends on the child that finished last.
+        for (U32 child_index = 0; child_index < HE_BENCHMARK_FAN_OUT_COUNT; child_index++)
+        {
+            Job_Sample *sample = &samples[round_start + 1 + child_index];
+            if (sample->end_time >= last_child_end_time)
+            {
+                last_child_end_time = sample->end_time;
+                join_sample->dependency = sample;
+            }
+        }
+    }
+
+    return platform_get_performance_counter() - begin;
+}
+
+static U64 mixed_payloads_benchmark(Job_Sample *samples, U32 job_count)
+{
+    static constexpr U64 payload_sizes[] = { sizeof(Sample_Job_Parameters), HE_JOB_INLINE_PARAMETERS_SIZE, 256, HE_BENCHMARK_MAX_PAYLOAD_SIZE };
+
+    alignas(Sample_Job_Parameters) U8 payload[HE_BENCHMARK_MAX_PAYLOAD_SIZE];
+    for (U32 byte_index = 0; byte_index < HE_BENCHMARK_MAX_PAYLOAD_SIZE; byte_index++)
+    {
+        payload[byte_index] = (U8)byte_index;
+    }
+
+    U64 begin = platform_get_performance_counter();
+
+    for (U32 round_start = 0; round_start < job_count; round_start += HE_BENCHMARK_JOBS_PER_ROUND)
+    {
+        U32 round_end = HE_MIN(round_start + HE_BENCHMARK_JOBS_PER_ROUND, job_count);
+        for (U32 job_index = round_start; job_index < round_end; job_index++)
+        {
+            Job_Sample *sample = &samples[job_index];
+            Sample_Job_Parameters *params = (Sample_Job_Parameters *)payload;
+            params->sample = sample;
+
+            U64 payload_size = payload_sizes[job_index % HE_ARRAYCOUNT(payload_sizes)];
+            sample->submit_time = platform_get_performance_counter();
+            execute_job(make_sample_job(params, payload_size));
+        }
+        wait_for_all_jobs_to_finish();
+    }
+
+    return platform_get_performance_counter() - begin;
+}
+
+struct Submitter_Thread_Data
+{
+    std::atomic< bool > *go;
+    Job_Sample *samples;
+    U32 job_count;
+};
+
+static unsigned long submit_jobs_thread_proc(void *params)
+{
+    Submitter_Thread_Data *data = (Submitter_Thread_Data *)params;
+
+    while (!data->go->load(std::memory_order_acquire))
+    {
+        _mm_pause();
+    }
+
+    for (U32 job_index = 0; job_index < data->job_count; job_index++)
+    {
+        submit_sample_job(&data->samples[job_index]);
+    }
+
+    return 0;
+}
+
+static U64 contended_submission_benchmark(Job_Sample *samples, U32 job_count)
+{
+    U32 jobs_per_submitter = HE_BENCHMARK_JOBS_PER_ROUND / HE_BENCHMARK_SUBMITTER_THREAD_COUNT;
+    U64 elapsed = 0;
+
+    for (U32 round_start = 0; round_start < job_count; round_start += HE_BENCHMARK_JOBS_PER_ROUND)
+    {
+        std::atomic< bool > go = false;
+
+        Thread threads[HE_BENCHMARK_SUBMITTER_THREAD_COUNT];
+        Submitter_Thread_Data thread_data[HE_BENCHMARK_SUBMITTER_THREAD_COUNT];
+
+        for (U32 thread_index = 0; thread_index < HE_BENCHMARK_SUBMITTER_THREAD_COUNT; thread_index++)
+        {
+            thread_data[thread_index] =
+            {
+                .go = &go,
+                .samples = &samples[round_start + thread_index * jobs_per_submitter],
+                .job_count = jobs_per_submitter
+            };
+
+            bool thread_created = platform_create_and_start_thread(&threads[thread_index], submit_jobs_thread_proc, &thread_data[thread_index], "HopeBenchmarkSubmitter");
+            HE_ASSERT(thread_created);
+        }
+
+        // thread creation is not measured.
+        U64 begin = platform_get_performance_counter();
+        go.store(true, std::memory_order_release);
+
+        for (U32 thread_index = 0; thread_index < HE_BENCHMARK_SUBMITTER_THREAD_COUNT; thread_index++)
+        {
+            bool joined = platform_join_thread(&threads[thread_index]);
+            HE_ASSERT(joined);
+        }
+
+        wait_for_all_jobs_to_finish();
+        elapsed += platform_get_performance_counter() - begin;
+    }
+
+    return elapsed;
+}
+
+static Benchmark benchmarks[] =
+{
+    { "empty_jobs",           &empty_jobs_benchmark,           64 * HE_BENCHMARK_JOBS_PER_ROUND },
+    { "dependency_chain",     &dependency_chain_benchmark,     16 * HE_BENCHMARK_JOBS_PER_ROUND },
+    { "fan_out_fan_in",       &fan_out_fan_in_benchmark,       64 * (HE_BENCHMARK_FAN_OUT_COUNT + 2) },
+    { "mixed_payloads",       &mixed_payloads_benchmark,       32 * HE_BENCHMARK_JOBS_PER_ROUND },
+    { "contended_submission", &contended_submission_benchmark, 32 * HE_BENCHMARK_JOBS_PER_ROUND },
+};
+
+//
+// Arena Benchmarks
+//
+
+// returns the elapsed performance counter ticks of one round.
+typedef U64 (*Arena_Benchmark_Proc)(Memory_Arena *arena, Allocation_Flags flags, U8 *source);
+
+struct Arena_Benchmark
+{
+    const char *name;
+    Arena_Benchmark_Proc proc;
+    U64 size; // bytes touched per round.
+    U64 operation_count; // per round.
+    Memory_Arena_Flags arena_flags;
+    Allocation_Flags allocation_flags;
+};
+
+// fills a staging buffer the way the importers do, the zeroing pass is pure extra bandwidth.
+static U64 staging_fill_benchmark(Memory_Arena *arena, Allocation_Flags flags, U8 *source)
+{
+    U64 begin = platform_get_performance_counter();
+
+    Temprary_Memory temprary_memory = begin_temprary_memory(arena);
+    U8 *buffer = (U8 *)allocate(arena, HE_BENCHMARK_STAGING_SIZE, 64, flags);
+    copy_memory(buffer, source, HE_BENCHMARK_STAGING_SIZE);
+    payload_checksum = payload_checksum + buffer[HE_BENCHMARK_STAGING_SIZE - 1];
+    end_temprary_memory(temprary_memory);
+
+    return platform_get_performance_counter() - begin;
+}
+
+// dependent reads of one cache line from random 4KB pages, almost every read misses the tlb with small pages.
+static U64 random_page_reads_benchmark(Memory_Arena *arena, Allocation_Flags flags, U8 *source)
+{
+    Temprary_Memory temprary_memory = begin_temprary_memory(arena);
+    U64 *buffer = (U64 *)allocate(arena, HE_BENCHMARK_RANDOM_READ_SIZE, 64, flags);
+
+    U64 page_count = HE_BENCHMARK_RANDOM_READ_SIZE / HE_KILO_BYTES(4);
+    U64 words_per_page = HE_KILO_BYTES(4) / sizeof(U64);
+
+    U64 begin = platform_get_performance_counter();
+
+    U64 state = 0x9E3779B97F4A7C15ull;
+    for (U32 read_index = 0; read_index < HE_BENCHMARK_RANDOM_READ_COUNT; read_index++)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        state += buffer[(state % page_count) * words_per_page];
+    }
+
+    U64 elapsed = platform_get_performance_counter() - begin;
+
+    payload_checksum = payload_checksum + state;
+    end_temprary_memory(temprary_memory);
+    return elapsed;
+}
+
+static Arena_Benchmark arena_benchmarks[] =
+{
+    { "arena_staging_zero",    &staging_fill_benchmark,      HE_BENCHMARK_STAGING_SIZE,     1,                               MemoryArenaFlag_None,       AllocationFlag_None   },
+    { "arena_staging_no_zero", &staging_fill_benchmark,      HE_BENCHMARK_STAGING_SIZE,     1,                               MemoryArenaFlag_None,       AllocationFlag_NoZero },
+    { "arena_random_reads",    &random_page_reads_benchmark, HE_BENCHMARK_RANDOM_READ_SIZE, HE_BENCHMARK_RANDOM_READ_COUNT, MemoryArenaFlag_None,       AllocationFlag_None   },
+    { "arena_random_reads_lp", &random_page_reads_benchmark, HE_BENCHMARK_RANDOM_READ_SIZE, HE_BENCHMARK_RANDOM_READ_COUNT, MemoryArenaFlag_LargePages, AllocationFlag_None   },
+};
+
+static void run_arena_benchmark(const Arena_Benchmark &benchmark, U8 *source)
+{
+    F64 ns_per_tick = 1000000000.0 / (F64)platform_get_performance_frequency();
+
+    Memory_Arena arena = {};
+    bool arena_inited = init_memory_arena(&arena, benchmark.size + HE_MEGA_BYTES(1), HE_MEGA_BYTES(64), -1, benchmark.arena_flags);
+    HE_ASSERT(arena_inited);
+
+    // falling back to small pages is reported instead of silently measuring the same thing twice.
+    bool large_pages = (arena.flags & MemoryArenaFlag_LargePages) != 0;
+
+    F64 ns_per_operation[HE_BENCHMARK_REPETITION_COUNT];
+
+    for (U32 repetition = 0; repetition <= HE_BENCHMARK_REPETITION_COUNT; repetition++)
+    {
+        U64 elapsed = benchmark.proc(&arena, benchmark.allocation_flags, source);
+
+        if (repetition == 0)
+        {
+            continue;
+        }
+
+        ns_per_operation[repetition - 1] = (F64)elapsed * ns_per_tick / (F64)benchmark.operation_count;
+    }
+
+    std::sort(ns_per_operation, ns_per_operation + HE_BENCHMARK_REPETITION_COUNT);
+
+    F64 median_ns = ns_per_operation[HE_BENCHMARK_REPETITION_COUNT / 2];
+    F64 gb_per_second = benchmark.operation_count == 1 ? (F64)benchmark.size / median_ns : 0.0;
+
+    printf("%-22s %7s %9llu %10.1f %10.2f\n", benchmark.name, large_pages ? "large" : "small", benchmark.size / HE_MEGA_BYTES(1), median_ns, gb_per_second);
+    fflush(stdout);
+
+    platform_deallocate_memory(arena.base);
+}
+
+static void run_benchmark(const Benchmark &benchmark, U32 worker_count, Allocator allocator)
+{
+    F64 ns_per_tick = 1000000000.0 / (F64)platform_get_performance_frequency();
+
+    Job_Sample *samples = HE_ALLOCATOR_ALLOCATE_ARRAY(allocator, Job_Sample, benchmark.job_count);
+    U64 *latencies = HE_ALLOCATOR_ALLOCATE_ARRAY(allocator, U64, benchmark.job_count * HE_BENCHMARK_REPETITION_COUNT);
+    U32 latency_count = 0;
+
+    F64 ns_per_job[HE_BENCHMARK_REPETITION_COUNT];
+
+    for (U32 repetition = 0; repetition <= HE_BENCHMARK_REPETITION_COUNT; repetition++)
+    {
+        zero_memory(samples, sizeof(Job_Sample) * benchmark.job_count);
+
+        U64 elapsed = benchmark.proc(samples, benchmark.job_count);
+
+        if (repetition == 0)
+        {
+            continue;
+        }
+
+        ns_per_job[repetition - 1] = (F64)elapsed * ns_per_tick / (F64)benchmark.job_count;
+
+        for (U32 sample_index = 0; sample_index < benchmark.job_count; sample_index++)
+        {
+            Job_Sample *sample = &samples[sample_index];
+            if (!sample->start_time)
+            {
+                continue;
+            }
+
+            U64 ready_time = sample->submit_time;
+            if (sample->dependency && sample->dependency->end_time > ready_time)
+            {
+                ready_time = sample->dependency->end_time;
+            }
+
+            latencies[latency_count++] = sample->start_time > ready_time ? sample->start_time - ready_time : 0;
+        }
+    }
+
+    std::sort(ns_per_job, ns_per_job + HE_BENCHMARK_REPETITION_COUNT);
+    std::sort(latencies, latencies + latency_count);
+
+    F64 median_ns_per_job = ns_per_job[HE_BENCHMARK_REPETITION_COUNT / 2];
+    F64 p50_us = latency_count ? (F64)latencies[latency_count / 2] * ns_per_tick / 1000.0 : 0.0;
+    F64 p99_us = latency_count ? (F64)latencies[(U64)latency_count * 99 / 100] * ns_per_tick / 1000.0 : 0.0;
+
+    printf("%-22s %7u %9u %10.1f %10.2f %10.2f\n", benchmark.name, worker_count, benchmark.job_count, median_ns_per_job, p50_us, p99_us);
+    fflush(stdout);
+
+    HE_ALLOCATOR_DEALLOCATE(allocator, latencies);
+    HE_ALLOCATOR_DEALLOCATE(allocator, samples);
+}
+
+int main(int argc, char **argv)
+{
+    bool memory_system_inited = init_memory_system();
+    if (!memory_system_inited)
+    {
+        return 1;
+    }
+
+    init_logging_system();
+    init_cvars(HE_STRING_LITERAL("benchmarks.cvars"));
+
+    U32 max_worker_count = get_job_thread_count();
+    const char *filter = nullptr;
+    const char *sizes_path = nullptr;
+
+    for (S32 arg_index = 1; arg_index + 1 < argc; arg_index += 2)
+    {
+        if (strcmp(argv[arg_index], "--threads") == 0)
+        {
+            max_worker_count = HE_MAX((U32)atoi(argv[arg_index + 1]), 1u);
+        }
+        else if (strcmp(argv[arg_index], "--filter") == 0)
+        {
+            filter = argv[arg_index + 1];
+        }
+        else if (strcmp(argv[arg_index], "--sizes") == 0)
+        {
+            sizes_path = argv[arg_index + 1];
+        }
+    }
+
+    Allocator general_allocator;
+    {
+        Memory_Context memory_context = grab_memory_context();
+        general_allocator = memory_context.general_allocator;
+    }
+
+    printf("# ns/job is the median of %u repetitions, latency is from a job being ready to it starting.\n", HE_BENCHMARK_REPETITION_COUNT);
+    printf("%-22s %7s %9s %10s %10s %10s\n", "benchmark", "workers", "jobs", "ns/job", "p50_us", "p99_us");
+
+    for (U32 benchmark_index = 0; benchmark_index < HE_ARRAYCOUNT(benchmarks); benchmark_index++)
+    {
+        const Benchmark &benchmark = benchmarks[benchmark_index];
+        if (filter && strcmp(filter, benchmark.name) != 0)
+        {
+            continue;
+        }
+
+        // 1, 2, 4 ... and max_worker_count even if it is not a power of two.
+        U32 worker_count = 1;
+        while (true)
+        {
+            bool job_system_inited = init_job_system(worker_count);
+            HE_ASSERT(job_system_inited);
+
+            run_benchmark(benchmark, worker_count, general_allocator);
+
+            deinit_job_system();
+
+            if (worker_count == max_worker_count)
+            {
+                break;
+            }
+            worker_count = HE_MIN(worker_count * 2, max_worker_count);
+        }
+    }
+
+    U8 *source = HE_ALLOCATOR_ALLOCATE_ARRAY(general_allocator, U8, HE_BENCHMARK_STAGING_SIZE);
+    for (U64 byte_index = 0; byte_index < HE_BENCHMARK_STAGING_SIZE; byte_index++)
+    {
+        source[byte_index] = (U8)(byte_index * 31);
+    }
+
+    printf("\n# ns/op is the median of %u repetitions, an op is a whole staging fill or a single random read.\n", HE_BENCHMARK_REPETITION_COUNT);
+    printf("%-22s %7s %9s %10s %10s\n", "benchmark", "pages", "MB", "ns/op", "GB/s");
+
+    for (U32 benchmark_index = 0; benchmark_index < HE_ARRAYCOUNT(arena_benchmarks); benchmark_index++)
+    {
+        const Arena_Benchmark &benchmark = arena_benchmarks[benchmark_index];
+        if (filter && strcmp(filter, benchmark.name) != 0)
+        {
+            continue;
+        }
+
+        run_arena_benchmark(benchmark, source);
+    }
+
+    HE_ALLOCATOR_DEALLOCATE(general_allocator, source);
+
+    run_memory_benchmarks(max_worker_count, filter, sizes_path);
+
+    deinit_cvars();
+    deinit_logging_system();
+    deinit_memory_system();
+    return 0;
+}
+
+// the engine library owns the platform entry point that references these, the benchmarks never start the engine.
+
+bool hope_app_init(Engine *engine)
+{
+    return true;
+}
+
+void hope_app_on_event(Engine *engine, Event event)
+{
+}
+
+void hope_app_on_update(Engine *engine, F32 delta_time)
+{
+}
+
+void hope_app_shutdown(Engine *engine)
+{
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <core/defines.h>
+
+#define HE_BENCHMARK_REPETITION_COUNT 5 // plus one warm up repetition that is not reported.
+
+// sizes_path is a memory_stats.csv dumped from the editor memory panel, the allocator benchmarks replay the
+// allocation size histogram of its last frame. without it they use a synthetic distribution.
+void run_memory_benchmarks(U32 max_thread_count, const char *filter, const char *sizes_path);
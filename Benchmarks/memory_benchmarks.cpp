@@ -0,0 +1,859 @@
+#include "benchmarks.h"
+
+#include <core/platform.h>
+#include <core/memory.h>
+#include <core/pool_allocator.h>
+
+#include <containers/dynamic_array.h>
+#include <containers/small_array.h>
+#include <containers/hash_map.h>
+#include <containers/resource_pool.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+// every allocator benchmark runs for 1, 2, 4 ... max_thread_count threads, the container benchmarks run on the main thread.
+// throughput is the median over the repetitions, latency is sampled with rdtsc every HE_MEMORY_BENCHMARK_LATENCY_SAMPLE_RATE ops
+// so the timing overhead stays out of the throughput.
+
+#define HE_MEMORY_BENCHMARK_MAX_THREAD_COUNT 64
+#define HE_MEMORY_BENCHMARK_OPERATION_COUNT (256 * 1024) // per thread and repetition.
+#define HE_MEMORY_BENCHMARK_LIVE_ALLOCATION_COUNT 1024 // per thread, every op frees the oldest allocation and makes a new one.
+#define HE_MEMORY_BENCHMARK_LATENCY_SAMPLE_RATE 8 // power of two.
+#define HE_MEMORY_BENCHMARK_SIZE_COUNT (64 * 1024) // power of two.
+#define HE_MEMORY_BENCHMARK_MAX_SIZE HE_KILO_BYTES(256) // bigger sizes are clamped to keep the live set bounded.
+#define HE_MEMORY_BENCHMARK_ARENA_RESET_SIZE HE_MEGA_BYTES(64)
+#define HE_MEMORY_BENCHMARK_CONTAINER_CAPACITY (64 * 1024)
+#define HE_MEMORY_BENCHMARK_APPEND_COUNT (1024 * 1024)
+#define HE_MEMORY_BENCHMARK_SMALL_LIST_COUNT 8
+
+#define HE_MEMORY_BENCHMARK_OPERATION(run, operation_index, operation)\
+    if (((operation_index) & (HE_MEMORY_BENCHMARK_LATENCY_SAMPLE_RATE - 1)) == 0)\
+    {\
+        U64 operation_begin = __rdtsc();\
+        operation;\
+        record_latency(run, __rdtsc() - operation_begin);\
+    }\
+    else\
+    {\
+        operation;\
+    }
+
+struct Benchmark_Object
+{
+    U64 data[8];
+};
+
+struct Benchmark_Run
+{
+    U64 operation_count;
+    U64 elapsed; // performance counter ticks.
+    U64 resident_size;
+
+    U64 *latencies; // rdtsc ticks.
+    U32 latency_count;
+    U32 latency_capacity;
+};
+
+static volatile U64 benchmark_checksum;
+
+static U32 benchmark_sizes[HE_MEMORY_BENCHMARK_SIZE_COUNT];
+static const char *benchmark_sizes_source;
+
+static Memory_Arena benchmark_arenas[HE_MEMORY_BENCHMARK_MAX_THREAD_COUNT];
+static Free_List_Allocator benchmark_free_list_allocator;
+static Free_List_Allocator benchmark_thread_cached_heap;
+static Thread_Cached_Allocator benchmark_thread_cached_allocator;
+static Pool_Allocator< Benchmark_Object > benchmark_pool_allocator;
+
+HE_FORCE_INLINE static void record_latency(Benchmark_Run *run, U64 ticks)
+{
+    if (run->latency_count < run->latency_capacity)
+    {
+        run->latencies[run->latency_count++] = ticks;
+    }
+}
+
+HE_FORCE_INLINE static U64 next_random(U64 *state)
+{
+    U64 x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+static F64 get_ns_per_rdtsc_tick()
+{
+    U64 frequency = platform_get_performance_frequency();
+    U64 begin_counter = platform_get_performance_counter();
+    U64 begin_tsc = __rdtsc();
+
+    U64 counter = begin_counter;
+    while (counter - begin_counter < frequency / 20)
+    {
+        counter = platform_get_performance_counter();
+    }
+
+    U64 tsc = __rdtsc() - begin_tsc;
+    return (F64)(counter - begin_counter) * 1000000000.0 / (F64)frequency / (F64)tsc;
+}
+
+//
+// Size Distribution
+//
+
+// reads the size rows of the last frame in a memory_stats.csv, bucket i counts allocations in [2^i, 2^(i+1)).
+static bool load_size_distribution(const char *path, U64 *out_bucket_counts)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        return false;
+    }
+
+    U64 last_frame_index = 0;
+    bool found = false;
+
+    char line[512];
+    while (fgets(line, sizeof(line), file))
+    {
+        unsigned long long frame_index = 0;
+        unsigned long long lower_bound = 0;
+        unsigned long long count = 0;
+        if (sscanf(line, "%llu,size,%llu,,,,%llu", &frame_index, &lower_bound, &count) != 3 || !lower_bound)
+        {
+            continue;
+        }
+
+        if (!found || frame_index != last_frame_index)
+        {
+            zero_memory(out_bucket_counts, sizeof(U64) * HE_ALLOCATION_SIZE_BUCKET_COUNT);
+            last_frame_index = frame_index;
+            found = true;
+        }
+
+        U32 bucket_index = 0;
+        while ((2ull << bucket_index) <= lower_bound && bucket_index + 1 < HE_ALLOCATION_SIZE_BUCKET_COUNT)
+        {
+            bucket_index++;
+        }
+        out_bucket_counts[bucket_index] += count;
+    }
+
+    fclose(file);
+    return found;
+}
+
+// mostly small nodes and strings with a tail of staging sized buffers.
+static void get_synthetic_size_distribution(U64 *out_bucket_counts)
+{
+    static constexpr U64 weights[] = { 0, 0, 0, 60, 200, 200, 150, 100, 80, 60, 50, 40, 30, 20, 10, 5, 3, 2, 1 };
+
+    zero_memory(out_bucket_counts, sizeof(U64) * HE_ALLOCATION_SIZE_BUCKET_COUNT);
+    for (U32 bucket_index = 0; bucket_index < HE_ARRAYCOUNT(weights); bucket_index++)
+    {
+        out_bucket_counts[bucket_index] = weights[bucket_index];
+    }
+}
+
+static void init_benchmark_sizes(const char *sizes_path)
+{
+    U64 bucket_counts[HE_ALLOCATION_SIZE_BUCKET_COUNT];
+    benchmark_sizes_source = "synthetic";
+
+    if (sizes_path)
+    {
+        if (load_size_distribution(sizes_path, bucket_counts))
+        {
+            benchmark_sizes_source = sizes_path;
+        }
+        else
+        {
+            fprintf(stderr, "failed to read allocation sizes from %s\n", sizes_path);
+        }
+    }
+
+    if (benchmark_sizes_source != sizes_path)
+    {
+        get_synthetic_size_distribution(bucket_counts);
+    }
+
+    U64 total_count = 0;
+    for (U32 bucket_index = 0; bucket_index < HE_ALLOCATION_SIZE_BUCKET_COUNT; bucket_index++)
+    {
+        total_count += bucket_counts[bucket_index];
+    }
+    HE_ASSERT(total_count);
+
+    // the same seed every run so two commits replay the exact same sizes.
+    U64 state = 0x9E3779B97F4A7C15ull;
+    for (U32 size_index = 0; size_index < HE_MEMORY_BENCHMARK_SIZE_COUNT; size_index++)
+    {
+        U64 pick = next_random(&state) % total_count;
+
+        U32 bucket_index = 0;
+        while (pick >= bucket_counts[bucket_index])
+        {
+            pick -= bucket_counts[bucket_index];
+            bucket_index++;
+        }
+
+        U64 size = (1ull << bucket_index) + next_random(&state) % (1ull << bucket_index);
+        benchmark_sizes[size_index] = (U32)HE_MIN(size, HE_MEMORY_BENCHMARK_MAX_SIZE);
+    }
+}
+
+//
+// Allocator Benchmarks
+//
+
+struct Allocator_Benchmark
+{
+    const char *name;
+    Allocator (*get_allocator)(U32 thread_index);
+    bool is_arena; // never frees, the arena is reset once it grows past HE_MEMORY_BENCHMARK_ARENA_RESET_SIZE.
+    U32 fixed_size; // 0 replays the size distribution.
+};
+
+struct Allocator_Benchmark_Thread
+{
+    Thread thread;
+    const Allocator_Benchmark *benchmark;
+    U32 thread_index;
+    std::atomic< bool > *go;
+    Benchmark_Run run;
+};
+
+static Allocator get_arena_allocator(U32 thread_index)
+{
+    return to_allocator(&benchmark_arenas[thread_index]);
+}
+
+static Allocator get_free_list_allocator(U32 thread_index)
+{
+    return to_allocator(&benchmark_free_list_allocator);
+}
+
+static Allocator get_thread_cached_allocator(U32 thread_index)
+{
+    return to_allocator(&benchmark_thread_cached_allocator);
+}
+
+static Allocator get_pool_allocator(U32 thread_index)
+{
+    return to_allocator(&benchmark_pool_allocator);
+}
+
+static Allocator_Benchmark allocator_benchmarks[] =
+{
+    { "memory_arena",          &get_arena_allocator,         true,  0                        },
+    { "free_list_allocator",   &get_free_list_allocator,     false, 0                        },
+    { "thread_cached",         &get_thread_cached_allocator, false, 0                        },
+    { "thread_cached_64b",     &get_thread_cached_allocator, false, sizeof(Benchmark_Object) },
+    { "pool_allocator_64b",    &get_pool_allocator,          false, sizeof(Benchmark_Object) },
+};
+
+static unsigned long allocator_benchmark_thread_proc(void *params)
+{
+    Allocator_Benchmark_Thread *data = (Allocator_Benchmark_Thread *)params;
+    const Allocator_Benchmark *benchmark = data->benchmark;
+    Benchmark_Run *run = &data->run;
+
+    Allocator allocator = benchmark->get_allocator(data->thread_index);
+    Memory_Arena *arena = benchmark->is_arena ? (Memory_Arena *)allocator.data : nullptr;
+
+    void *live_allocations[HE_MEMORY_BENCHMARK_LIVE_ALLOCATION_COUNT] = {};
+
+    // threads start at different offsets so they do not ask for the same size at the same time.
+    U32 size_offset = data->thread_index * (HE_MEMORY_BENCHMARK_SIZE_COUNT / HE_MEMORY_BENCHMARK_MAX_THREAD_COUNT);
+
+    while (!data->go->load(std::memory_order_acquire))
+    {
+        _mm_pause();
+    }
+
+    U64 begin = platform_get_performance_counter();
+
+    for (U32 operation_index = 0; operation_index < HE_MEMORY_BENCHMARK_OPERATION_COUNT; operation_index++)
+    {
+        U64 size = benchmark->fixed_size ? benchmark->fixed_size : benchmark_sizes[(size_offset + operation_index) & (HE_MEMORY_BENCHMARK_SIZE_COUNT - 1)];
+        void **live_allocation = &live_allocations[operation_index & (HE_MEMORY_BENCHMARK_LIVE_ALLOCATION_COUNT - 1)];
+
+        if (arena)
+        {
+            HE_MEMORY_BENCHMARK_OPERATION(run, operation_index,
+            {
+                if (arena->offset >= HE_MEMORY_BENCHMARK_ARENA_RESET_SIZE)
+                {
+                    arena->offset = 0;
+                }
+                *live_allocation = allocator.allocate(allocator.data, size, HE_DEFAULT_ALIGNMENT, AllocationFlag_NoZero);
+            });
+        }
+        else
+        {
+            HE_MEMORY_BENCHMARK_OPERATION(run, operation_index,
+            {
+                allocator.deallocate(allocator.data, *live_allocation);
+                *live_allocation = allocator.allocate(allocator.data, size, HE_DEFAULT_ALIGNMENT, AllocationFlag_NoZero);
+            });
+        }
+
+        // touch the memory the way a caller would.
+        *(U8 *)*live_allocation = (U8)operation_index;
+    }
+
+    run->elapsed = platform_get_performance_counter() - begin;
+    run->operation_count = HE_MEMORY_BENCHMARK_OPERATION_COUNT;
+
+    if (data->thread_index == 0)
+    {
+        run->resident_size = platform_get_resident_memory_size();
+    }
+
+    if (arena)
+    {
+        arena->offset = 0;
+    }
+    else
+    {
+        for (U32 allocation_index = 0; allocation_index < HE_MEMORY_BENCHMARK_LIVE_ALLOCATION_COUNT; allocation_index++)
+        {
+            allocator.deallocate(allocator.data, live_allocations[allocation_index]);
+        }
+    }
+
+    return 0;
+}
+
+static void report_benchmark(const char *name, U32 thread_count, U64 operation_count, F64 *mops, U64 *latencies, U32 latency_count, U64 resident_size, F64 ns_per_rdtsc_tick)
+{
+    std::sort(mops, mops + HE_BENCHMARK_REPETITION_COUNT);
+    std::sort(latencies, latencies + latency_count);
+
+    F64 p50_ns = latency_count ? (F64)latencies[latency_count / 2] * ns_per_rdtsc_tick : 0.0;
+    F64 p99_ns = latency_count ? (F64)latencies[(U64)latency_count * 99 / 100] * ns_per_rdtsc_tick : 0.0;
+
+    printf("%-28s %7u %9llu %10.2f %10.1f %10.1f %10.1f\n", name, thread_count, operation_count, mops[HE_BENCHMARK_REPETITION_COUNT / 2],
+           p50_ns, p99_ns, (F64)resident_size / (F64)HE_MEGA_BYTES(1));
+    fflush(stdout);
+}
+
+static void run_allocator_benchmark(const Allocator_Benchmark &benchmark, U32 thread_count, F64 ns_per_rdtsc_tick, Allocator allocator)
+{
+    F64 ticks_per_second = (F64)platform_get_performance_frequency();
+
+    U32 latency_capacity = HE_MEMORY_BENCHMARK_OPERATION_COUNT / HE_MEMORY_BENCHMARK_LATENCY_SAMPLE_RATE;
+    U64 *thread_latencies = HE_ALLOCATOR_ALLOCATE_ARRAY_NO_ZERO(allocator, U64, (U64)latency_capacity * thread_count);
+    U64 *latencies = HE_ALLOCATOR_ALLOCATE_ARRAY_NO_ZERO(allocator, U64, (U64)latency_capacity * thread_count * HE_BENCHMARK_REPETITION_COUNT);
+    U32 latency_count = 0;
+
+    Allocator_Benchmark_Thread threads[HE_MEMORY_BENCHMARK_MAX_THREAD_COUNT];
+    F64 mops[HE_BENCHMARK_REPETITION_COUNT];
+    U64 resident_size = 0;
+
+    for (U32 repetition = 0; repetition <= HE_BENCHMARK_REPETITION_COUNT; repetition++)
+    {
+        std::atomic< bool > go = false;
+
+        for (U32 thread_index = 0; thread_index < thread_count; thread_index++)
+        {
+            Allocator_Benchmark_Thread *thread = &threads[thread_index];
+            thread->benchmark = &benchmark;
+            thread->thread_index = thread_index;
+            thread->go = &go;
+            thread->run = { .latencies = &thread_latencies[thread_index * latency_capacity], .latency_capacity = latency_capacity };
+
+            bool thread_created = platform_create_and_start_thread(&thread->thread, allocator_benchmark_thread_proc, thread, "HopeBenchmarkAllocator");
+            HE_ASSERT(thread_created);
+        }
+
+        go.store(true, std::memory_order_release);
+
+        U64 slowest_elapsed = 0;
+        U64 operation_count = 0;
+
+        for (U32 thread_index = 0; thread_index < thread_count; thread_index++)
+        {
+            bool joined = platform_join_thread(&threads[thread_index].thread);
+            HE_ASSERT(joined);
+
+            slowest_elapsed = HE_MAX(slowest_elapsed, threads[thread_index].run.elapsed);
+            operation_count += threads[thread_index].run.operation_count;
+        }
+
+        if (repetition == 0)
+        {
+            continue;
+        }
+
+        mops[repetition - 1] = (F64)operation_count / ((F64)slowest_elapsed / ticks_per_second) / 1000000.0;
+        resident_size = HE_MAX(resident_size, threads[0].run.resident_size);
+
+        for (U32 thread_index = 0; thread_index < thread_count; thread_index++)
+        {
+            const Benchmark_Run &run = threads[thread_index].run;
+            copy_memory(&latencies[latency_count], run.latencies, sizeof(U64) * run.latency_count);
+            latency_count += run.latency_count;
+        }
+    }
+
+    report_benchmark(benchmark.name, thread_count, (U64)HE_MEMORY_BENCHMARK_OPERATION_COUNT * thread_count, mops, latencies, latency_count, resident_size, ns_per_rdtsc_tick);
+
+    HE_ALLOCATOR_DEALLOCATE(allocator, latencies);
+    HE_ALLOCATOR_DEALLOCATE(allocator, thread_latencies);
+}
+
+//
+// Container Benchmarks
+//
+
+// parameter is the load factor in percent for the hash map benchmarks and unused otherwise.
+typedef void (*Container_Benchmark_Proc)(Benchmark_Run *run, U32 parameter, Allocator allocator);
+
+struct Container_Benchmark
+{
+    const char *name;
+    Container_Benchmark_Proc proc;
+    U32 parameter;
+};
+
+// random keys so the benchmark does not depend on the hash function spreading sequential ones.
+static U64 *make_hash_map_keys(U32 count, U64 seed, Allocator allocator)
+{
+    U64 *keys = HE_ALLOCATOR_ALLOCATE_ARRAY_NO_ZERO(allocator, U64, count);
+    U64 state = seed;
+    for (U32 key_index = 0; key_index < count; key_index++)
+    {
+        keys[key_index] = next_random(&state);
+    }
+    return keys;
+}
+
+enum class Hash_Map_Operation : U8
+{
+    INSERT,
+    FIND,
+    FIND_MISS,
+    REMOVE,
+    CHURN // removes a key and inserts a new one, leaves deleted slots behind.
+};
+
+// load_percent is of the HE_MEMORY_BENCHMARK_CONTAINER_CAPACITY slots, 0 inserts up to the max load into a map that starts empty and grows.
+static void hash_map_benchmark(Benchmark_Run *run, U32 load_percent, Hash_Map_Operation operation, Allocator allocator)
+{
+    U32 max_key_count = get_hash_map_max_load(HE_MEMORY_BENCHMARK_CONTAINER_CAPACITY);
+    U32 key_count = load_percent ? HE_MIN(HE_MEMORY_BENCHMARK_CONTAINER_CAPACITY * load_percent / 100, max_key_count) : max_key_count;
+    U64 *keys = make_hash_map_keys(key_count, 0x9E3779B97F4A7C15ull, allocator);
+    U64 *missing_keys = make_hash_map_keys(key_count, 0xD1B54A32D192ED03ull, allocator);
+
+    Hash_Map< U64, U64 > hash_map;
+    init(&hash_map, load_percent ? max_key_count : 0, allocator);
+
+    U64 checksum = 0;
+    U64 begin = platform_get_performance_counter();
+
+    for (U32 key_index = 0; key_index < key_count; key_index++)
+    {
+        if (operation == Hash_Map_Operation::INSERT)
+        {
+            HE_MEMORY_BENCHMARK_OPERATION(run, key_index, insert(&hash_map, keys[key_index], (U64)key_index));
+        }
+        else
+        {
+            insert(&hash_map, keys[key_index], (U64)key_index);
+        }
+    }
+
+    if (operation != Hash_Map_Operation::INSERT)
+    {
+        begin = platform_get_performance_counter();
+    }
+
+    for (U32 key_index = 0; key_index < key_count && operation != Hash_Map_Operation::INSERT; key_index++)
+    {
+        switch (operation)
+        {
+            case Hash_Map_Operation::FIND:
+            {
+                HE_MEMORY_BENCHMARK_OPERATION(run, key_index, checksum += *find(&hash_map, keys[key_index]).value);
+            } break;
+
+            case Hash_Map_Operation::FIND_MISS:
+            {
+                HE_MEMORY_BENCHMARK_OPERATION(run, key_index, checksum += is_valid(find(&hash_map, missing_keys[key_index])));
+            } break;
+
+            case Hash_Map_Operation::REMOVE:
+            {
+                HE_MEMORY_BENCHMARK_OPERATION(run, key_index, remove(&hash_map, keys[key_index]));
+            } break;
+
+            case Hash_Map_Operation::CHURN:
+            {
+                HE_MEMORY_BENCHMARK_OPERATION(run, key_index,
+                {
+                    remove(&hash_map, keys[key_index]);
+                    insert(&hash_map, missing_keys[key_index], (U64)key_index);
+                });
+            } break;
+
+            default: break;
+        }
+    }
+
+    run->elapsed = platform_get_performance_counter() - begin;
+    run->operation_count = key_count;
+    run->resident_size = platform_get_resident_memory_size();
+    benchmark_checksum = benchmark_checksum + checksum + hash_map.count;
+
+    deinit(&hash_map);
+    HE_ALLOCATOR_DEALLOCATE(allocator, missing_keys);
+    HE_ALLOCATOR_DEALLOCATE(allocator, keys);
+}
+
+static void hash_map_insert_benchmark(Benchmark_Run *run, U32 load_percent, Allocator allocator)
+{
+    hash_map_benchmark(run, load_percent, Hash_Map_Operation::INSERT, allocator);
+}
+
+static void hash_map_find_benchmark(Benchmark_Run *run, U32 load_percent, Allocator allocator)
+{
+    hash_map_benchmark(run, load_percent, Hash_Map_Operation::FIND, allocator);
+}
+
+static void hash_map_find_miss_benchmark(Benchmark_Run *run, U32 load_percent, Allocator allocator)
+{
+    hash_map_benchmark(run, load_percent, Hash_Map_Operation::FIND_MISS, allocator);
+}
+
+static void hash_map_remove_benchmark(Benchmark_Run *run, U32 load_percent, Allocator allocator)
+{
+    hash_map_benchmark(run, load_percent, Hash_Map_Operation::REMOVE, allocator);
+}
+
+static void hash_map_churn_benchmark(Benchmark_Run *run, U32 load_percent, Allocator allocator)
+{
+    hash_map_benchmark(run, load_percent, Hash_Map_Operation::CHURN, allocator);
+}
+
+template< typename T >
+static void dynamic_array_append_benchmark(Benchmark_Run *run, bool reserve, Allocator allocator)
+{
+    Dynamic_Array< T > array = make_dynamic_array< T >(allocator);
+    if (reserve)
+    {
+        set_capacity(&array, HE_MEMORY_BENCHMARK_APPEND_COUNT);
+    }
+
+    T item = {};
+    U64 begin = platform_get_performance_counter();
+
+    for (U32 item_index = 0; item_index < HE_MEMORY_BENCHMARK_APPEND_COUNT; item_index++)
+    {
+        HE_MEMORY_BENCHMARK_OPERATION(run, item_index, append(&array, item));
+    }
+
+    run->elapsed = platform_get_performance_counter() - begin;
+    run->operation_count = HE_MEMORY_BENCHMARK_APPEND_COUNT;
+    run->resident_size = platform_get_resident_memory_size();
+    benchmark_checksum = benchmark_checksum + array.count;
+
+    deinit(&array);
+}
+
+static void dynamic_array_append_u32_benchmark(Benchmark_Run *run, U32 parameter, Allocator allocator)
+{
+    dynamic_array_append_benchmark< U32 >(run, false, allocator);
+}
+
+static void dynamic_array_append_u32_reserved_benchmark(Benchmark_Run *run, U32 parameter, Allocator allocator)
+{
+    dynamic_array_append_benchmark< U32 >(run, true, allocator);
+}
+
+static void dynamic_array_append_64b_benchmark(Benchmark_Run *run, U32 parameter, Allocator allocator)
+{
+    dynamic_array_append_benchmark< Benchmark_Object >(run, false, allocator);
+}
+
+template< typename Array_Type >
+static U32 build_small_list(Allocator allocator)
+{
+    Array_Type array = {};
+    array.allocator = allocator;
+
+    for (U32 item_index = 0; item_index < HE_MEMORY_BENCHMARK_SMALL_LIST_COUNT; item_index++)
+    {
+        append(&array, item_index);
+    }
+
+    U32 count = array.count;
+    deinit(&array);
+    return count;
+}
+
+// builds many short lists like render graph edges, an op is one whole list.
+template< typename Array_Type >
+static void small_list_benchmark(Benchmark_Run *run, Allocator allocator)
+{
+    U32 list_count = HE_MEMORY_BENCHMARK_APPEND_COUNT / HE_MEMORY_BENCHMARK_SMALL_LIST_COUNT;
+    U64 checksum = 0;
+    U64 begin = platform_get_performance_counter();
+
+    for (U32 list_index = 0; list_index < list_count; list_index++)
+    {
+        HE_MEMORY_BENCHMARK_OPERATION(run, list_index, checksum += build_small_list< Array_Type >(allocator));
+    }
+
+    run->elapsed = platform_get_performance_counter() - begin;
+    run->operation_count = list_count;
+    run->resident_size = platform_get_resident_memory_size();
+    benchmark_checksum = benchmark_checksum + checksum;
+}
+
+static void small_list_dynamic_array_benchmark(Benchmark_Run *run, U32 parameter, Allocator allocator)
+{
+    small_list_benchmark< Dynamic_Array< U32 > >(run, allocator);
+}
+
+static void small_list_small_array_benchmark(Benchmark_Run *run, U32 parameter, Allocator allocator)
+{
+    small_list_benchmark< Small_Array< U32, HE_MEMORY_BENCHMARK_SMALL_LIST_COUNT > >(run, allocator);
+}
+
+enum class Resource_Pool_Operation : U8
+{
+    ACQUIRE,
+    RELEASE,
+    ITERATE
+};
+
+static void resource_pool_benchmark(Benchmark_Run *run, Resource_Pool_Operation operation, Allocator allocator)
+{
+    Resource_Pool< Benchmark_Object > pool;
+    init(&pool, HE_MEMORY_BENCHMARK_CONTAINER_CAPACITY, allocator);
+
+    Resource_Handle< Benchmark_Object > *handles = HE_ALLOCATOR_ALLOCATE_ARRAY_NO_ZERO(allocator, Resource_Handle< Benchmark_Object >, HE_MEMORY_BENCHMARK_CONTAINER_CAPACITY);
+
+    U64 checksum = 0;
+    U32 operation_count = 0;
+    U64 begin = platform_get_performance_counter();
+
+    for (U32 handle_index = 0; handle_index < HE_MEMORY_BENCHMARK_CONTAINER_CAPACITY; handle_index++)
+    {
+        if (operation == Resource_Pool_Operation::ACQUIRE)
+        {
+            HE_MEMORY_BENCHMARK_OPERATION(run, handle_index, handles[handle_index] = acquire_handle(&pool));
+            operation_count++;
+        }
+        else
+        {
+            handles[handle_index] = acquire_handle(&pool);
+        }
+    }
+
+    if (operation == Resource_Pool_Operation::RELEASE)
+    {
+        begin = platform_get_performance_counter();
+
+        for (U32 handle_index = 0; handle_index < HE_MEMORY_BENCHMARK_CONTAINER_CAPACITY; handle_index++)
+        {
+            HE_MEMORY_BENCHMARK_OPERATION(run, handle_index, release_handle(&pool, handles[handle_index]));
+        }
+
+        operation_count = HE_MEMORY_BENCHMARK_CONTAINER_CAPACITY;
+    }
+    else if (operation == Resource_Pool_Operation::ITERATE)
+    {
+        // every other slot is free which is what a pool looks like after a level change.
+        for (U32 handle_index = 0; handle_index < HE_MEMORY_BENCHMARK_CONTAINER_CAPACITY; handle_index += 2)
+        {
+            release_handle(&pool, handles[handle_index]);
+        }
+
+        begin = platform_get_performance_counter();
+
+        bool has_next = true;
+        for (auto it = iterator(&pool); has_next; operation_count++)
+        {
+            HE_MEMORY_BENCHMARK_OPERATION(run, operation_count, has_next = next(&pool, it));
+            checksum += has_next ? get(&pool, it)->data[0] : 0;
+        }
+    }
+
+    run->elapsed = platform_get_performance_counter() - begin;
+    run->operation_count = operation_count;
+    run->resident_size = platform_get_resident_memory_size();
+    benchmark_checksum = benchmark_checksum + checksum;
+
+    HE_ALLOCATOR_DEALLOCATE(allocator, handles);
+    deinit(&pool);
+}
+
+static void resource_pool_acquire_benchmark(Benchmark_Run *run, U32 parameter, Allocator allocator)
+{
+    resource_pool_benchmark(run, Resource_Pool_Operation::ACQUIRE, allocator);
+}
+
+static void resource_pool_release_benchmark(Benchmark_Run *run, U32 parameter, Allocator allocator)
+{
+    resource_pool_benchmark(run, Resource_Pool_Operation::RELEASE, allocator);
+}
+
+static void resource_pool_iterate_benchmark(Benchmark_Run *run, U32 parameter, Allocator allocator)
+{
+    resource_pool_benchmark(run, Resource_Pool_Operation::ITERATE, allocator);
+}
+
+static Container_Benchmark container_benchmarks[] =
+{
+    { "hash_map_insert_25",            &hash_map_insert_benchmark,                   25 },
+    { "hash_map_insert_50",            &hash_map_insert_benchmark,                   50 },
+    { "hash_map_insert_75",            &hash_map_insert_benchmark,                   75 },
+    { "hash_map_insert_87",            &hash_map_insert_benchmark,                   87 },
+    { "hash_map_insert_growing",       &hash_map_insert_benchmark,                   0  },
+    { "hash_map_find_25",              &hash_map_find_benchmark,                     25 },
+    { "hash_map_find_50",              &hash_map_find_benchmark,                     50 },
+    { "hash_map_find_75",              &hash_map_find_benchmark,                     75 },
+    { "hash_map_find_87",              &hash_map_find_benchmark,                     87 },
+    { "hash_map_find_miss_25",         &hash_map_find_miss_benchmark,                25 },
+    { "hash_map_find_miss_50",         &hash_map_find_miss_benchmark,                50 },
+    { "hash_map_find_miss_75",         &hash_map_find_miss_benchmark,                75 },
+    { "hash_map_find_miss_87",         &hash_map_find_miss_benchmark,                87 },
+    { "hash_map_remove_25",            &hash_map_remove_benchmark,                   25 },
+    { "hash_map_remove_50",            &hash_map_remove_benchmark,                   50 },
+    { "hash_map_remove_75",            &hash_map_remove_benchmark,                   75 },
+    { "hash_map_remove_87",            &hash_map_remove_benchmark,                   87 },
+    { "hash_map_churn_50",             &hash_map_churn_benchmark,                    50 },
+    { "hash_map_churn_87",             &hash_map_churn_benchmark,                    87 },
+    { "dynamic_array_append_u32",      &dynamic_array_append_u32_benchmark,          0  },
+    { "dynamic_array_append_reserved", &dynamic_array_append_u32_reserved_benchmark, 0  },
+    { "dynamic_array_append_64b",      &dynamic_array_append_64b_benchmark,          0  },
+    { "small_list_dynamic_array",      &small_list_dynamic_array_benchmark,          0  },
+    { "small_list_small_array",        &small_list_small_array_benchmark,            0  },
+    { "resource_pool_acquire",         &resource_pool_acquire_benchmark,             0  },
+    { "resource_pool_release",         &resource_pool_release_benchmark,             0  },
+    { "resource_pool_iterate",         &resource_pool_iterate_benchmark,             0  },
+};
+
+static void run_container_benchmark(const Container_Benchmark &benchmark, F64 ns_per_rdtsc_tick, Allocator allocator)
+{
+    F64 ticks_per_second = (F64)platform_get_performance_frequency();
+
+    U32 latency_capacity = HE_MEMORY_BENCHMARK_APPEND_COUNT / HE_MEMORY_BENCHMARK_LATENCY_SAMPLE_RATE + 1;
+    U64 *latencies = HE_ALLOCATOR_ALLOCATE_ARRAY_NO_ZERO(allocator, U64, (U64)latency_capacity * (HE_BENCHMARK_REPETITION_COUNT + 1));
+    U32 latency_count = 0;
+
+    F64 mops[HE_BENCHMARK_REPETITION_COUNT];
+    U64 operation_count = 0;
+    U64 resident_size = 0;
+
+    for (U32 repetition = 0; repetition <= HE_BENCHMARK_REPETITION_COUNT; repetition++)
+    {
+        // the warm up repetition writes its latencies where the next one overwrites them.
+        Benchmark_Run run = { .latencies = &latencies[latency_count], .latency_capacity = latency_capacity };
+        benchmark.proc(&run, benchmark.parameter, allocator);
+
+        if (repetition == 0)
+        {
+            continue;
+        }
+
+        mops[repetition - 1] = (F64)run.operation_count / ((F64)run.elapsed / ticks_per_second) / 1000000.0;
+        operation_count = run.operation_count;
+        resident_size = HE_MAX(resident_size, run.resident_size);
+        latency_count += run.latency_count;
+    }
+
+    report_benchmark(benchmark.name, 1, operation_count, mops, latencies, latency_count, resident_size, ns_per_rdtsc_tick);
+
+    HE_ALLOCATOR_DEALLOCATE(allocator, latencies);
+}
+
+void run_memory_benchmarks(U32 max_thread_count, const char *filter, const char *sizes_path)
+{
+    max_thread_count = HE_MIN(max_thread_count, (U32)HE_MEMORY_BENCHMARK_MAX_THREAD_COUNT);
+
+    Allocator general_allocator;
+    {
+        Memory_Context memory_context = grab_memory_context();
+        general_allocator = memory_context.general_allocator;
+    }
+
+    F64 ns_per_rdtsc_tick = get_ns_per_rdtsc_tick();
+    init_benchmark_sizes(sizes_path);
+
+    for (U32 thread_index = 0; thread_index < max_thread_count; thread_index++)
+    {
+        bool arena_inited = init_memory_arena(&benchmark_arenas[thread_index], HE_MEMORY_BENCHMARK_ARENA_RESET_SIZE + HE_MEMORY_BENCHMARK_MAX_SIZE + HE_MEGA_BYTES(1), HE_MEGA_BYTES(1));
+        HE_ASSERT(arena_inited);
+    }
+
+    bool free_list_allocator_inited = init_free_list_allocator(&benchmark_free_list_allocator, nullptr, HE_GIGA_BYTES(16), HE_MEGA_BYTES(64), "benchmark_free_list_allocator");
+    HE_ASSERT(free_list_allocator_inited);
+
+    bool thread_cached_heap_inited = init_free_list_allocator(&benchmark_thread_cached_heap, nullptr, HE_GIGA_BYTES(16), HE_MEGA_BYTES(64), "benchmark_thread_cached_heap");
+    HE_ASSERT(thread_cached_heap_inited);
+
+    bool thread_cached_allocator_inited = init_thread_cached_allocator(&benchmark_thread_cached_allocator, &benchmark_thread_cached_heap);
+    HE_ASSERT(thread_cached_allocator_inited);
+
+    init(&benchmark_pool_allocator, 1024, to_allocator(&benchmark_free_list_allocator));
+
+    printf("\n# Mops/s is the median of %u repetitions, latency is sampled every %u ops, rss_mb is the process working set.\n", HE_BENCHMARK_REPETITION_COUNT, HE_MEMORY_BENCHMARK_LATENCY_SAMPLE_RATE);
+    printf("# allocation sizes: %s\n", benchmark_sizes_source);
+    printf("%-28s %7s %9s %10s %10s %10s %10s\n", "benchmark", "threads", "ops", "Mops/s", "p50_ns", "p99_ns", "rss_mb");
+
+    for (U32 benchmark_index = 0; benchmark_index < HE_ARRAYCOUNT(allocator_benchmarks); benchmark_index++)
+    {
+        const Allocator_Benchmark &benchmark = allocator_benchmarks[benchmark_index];
+        if (filter && strcmp(filter, benchmark.name) != 0)
+        {
+            continue;
+        }
+
+        // 1, 2, 4 ... and max_thread_count even if it is not a power of two.
+        U32 thread_count = 1;
+        while (true)
+        {
+            run_allocator_benchmark(benchmark, thread_count, ns_per_rdtsc_tick, general_allocator);
+
+            if (thread_count == max_thread_count)
+            {
+                break;
+            }
+            thread_count = HE_MIN(thread_count * 2, max_thread_count);
+        }
+    }
+
+    for (U32 benchmark_index = 0; benchmark_index < HE_ARRAYCOUNT(container_benchmarks); benchmark_index++)
+    {
+        const Container_Benchmark &benchmark = container_benchmarks[benchmark_index];
+        if (filter && strcmp(filter, benchmark.name) != 0)
+        {
+            continue;
+        }
+
+        run_container_benchmark(benchmark, ns_per_rdtsc_tick, general_allocator);
+    }
+
+    deinit(&benchmark_pool_allocator);
+
+    for (U32 thread_index = 0; thread_index < max_thread_count; thread_index++)
+    {
+        platform_deallocate_memory(benchmark_arenas[thread_index].base);
+    }
+}
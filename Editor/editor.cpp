@@ -15,6 +15,8 @@
 #include "widgets/inspector_panel.h"
 #include "widgets/scene_hierarchy_panel.h"
 #include "widgets/assets_panel.h"
+#include "widgets/job_system_panel.h"
+#include "widgets/memory_panel.h"
 
 struct Editor_State
 {
@@ -43,6 +45,7 @@ static void set_scene(Asset_Handle scene_asset)
 
 bool hope_app_init(Engine *engine)
 {
+    HE_MEMORY_TAG_SCOPE(Memory_Tag::EDITOR);
     Memory_Context memory_context = grab_memory_context();
 
     Editor_State *state = &editor_state;
@@ -249,6 +252,8 @@ void hope_app_on_event(Engine *engine, Event event)
 
 void hope_app_on_update(Engine *engine, F32 delta_time)
 {
+    HE_MEMORY_TAG_SCOPE(Memory_Tag::EDITOR);
+
 	Input *input = &engine->input;
 
     Camera *camera = &editor_state.camera;
@@ -294,6 +299,8 @@ void hope_app_on_update(Engine *engine, F32 delta_time)
             draw_graphics_window();
             
             Assets_Panel::draw();
+            Job_System_Panel::draw();
+            Memory_Panel::draw();
             
             if (is_asset_loaded(editor_state.scene_asset))
             {                
@@ -0,0 +1,113 @@
+#include "job_system_panel.h"
+
+#include <core/job_system.h>
+#include <core/memory.h>
+
+#include <imgui/imgui.h>
+
+namespace Job_System_Panel
+{
+
+struct Job_System_Panel_State
+{
+    S32 capture_frame_count = 60;
+    char capture_path[256] = "job_profile.json";
+};
+
+static Job_System_Panel_State job_system_panel_state;
+
+void draw()
+{
+    Job_System_Panel_State *state = &job_system_panel_state;
+
+    ImGui::Begin("Job System");
+
+    bool profiling = is_job_profiler_enabled();
+    if (ImGui::Checkbox("Profiling", &profiling))
+    {
+        set_job_profiler_enabled(profiling);
+    }
+
+    ImGui::InputInt("Capture Frames", &state->capture_frame_count);
+    state->capture_frame_count = HE_CLAMP(state->capture_frame_count, 1, 1024);
+    ImGui::InputText("Capture Path", state->capture_path, sizeof(state->capture_path));
+
+    bool capturing = is_capturing_job_profile();
+    ImGui::BeginDisabled(capturing);
+    if (ImGui::Button(capturing ? "Capturing..." : "Capture Chrome Trace"))
+    {
+        capture_job_profile((U32)state->capture_frame_count, HE_STRING(state->capture_path));
+    }
+    ImGui::EndDisabled();
+
+    Memory_Context memory_context = grab_memory_context();
+
+    Job_Profile_Summary summary = {};
+    if (!is_job_profiler_enabled() || !get_job_profile_summary(&summary, memory_context.temp_allocator))
+    {
+        ImGui::End();
+        return;
+    }
+
+    ImGui::Separator();
+    ImGui::Text("frame: %.3f ms", summary.frame_ms);
+
+    F64 main_thread_busy_ms = summary.thread_busy_ms[summary.thread_count - 1];
+    ImGui::Text("main thread waiting: %.3f ms (%.3f ms idle)", summary.main_thread_wait_ms, HE_MAX(summary.main_thread_wait_ms - main_thread_busy_ms, 0.0));
+
+    for (U32 thread_index = 0; thread_index < summary.thread_count; thread_index++)
+    {
+        F64 busy_ms = summary.thread_busy_ms[thread_index];
+        F32 utilization = summary.frame_ms > 0.0 ? (F32)(busy_ms / summary.frame_ms) : 0.0f;
+
+        String overlay = format_string(memory_context.temp_allocator, "%.3f ms", busy_ms);
+
+        if (thread_index == summary.thread_count - 1)
+        {
+            ImGui::Text("main  ");
+        }
+        else
+        {
+            ImGui::Text("%-6u", thread_index);
+        }
+        ImGui::SameLine();
+        ImGui::ProgressBar(HE_MIN(utilization, 1.0f), ImVec2(-1.0f, 0.0f), overlay.data);
+    }
+
+    ImGuiTableFlags table_flags = ImGuiTableFlags_Borders|ImGuiTableFlags_RowBg|ImGuiTableFlags_SizingStretchProp;
+    if (ImGui::BeginTable("##Jobs", 6, table_flags))
+    {
+        ImGui::TableSetupColumn("Job");
+        ImGui::TableSetupColumn("Count");
+        ImGui::TableSetupColumn("Total (ms)");
+        ImGui::TableSetupColumn("Avg (ms)");
+        ImGui::TableSetupColumn("Max (ms)");
+        ImGui::TableSetupColumn("Avg Queue (ms)");
+        ImGui::TableHeadersRow();
+
+        for (U32 entry_index = 0; entry_index < summary.entry_count; entry_index++)
+        {
+            const Job_Profile_Entry &entry = summary.entries[entry_index];
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", entry.name);
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", entry.count);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", entry.total_ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", entry.total_ms / entry.count);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", entry.max_ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", entry.total_queue_ms / entry.count);
+        }
+
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
+
+} // namespace Job_System_Panel
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <core/defines.h>
+
+namespace Job_System_Panel
+{
+
+void draw();
+
+} // namespace Job_System_Panel
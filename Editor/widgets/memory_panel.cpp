@@ -0,0 +1,143 @@
+#include "memory_panel.h"
+
+#include <core/memory.h>
+#include <containers/string.h>
+
+#include <imgui/imgui.h>
+
+namespace Memory_Panel
+{
+
+struct Memory_Panel_State
+{
+    bool recording = false;
+    char csv_path[256] = "memory_stats.csv";
+};
+
+static Memory_Panel_State memory_panel_state;
+
+static String format_bytes(Allocator allocator, U64 bytes)
+{
+    if (bytes >= HE_MEGA_BYTES(1))
+    {
+        return format_string(allocator, "%.2f MiB", (F64)bytes / (F64)HE_MEGA_BYTES(1));
+    }
+
+    if (bytes >= HE_KILO_BYTES(1))
+    {
+        return format_string(allocator, "%.2f KiB", (F64)bytes / (F64)HE_KILO_BYTES(1));
+    }
+
+    return format_string(allocator, "%llu B", bytes);
+}
+
+void draw()
+{
+    Memory_Panel_State *state = &memory_panel_state;
+
+    ImGui::Begin("Memory");
+
+    ImGui::InputText("CSV Path", state->csv_path, sizeof(state->csv_path));
+    if (ImGui::Button("Dump CSV"))
+    {
+        append_memory_stats_csv(state->csv_path);
+    }
+    ImGui::SameLine();
+    ImGui::Checkbox("Record Every Frame", &state->recording);
+
+    if (state->recording)
+    {
+        append_memory_stats_csv(state->csv_path);
+    }
+
+    Memory_Context memory_context = grab_memory_context();
+    Allocator allocator = memory_context.temp_allocator;
+
+    Memory_Stats stats = {};
+    get_memory_stats(&stats, allocator);
+
+    ImGui::Separator();
+    ImGui::Text("frame: %llu", stats.frame_index);
+    ImGui::Text("general heap: %s used, %s committed, %u allocations, fragmentation %.2f",
+                format_bytes(allocator, stats.general_heap.used_size).data,
+                format_bytes(allocator, stats.general_heap.committed_size).data,
+                stats.general_heap.allocation_count,
+                stats.general_heap.fragmentation);
+    ImGui::Text("thread caches: %u holding %s in spans", stats.thread_cache_count, format_bytes(allocator, stats.thread_cache_span_size).data);
+
+    ImGuiTableFlags table_flags = ImGuiTableFlags_Borders|ImGuiTableFlags_RowBg|ImGuiTableFlags_SizingStretchProp;
+
+#if HE_MEMORY_TAGGING
+    if (ImGui::BeginTable("##Tags", 6, table_flags))
+    {
+        ImGui::TableSetupColumn("Tag");
+        ImGui::TableSetupColumn("Live");
+        ImGui::TableSetupColumn("Peak");
+        ImGui::TableSetupColumn("Allocations");
+        ImGui::TableSetupColumn("Frame Allocations");
+        ImGui::TableSetupColumn("Frame Bytes");
+        ImGui::TableHeadersRow();
+
+        for (U32 tag_index = 0; tag_index < (U32)Memory_Tag::COUNT; tag_index++)
+        {
+            const Memory_Tag_Stats &tag = stats.tags[tag_index];
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", memory_tag_to_string((Memory_Tag)tag_index));
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", format_bytes(allocator, tag.live_bytes).data);
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", format_bytes(allocator, tag.peak_bytes).data);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", tag.allocation_count);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", tag.frame_allocation_count);
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", format_bytes(allocator, tag.frame_allocated_bytes).data);
+        }
+
+        ImGui::EndTable();
+    }
+#endif
+
+    if (ImGui::BeginTable("##Arenas", 5, table_flags))
+    {
+        ImGui::TableSetupColumn("Arena");
+        ImGui::TableSetupColumn("Used");
+        ImGui::TableSetupColumn("High Water Mark");
+        ImGui::TableSetupColumn("Committed");
+        ImGui::TableSetupColumn("Capacity");
+        ImGui::TableHeadersRow();
+
+        for (U32 arena_index = 0; arena_index < stats.arena_count; arena_index++)
+        {
+            const Memory_Arena_Stats &arena = stats.arenas[arena_index];
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            if (arena.thread_id)
+            {
+                ImGui::Text("%s %u", arena.name, arena.thread_id);
+            }
+            else
+            {
+                ImGui::Text("%s", arena.name);
+            }
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", format_bytes(allocator, arena.used).data);
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", format_bytes(allocator, arena.high_water_mark).data);
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", format_bytes(allocator, arena.committed).data);
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", format_bytes(allocator, arena.capacity).data);
+        }
+
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
+
+} // namespace Memory_Panel
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <core/defines.h>
+
+namespace Memory_Panel
+{
+
+void draw();
+
+} // namespace Memory_Panel
@@ -6,6 +6,7 @@
 #include "core/binary_stream.h"
 
 #include "containers/dynamic_array.h"
+#include "containers/hash_map.h"
 #include "containers/string.h"
 
 #include "assets/texture_importer.h"
@@ -15,8 +16,8 @@
 #include "assets/skybox_importer.h"
 #include "assets/scene_importer.h"
 
-#include <ExcaliburHash/ExcaliburHash.h>
-
+#include <algorithm>
+#include <atomic>
 #include <random> // todo(amer): to be removed
 static U64 generate_uuid()
 {
@@ -32,12 +33,46 @@ struct Asset
     Load_Asset_Result load_result;
 };
 
-using Asset_Registry = Excalibur::HashMap< U64, Asset_Registry_Entry >;
-using Asset_Cache = Excalibur::HashMap< U64, Asset >;
-using Embeded_Asset_Cache = Excalibur::HashMap< U64, Dynamic_Array<U64> >;
-using Asset_Dependency = Excalibur::HashMap< U64, Dynamic_Array<U64> >;
+using Asset_Registry = Hash_Map< U64, Asset_Registry_Entry >;
+using Asset_Cache = Hash_Map< U64, Asset >;
+using Embeded_Asset_Cache = Hash_Map< U64, Dynamic_Array<U64> >;
+using Asset_Dependency = Hash_Map< U64, Dynamic_Array<U64> >;
+
+// live assets by path, the keys point at the registry entries paths so an entry has to be removed before its path is freed.
+using Asset_Path_Index = Concurrent_Hash_Map< String, U64 >;
+
+// deleted assets by the hash of their name with extension, import revives one when a file with the same name shows up again.
+using Deleted_Asset_Index = Hash_Map< U64, Dynamic_Array<U64> >;
 
 #define HE_ASSET_REGISTRY_FILE_NAME "asset_registry.haregistry"
+#define HE_ASSET_MAP_INITIAL_CAPACITY 1024
+
+// published copy of each asset's state and load result for the render thread. readers don't lock, a slot is a
+// seqlock written only under the asset mutex and slots are never removed so a uuid keeps its slot.
+struct Asset_State_Slot
+{
+    std::atomic< U64 > uuid;
+    std::atomic< U32 > sequence;
+
+    std::atomic< U16 > type_info_index;
+    std::atomic< Asset_State > state;
+
+    std::atomic< bool > success;
+    std::atomic< void * > data;
+    std::atomic< U64 > size;
+    std::atomic< S32 > index;
+    std::atomic< U32 > generation;
+};
+
+// the table is replaced by one twice the size when half full. readers may still be probing the old one so it's
+// kept on the retired list until shutdown, the retired tables add up to less than the live one.
+struct Asset_State_Table
+{
+    Asset_State_Slot *slots;
+    U32 capacity;
+    U32 count;
+    Asset_State_Table *retired;
+};
 
 struct Load_Asset_Job_Data
 {
@@ -59,7 +94,10 @@ struct Asset_Manager
     Asset_Cache asset_cache;
     Embeded_Asset_Cache embeded_cache;
     Asset_Dependency asset_dependency;
+    Asset_Path_Index path_index;
+    Deleted_Asset_Index deleted_index;
     Dynamic_Array<Asset_Handle> pending_reload_assets;
+    std::atomic< Asset_State_Table * > state_table;
     Mutex asset_mutex;
 };
 
@@ -72,9 +110,13 @@ struct Reload_Asset_Job_Data
 
 Asset_Registry_Entry& internal_get_asset_registry_entry(Asset_Handle asset_handle);
 bool internal_is_asset_handle_valid(Asset_Handle asset_handle);
+void internal_add_deleted_asset(Asset_Handle asset_handle, String path);
+void internal_remove_deleted_asset(Asset_Handle asset_handle, String path);
+void internal_publish_asset_state(Asset_Handle asset_handle, const Asset_Registry_Entry &entry, const Load_Asset_Result &load_result);
 
 static Job_Result reload_asset_job(const Job_Parameters &params)
 {
+    HE_MEMORY_TAG_SCOPE(Memory_Tag::ASSETS);
     const Reload_Asset_Job_Data *job_data = (Reload_Asset_Job_Data *)params.data;
     Asset_Handle asset_handle = job_data->asset_handle;
 
@@ -86,9 +128,9 @@ static Job_Result reload_asset_job(const Job_Parameters &params)
     Asset_Registry_Entry &entry = internal_get_asset_registry_entry(asset_handle);
     
     const Asset_Info *info = get_asset_info(entry.type_info_index);
-    auto cache_it = asset_manager_state->asset_cache.find(asset_handle.uuid);
-    HE_ASSERT(cache_it != asset_manager_state->asset_cache.iend());
-    Asset &asset = cache_it.value();
+    auto cache_it = find(&asset_manager_state->asset_cache, asset_handle.uuid);
+    HE_ASSERT(is_valid(cache_it));
+    Asset &asset = *cache_it.value;
 
     String relative_path = entry.path;
     load_asset_proc load = info->load;
@@ -119,12 +161,14 @@ static Job_Result reload_asset_job(const Job_Parameters &params)
     {
         entry.state = Asset_State::FAILED_TO_LOAD;
         asset.load_result = {};
+        internal_publish_asset_state(asset_handle, entry, asset.load_result);
         HE_LOG(Assets, Error, "load_asset_job -- failed to reload asset: %.*s\n", HE_EXPAND_STRING(entry.path));
         return Job_Result::FAILED;
     }
     
     entry.state = Asset_State::LOADED;
     asset.load_result = load_result;
+    internal_publish_asset_state(asset_handle, entry, asset.load_result);
     HE_LOG(Assets, Trace, "reloaded asset: %.*s\n", HE_EXPAND_STRING(entry.path));
     return Job_Result::SUCCEEDED;
 }
@@ -172,16 +216,16 @@ static void internal_reload_asset(Asset_Handle asset_handle, Job_Handle parent_j
     }
 
     const Asset_Info *info = get_asset_info(entry.type_info_index);
-    auto cache_it = asset_manager_state->asset_cache.find(asset_handle.uuid);
+    auto cache_it = find(&asset_manager_state->asset_cache, asset_handle.uuid);
 
     Asset *asset = nullptr;
 
-    if (cache_it == asset_manager_state->asset_cache.iend())
+    if (!is_valid(cache_it))
     {
-        cache_it = asset_manager_state->asset_cache.emplace(asset_handle.uuid, Asset {}).first;
+        cache_it = insert(&asset_manager_state->asset_cache, asset_handle.uuid, Asset {});
     }
 
-    asset = &cache_it.value();
+    asset = cache_it.value;
 
     if (entry.state == Asset_State::LOADED)
     {
@@ -191,6 +235,7 @@ static void internal_reload_asset(Asset_Handle asset_handle, Job_Handle parent_j
 
     entry.last_write_time = last_write_time;
     entry.state = Asset_State::PENDING;
+    internal_publish_asset_state(asset_handle, entry, asset->load_result);
 
     Reload_Asset_Job_Data data =
     {
@@ -205,16 +250,18 @@ static void internal_reload_asset(Asset_Handle asset_handle, Job_Handle parent_j
             .size = sizeof(Reload_Asset_Job_Data),
             .alignment = alignof(Reload_Asset_Job_Data)
         },
-        .proc = &reload_asset_job
+        .proc = &reload_asset_job,
+        .priority = Job_Priority::BACKGROUND,
+        .name = "reload_asset"
     };
 
     Job_Handle wait_for_jobs[] = { entry.job, parent_job }; 
     entry.job = execute_job(job_data, to_array_view(wait_for_jobs));
 
-    auto dependency_it = asset_manager_state->asset_dependency.find(asset_handle.uuid);
-    if (dependency_it != asset_manager_state->asset_dependency.iend())
+    auto dependency_it = find(&asset_manager_state->asset_dependency, asset_handle.uuid);
+    if (is_valid(dependency_it))
     {
-        Dynamic_Array< U64 > &children = dependency_it.value();
+        Dynamic_Array< U64 > &children = *dependency_it.value;
         for (U32 i = 0; i < children.count; i++)
         {
             Asset_Handle child_asset_handle = { .uuid = children[i] };
@@ -245,6 +292,12 @@ static void on_file_changes(Watch_Directory_Result result, String old_path, Stri
         return;
     }
 
+    // cooked files are written by the importers and aren't assets.
+    if (ext == HE_STRING_LITERAL(HE_STATIC_MESH_FILE_EXTENSION))
+    {
+        return;
+    }
+
     switch (result)
     {
         case FILE_ADDED:
@@ -269,9 +322,11 @@ static void on_file_changes(Watch_Directory_Result result, String old_path, Stri
             Memory_Context memory_context = grab_memory_context();
 
             Asset_Registry_Entry &entry = internal_get_asset_registry_entry(asset_handle);
+            remove(&asset_manager_state->path_index, entry.path);
 
             HE_ALLOCATOR_DEALLOCATE(memory_context.general_allocator, (void *)entry.path.data);
             entry.path = copy_string(new_path, memory_context.general_allocator);
+            insert(&asset_manager_state->path_index, entry.path, asset_handle.uuid);
             HE_LOG(Assets, Trace, "[Rename]: %.*s to %.*s \n", HE_EXPAND_STRING(old_path), HE_EXPAND_STRING(new_path));
             
             serialize_asset_registry();
@@ -299,6 +354,8 @@ static void on_file_changes(Watch_Directory_Result result, String old_path, Stri
             
             Asset_Registry_Entry &entry = internal_get_asset_registry_entry(asset_handle);
             entry.is_deleted = true;
+            remove(&asset_manager_state->path_index, entry.path);
+            internal_add_deleted_asset(asset_handle, entry.path);
 
             serialize_asset_registry();
         } break;
@@ -307,6 +364,8 @@ static void on_file_changes(Watch_Directory_Result result, String old_path, Stri
 
 bool init_asset_manager(String asset_path)
 {
+    HE_MEMORY_TAG_SCOPE(Memory_Tag::ASSETS);
+
     if (asset_manager_state)
     {
         HE_LOG(Assets, Error, "init_asset_manager -- asset manager already initialized");
@@ -323,13 +382,22 @@ bool init_asset_manager(String asset_path)
     asset_manager_state = HE_ALLOCATOR_ALLOCATE(memory_context.permenent_allocator, Asset_Manager);
     asset_manager_state->asset_path = copy_string(asset_path, memory_context.permenent_allocator);
 
-    asset_manager_state->asset_registry = Asset_Registry();
-    asset_manager_state->asset_cache = Asset_Cache();
-    asset_manager_state->embeded_cache = Embeded_Asset_Cache();
-    asset_manager_state->asset_dependency = Asset_Dependency();
+    init(&asset_manager_state->asset_registry, HE_ASSET_MAP_INITIAL_CAPACITY, memory_context.general_allocator);
+    init(&asset_manager_state->asset_cache, HE_ASSET_MAP_INITIAL_CAPACITY, memory_context.general_allocator);
+    init(&asset_manager_state->embeded_cache, HE_ASSET_MAP_INITIAL_CAPACITY, memory_context.general_allocator);
+    init(&asset_manager_state->asset_dependency, HE_ASSET_MAP_INITIAL_CAPACITY, memory_context.general_allocator);
+    init(&asset_manager_state->path_index, HE_ASSET_MAP_INITIAL_CAPACITY, memory_context.general_allocator);
+    init(&asset_manager_state->deleted_index, 0, memory_context.general_allocator);
+    asset_manager_state->state_table.store(nullptr);
 
     platform_create_mutex(&asset_manager_state->asset_mutex);
 
+    if (!init_texture_importer() || !init_model_importer())
+    {
+        HE_LOG(Assets, Error, "init_asset_manager -- failed to init importers\n");
+        return false;
+    }
+
     {
         String extensions[] =
         {
@@ -488,8 +556,8 @@ bool register_asset(String name, Array_View< String > extensions, load_asset_pro
 
 static bool internal_is_asset_handle_valid(Asset_Handle asset_handle)
 {
-    auto it = asset_manager_state->asset_registry.find(asset_handle.uuid);
-    return it != asset_manager_state->asset_registry.iend() && !it.value().is_deleted;
+    auto it = find(&asset_manager_state->asset_registry, asset_handle.uuid);
+    return is_valid(it) && !it.value->is_deleted;
 }
 
 bool is_asset_handle_valid(Asset_Handle asset_handle)
@@ -511,31 +579,167 @@ bool is_asset_of_type(Asset_Handle asset_handle, String type)
     return asset_info->name == type;
 }
 
-static bool internal_is_asset_loaded(Asset_Handle asset_handle)
+static Asset_State_Table *allocate_asset_state_table(U32 capacity)
+{
+    Memory_Context memory_context = grab_memory_context();
+
+    Asset_State_Table *table = HE_ALLOCATOR_ALLOCATE(memory_context.general_allocator, Asset_State_Table);
+    table->slots = HE_ALLOCATOR_ALLOCATE_ARRAY(memory_context.general_allocator, Asset_State_Slot, capacity);
+    table->capacity = capacity;
+    table->count = 0;
+    table->retired = nullptr;
+    return table;
+}
+
+static Asset_State_Slot *find_asset_state_slot(Asset_State_Table *table, U64 uuid)
+{
+    U32 mask = table->capacity - 1;
+
+    for (U32 slot_index = (U32)hash_key(uuid) & mask;; slot_index = (slot_index + 1) & mask)
+    {
+        Asset_State_Slot *slot = &table->slots[slot_index];
+        U64 slot_uuid = slot->uuid.load(std::memory_order_acquire);
+        if (slot_uuid == uuid || slot_uuid == 0)
+        {
+            return slot;
+        }
+    }
+}
+
+static void write_asset_state_slot(Asset_State_Slot *slot, U16 type_info_index, Asset_State state, const Load_Asset_Result &load_result)
+{
+    U32 sequence = slot->sequence.load(std::memory_order_relaxed);
+    slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->type_info_index.store(type_info_index, std::memory_order_relaxed);
+    slot->state.store(state, std::memory_order_relaxed);
+    slot->success.store(load_result.success, std::memory_order_relaxed);
+    slot->data.store(load_result.data, std::memory_order_relaxed);
+    slot->size.store(load_result.size, std::memory_order_relaxed);
+    slot->index.store(load_result.index, std::memory_order_relaxed);
+    slot->generation.store(load_result.generation, std::memory_order_relaxed);
+
+    slot->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+static void grow_asset_state_table()
+{
+    Asset_State_Table *table = asset_manager_state->state_table.load(std::memory_order_relaxed);
+    Asset_State_Table *new_table = allocate_asset_state_table(table ? table->capacity * 2 : HE_ASSET_MAP_INITIAL_CAPACITY * 2);
+
+    if (table)
+    {
+        for (U32 slot_index = 0; slot_index < table->capacity; slot_index++)
+        {
+            Asset_State_Slot *slot = &table->slots[slot_index];
+            U64 uuid = slot->uuid.load(std::memory_order_relaxed);
+            if (!uuid)
+            {
+                continue;
+            }
+
+            Load_Asset_Result load_result =
+            {
+                .success = slot->success.load(std::memory_order_relaxed),
+                .data = slot->data.load(std::memory_order_relaxed),
+                .size = slot->size.load(std::memory_order_relaxed),
+                .index = slot->index.load(std::memory_order_relaxed),
+                .generation = slot->generation.load(std::memory_order_relaxed),
+            };
+
+            Asset_State_Slot *new_slot = find_asset_state_slot(new_table, uuid);
+            write_asset_state_slot(new_slot, slot->type_info_index.load(std::memory_order_relaxed), slot->state.load(std::memory_order_relaxed), load_result);
+            new_slot->uuid.store(uuid, std::memory_order_relaxed);
+        }
+
+        new_table->count = table->count;
+        new_table->retired = table;
+    }
+
+    asset_manager_state->state_table.store(new_table, std::memory_order_release);
+}
+
+// must be called with the asset mutex held, it's the only writer.
+static void internal_publish_asset_state(Asset_Handle asset_handle, const Asset_Registry_Entry &entry, const Load_Asset_Result &load_result)
 {
-    auto it = asset_manager_state->asset_cache.find(asset_handle.uuid);
-    return it != asset_manager_state->asset_cache.iend() && it.value().load_result.success;
+    Asset_State_Table *table = asset_manager_state->state_table.load(std::memory_order_relaxed);
+    if (!table || (table->count + 1) * 2 > table->capacity)
+    {
+        grow_asset_state_table();
+        table = asset_manager_state->state_table.load(std::memory_order_relaxed);
+    }
+
+    Asset_State_Slot *slot = find_asset_state_slot(table, asset_handle.uuid);
+    write_asset_state_slot(slot, entry.type_info_index, entry.state, load_result);
+
+    if (slot->uuid.load(std::memory_order_relaxed) == 0)
+    {
+        table->count++;
+        slot->uuid.store(asset_handle.uuid, std::memory_order_release);
+    }
+}
+
+// lock-free, returns false for assets that were never published.
+static bool read_asset_state(Asset_Handle asset_handle, U16 *out_type_info_index, Asset_State *out_state, Load_Asset_Result *out_load_result)
+{
+    Asset_State_Table *table = asset_manager_state->state_table.load(std::memory_order_acquire);
+    if (!table || asset_handle.uuid == 0)
+    {
+        return false;
+    }
+
+    Asset_State_Slot *slot = find_asset_state_slot(table, asset_handle.uuid);
+    if (slot->uuid.load(std::memory_order_relaxed) == 0)
+    {
+        return false;
+    }
+
+    while (true)
+    {
+        U32 sequence = slot->sequence.load(std::memory_order_acquire);
+        if (sequence & 1)
+        {
+            continue;
+        }
+
+        *out_type_info_index = slot->type_info_index.load(std::memory_order_relaxed);
+        *out_state = slot->state.load(std::memory_order_relaxed);
+        out_load_result->success = slot->success.load(std::memory_order_relaxed);
+        out_load_result->data = slot->data.load(std::memory_order_relaxed);
+        out_load_result->size = slot->size.load(std::memory_order_relaxed);
+        out_load_result->index = slot->index.load(std::memory_order_relaxed);
+        out_load_result->generation = slot->generation.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->sequence.load(std::memory_order_relaxed) == sequence)
+        {
+            return true;
+        }
+    }
 }
 
 bool is_asset_loaded(Asset_Handle asset_handle)
 {
-    platform_lock_mutex(&asset_manager_state->asset_mutex);
-    HE_DEFER{ platform_unlock_mutex(&asset_manager_state->asset_mutex); };
-    return internal_is_asset_loaded(asset_handle);
+    U16 type_info_index;
+    Asset_State state;
+    Load_Asset_Result load_result;
+    return read_asset_state(asset_handle, &type_info_index, &state, &load_result) && load_result.success;
 }
 
 static Job_Handle internal_acquire_asset(Asset_Handle asset_handle)
 {
     Asset_Registry &asset_registry = asset_manager_state->asset_registry;
 
-    auto entry_it = asset_registry.find(asset_handle.uuid);
-    HE_ASSERT(entry_it != asset_registry.iend());
-    Asset_Registry_Entry &entry = entry_it.value();
+    auto entry_it = find(&asset_registry, asset_handle.uuid);
+    HE_ASSERT(is_valid(entry_it));
+    Asset_Registry_Entry &entry = *entry_it.value;
     entry.ref_count++;
 
     if (entry.state == Asset_State::UNLOADED)
     {
         entry.state = Asset_State::PENDING;
+        internal_publish_asset_state(asset_handle, entry, {});
 
         Job_Handle parent_job = Resource_Pool< Job >::invalid_handle;
         if (internal_is_asset_handle_valid(entry.parent))
@@ -559,7 +763,9 @@ static Job_Handle internal_acquire_asset(Asset_Handle asset_handle)
                 .size = sizeof(Load_Asset_Job_Data),
                 .alignment = alignof(Load_Asset_Job_Data)
             },
-            .proc = &load_asset_job
+            .proc = &load_asset_job,
+            .priority = Job_Priority::BACKGROUND,
+            .name = "load_asset"
         };
 
         entry.job = execute_job(data, { .count = 1, .data = &parent_job });
@@ -577,14 +783,12 @@ Job_Handle acquire_asset(Asset_Handle asset_handle)
 
 Load_Asset_Result get_asset(Asset_Handle asset_handle)
 {
-    platform_lock_mutex(&asset_manager_state->asset_mutex);
-    HE_DEFER { platform_unlock_mutex(&asset_manager_state->asset_mutex); };
-
-    Asset_Cache &asset_cache = asset_manager_state->asset_cache;
-    auto it = asset_cache.find(asset_handle.uuid);
-    HE_ASSERT(it != asset_cache.iend());
-    Asset* asset = &it.value();
-    return asset->load_result;
+    U16 type_info_index;
+    Asset_State state;
+    Load_Asset_Result load_result = {};
+    bool published = read_asset_state(asset_handle, &type_info_index, &state, &load_result);
+    HE_ASSERT(published);
+    return load_result;
 }
 
 void release_asset(Asset_Handle asset_handle)
@@ -594,13 +798,13 @@ void release_asset(Asset_Handle asset_handle)
 
     Asset_Registry &asset_registry = asset_manager_state->asset_registry;
 
-    auto entry_it = asset_registry.find(asset_handle.uuid);
-    if (entry_it == asset_registry.iend())
+    auto entry_it = find(&asset_registry, asset_handle.uuid);
+    if (!is_valid(entry_it))
     {
         return;
     }
 
-    Asset_Registry_Entry &entry = entry_it.value();
+    Asset_Registry_Entry &entry = *entry_it.value;
 
     
     HE_ASSERT(entry.ref_count);
@@ -612,53 +816,104 @@ void release_asset(Asset_Handle asset_handle)
         HE_ASSERT(info.unload);
 
         Asset_Cache &asset_cache = asset_manager_state->asset_cache;
-        auto it = asset_cache.find(asset_handle.uuid);
-        if (it != asset_cache.iend())
+        auto it = find(&asset_cache, asset_handle.uuid);
+        if (is_valid(it))
         {
-            Asset *asset = &it.value();
+            Asset *asset = it.value;
             info.unload(asset->load_result);
-            asset_cache.erase(it);
+            remove(&asset_cache, asset_handle.uuid);
         }
         entry.state = Asset_State::UNLOADED;
+        internal_publish_asset_state(asset_handle, entry, {});
         HE_LOG(Assets, Trace, "unloaded asset: %.*s\n", HE_EXPAND_STRING(entry.path));
     }
 }
 
-static Asset_Handle internal_get_asset_handle(String path)
+// doesn't take the asset mutex, the path index has its own read write lock.
+Asset_Handle get_asset_handle(String path)
 {
-    for (auto it = asset_manager_state->asset_registry.ibegin(); it != asset_manager_state->asset_registry.iend(); it++)
+    Asset_Handle asset_handle = { .uuid = 0 };
+    find(&asset_manager_state->path_index, path, &asset_handle.uuid);
+    return asset_handle;
+}
+
+static void internal_add_deleted_asset(Asset_Handle asset_handle, String path)
+{
+    Deleted_Asset_Index &deleted_index = asset_manager_state->deleted_index;
+    U64 name_hash = hash_key(get_name_with_extension(path));
+
+    auto it = find(&deleted_index, name_hash);
+    if (!is_valid(it))
     {
-        const Asset_Registry_Entry &entry = it.value();
-        if (entry.path == path && !entry.is_deleted)
-        {
-            return { .uuid = it.key() };
-        }
+        Dynamic_Array<U64> deleted = {};
+        append(&deleted, asset_handle.uuid);
+        insert(&deleted_index, name_hash, deleted);
     }
+    else if (find(it.value, asset_handle.uuid) == -1)
+    {
+        append(it.value, asset_handle.uuid);
+    }
+}
 
-    return { .uuid = 0 };
+static void internal_remove_deleted_asset(Asset_Handle asset_handle, String path)
+{
+    Deleted_Asset_Index &deleted_index = asset_manager_state->deleted_index;
+    U64 name_hash = hash_key(get_name_with_extension(path));
+
+    auto it = find(&deleted_index, name_hash);
+    if (!is_valid(it))
+    {
+        return;
+    }
+
+    S32 index = find(it.value, asset_handle.uuid);
+    if (index != -1)
+    {
+        remove_and_swap_back(it.value, index);
+    }
+
+    if (it.value->count == 0)
+    {
+        deinit(it.value);
+        remove(&deleted_index, name_hash);
+    }
 }
 
-Asset_Handle get_asset_handle(String path)
+static Asset_Handle internal_find_deleted_asset(String name_with_extension)
 {
-    platform_lock_mutex(&asset_manager_state->asset_mutex);
-    HE_DEFER { platform_unlock_mutex(&asset_manager_state->asset_mutex); };
-    return internal_get_asset_handle(path);
+    auto it = find(&asset_manager_state->deleted_index, hash_key(name_with_extension));
+    if (!is_valid(it))
+    {
+        return { .uuid = 0 };
+    }
+
+    // names that only share the hash are filtered here.
+    for (U64 uuid : *it.value)
+    {
+        const Asset_Registry_Entry &entry = internal_get_asset_registry_entry({ .uuid = uuid });
+        if (name_with_extension == get_name_with_extension(entry.path))
+        {
+            return { .uuid = uuid };
+        }
+    }
+
+    return { .uuid = 0 };
 }
 
 static void internal_add_embeded_asset(Asset_Handle embeder_asset_handle, Asset_Handle asset_handle)
 {
     auto &embeded_cache = asset_manager_state->embeded_cache;
     
-    auto it = embeded_cache.find(embeder_asset_handle.uuid);
-    if (it == embeded_cache.iend())
+    auto it = find(&embeded_cache, embeder_asset_handle.uuid);
+    if (!is_valid(it))
     {
         Dynamic_Array<U64> embeded = {};
         append(&embeded, asset_handle.uuid);
-        embeded_cache.emplace(embeder_asset_handle.uuid, embeded);
+        insert(&embeded_cache, embeder_asset_handle.uuid, embeded);
     }
     else
     {
-        Dynamic_Array<U64> &embeded = it.value();
+        Dynamic_Array<U64> &embeded = *it.value;
         if (find(&embeded, asset_handle.uuid) == -1)
         {
             append(&embeded, asset_handle.uuid);
@@ -670,16 +925,16 @@ static void internal_add_asset_dependency(Asset_Handle parent_handle, Asset_Hand
 {
     Asset_Dependency &dependency = asset_manager_state->asset_dependency;
     
-    auto it = dependency.find(parent_handle.uuid);
-    if (it == dependency.iend())
+    auto it = find(&dependency, parent_handle.uuid);
+    if (!is_valid(it))
     {
         Dynamic_Array<U64> children = {};
         append(&children, asset_handle.uuid);
-        dependency.emplace(parent_handle.uuid, children);
+        insert(&dependency, parent_handle.uuid, children);
     }
     else
     {
-        Dynamic_Array<U64> &children = it.value();
+        Dynamic_Array<U64> &children = *it.value;
         if (find(&children, asset_handle.uuid) == -1)
         {
             append(&children, asset_handle.uuid);
@@ -695,39 +950,42 @@ Asset_Handle import_asset(String path)
         return {};
     }
 
-    platform_lock_mutex(&asset_manager_state->asset_mutex);
-    HE_DEFER { platform_unlock_mutex(&asset_manager_state->asset_mutex); };
-
     Memory_Context memory_context = grab_memory_context();
 
     path = copy_string(path, memory_context.temp_allocator);
     sanitize_path(path);
 
+    // already imported assets are found without taking the asset mutex.
+    Asset_Handle imported_asset = get_asset_handle(path);
+    if (imported_asset.uuid)
+    {
+        return imported_asset;
+    }
+
+    platform_lock_mutex(&asset_manager_state->asset_mutex);
+    HE_DEFER { platform_unlock_mutex(&asset_manager_state->asset_mutex); };
+
     auto &registry = asset_manager_state->asset_registry;
 
-    String name_with_extension = get_name_with_extension(path);
+    // another thread may have imported it before we took the lock.
+    imported_asset = get_asset_handle(path);
+    if (imported_asset.uuid)
+    {
+        return imported_asset;
+    }
 
-    for (auto it = asset_manager_state->asset_registry.ibegin(); it != asset_manager_state->asset_registry.iend(); it++)
+    Asset_Handle deleted_asset = internal_find_deleted_asset(get_name_with_extension(path));
+    if (deleted_asset.uuid)
     {
-        Asset_Registry_Entry &entry = it.value();
-        if (name_with_extension == get_name_with_extension(entry.path) && entry.is_deleted)
-        {
-            HE_ALLOCATOR_DEALLOCATE(memory_context.general_allocator, (void *)entry.path.data);
-            entry.path = copy_string(path, memory_context.general_allocator);
-            entry.is_deleted = false;
-            return { .uuid = it.key() };
-        }
-        else if (path == entry.path)
-        {
-            if (entry.is_deleted)
-            {
-                return {};
-            }
-            else
-            {
-                return { .uuid = it.key() };
-            }
-        }
+        Asset_Registry_Entry &entry = internal_get_asset_registry_entry(deleted_asset);
+        internal_remove_deleted_asset(deleted_asset, entry.path);
+
+        HE_ALLOCATOR_DEALLOCATE(memory_context.general_allocator, (void *)entry.path.data);
+        entry.path = copy_string(path, memory_context.general_allocator);
+        entry.is_deleted = false;
+
+        insert(&asset_manager_state->path_index, entry.path, deleted_asset.uuid);
+        return deleted_asset;
     }
 
     Asset_Handle embeder = {};
@@ -775,7 +1033,8 @@ Asset_Handle import_asset(String path)
     };
 
     Asset_Handle asset_handle = { .uuid = generate_uuid() };
-    registry.emplace(asset_handle.uuid, entry);
+    insert(&registry, asset_handle.uuid, entry);
+    insert(&asset_manager_state->path_index, entry.path, asset_handle.uuid);
 
     if (is_embeded && internal_is_asset_handle_valid(embeder))
     {   
@@ -799,16 +1058,16 @@ void set_parent(Asset_Handle asset, Asset_Handle parent)
 
     Asset_Registry &registry = asset_manager_state->asset_registry;
     Asset_Dependency &dependency = asset_manager_state->asset_dependency;
-    auto it = registry.find(asset.uuid);
-    auto parent_it = registry.find(parent.uuid);
-    HE_ASSERT(it != registry.iend());
-    Asset_Registry_Entry &entry = it.value();
+    auto it = find(&registry, asset.uuid);
+    auto parent_it = find(&registry, parent.uuid);
+    HE_ASSERT(is_valid(it));
+    Asset_Registry_Entry &entry = *it.value;
     if (entry.parent.uuid != 0)
     {
-        auto dependency_it = dependency.find(entry.parent.uuid);
-        if (dependency_it != dependency.iend())
+        auto dependency_it = find(&dependency, entry.parent.uuid);
+        if (is_valid(dependency_it))
         {
-            Dynamic_Array< U64 > &children = dependency_it.value();
+            Dynamic_Array< U64 > &children = *dependency_it.value;
             S64 index = find(&children, asset.uuid);
             if (index != -1)
             {
@@ -817,12 +1076,12 @@ void set_parent(Asset_Handle asset, Asset_Handle parent)
         }
     }
 
-    if (parent_it != registry.iend())
+    if (is_valid(parent_it))
     {
         internal_add_asset_dependency(parent, asset);
     }
 
-    if (parent.uuid == 0 || parent_it != registry.iend())
+    if (parent.uuid == 0 || is_valid(parent_it))
     {
         entry.parent = parent;
     }
@@ -859,19 +1118,19 @@ bool is_asset_embeded(Asset_Handle asset_handle)
 
 Array_View< U64 > get_embeded_assets(Asset_Handle asset_handle)
 {
-    auto it = asset_manager_state->embeded_cache.find(asset_handle.uuid);
-    if (it == asset_manager_state->embeded_cache.iend())
+    auto it = find(&asset_manager_state->embeded_cache, asset_handle.uuid);
+    if (!is_valid(it))
     {
         return {};
     }
-    return to_array_view(it.value());
+    return to_array_view(*it.value);
 }
 
 static Asset_Registry_Entry& internal_get_asset_registry_entry(Asset_Handle asset_handle)
 {
-    auto it = asset_manager_state->asset_registry.find(asset_handle.uuid);
-    HE_ASSERT(it != asset_manager_state->asset_registry.iend());
-    return it.value();
+    auto it = find(&asset_manager_state->asset_registry, asset_handle.uuid);
+    HE_ASSERT(is_valid(it));
+    return *it.value;
 }
 
 const Asset_Registry_Entry& get_asset_registry_entry(Asset_Handle asset_handle)
@@ -883,6 +1142,14 @@ const Asset_Registry_Entry& get_asset_registry_entry(Asset_Handle asset_handle)
 
 const Asset_Info* get_asset_info(Asset_Handle asset_handle)
 {
+    U16 type_info_index;
+    Asset_State state;
+    Load_Asset_Result load_result;
+    if (read_asset_state(asset_handle, &type_info_index, &state, &load_result))
+    {
+        return &asset_manager_state->asset_infos[type_info_index];
+    }
+
     platform_lock_mutex(&asset_manager_state->asset_mutex);
     HE_DEFER { platform_unlock_mutex(&asset_manager_state->asset_mutex); };
 
@@ -912,9 +1179,9 @@ const Asset_Info *get_asset_info(U16 type_info_index)
 
 Load_Asset_Result *get_asset_load_result(Asset_Handle asset)
 {
-    auto it = asset_manager_state->asset_cache.find(asset.uuid);
-    HE_ASSERT(it != asset_manager_state->asset_cache.iend());
-    return &it.value().load_result;
+    auto it = find(&asset_manager_state->asset_cache, asset.uuid);
+    HE_ASSERT(is_valid(it));
+    return &it.value->load_result;
 }
 
 //
@@ -940,6 +1207,7 @@ const Asset_Info *get_asset_info_from_extension(String extension)
 
 static Job_Result load_asset_job(const Job_Parameters &params)
 {
+    HE_MEMORY_TAG_SCOPE(Memory_Tag::ASSETS);
     Load_Asset_Job_Data *job_data = (Load_Asset_Job_Data *)params.data;
 
     Memory_Context memory_context = grab_memory_context();
@@ -980,12 +1248,14 @@ static Job_Result load_asset_job(const Job_Parameters &params)
     if (!load_result.success)
     {
         entry.state = Asset_State::FAILED_TO_LOAD;
+        internal_publish_asset_state(job_data->asset_handle, entry, {});
         HE_LOG(Assets, Error, "load_asset_job -- failed to load asset: %.*s\n", HE_EXPAND_STRING(asset_entry.path));
         return Job_Result::FAILED;
     }
     
     entry.state = Asset_State::LOADED;
-    asset_manager_state->asset_cache.emplace(job_data->asset_handle.uuid, Asset { .load_result = load_result });
+    insert(&asset_manager_state->asset_cache, job_data->asset_handle.uuid, Asset { .load_result = load_result });
+    internal_publish_asset_state(job_data->asset_handle, entry, load_result);
     
     HE_LOG(Assets, Trace, "loaded asset: %.*s\n", HE_EXPAND_STRING(asset_entry.path));
     return Job_Result::SUCCEEDED;
@@ -1002,16 +1272,16 @@ static bool serialize_asset_registry()
     Asset_Registry &registry = asset_manager_state->asset_registry;
     Asset_Dependency &dependency = asset_manager_state->asset_dependency;
 
-    Asset_Handle *handles = HE_ALLOCATOR_ALLOCATE_ARRAY(memory_context.temp_allocator, Asset_Handle, registry.size());
+    Asset_Handle *handles = HE_ALLOCATOR_ALLOCATE_ARRAY(memory_context.temp_allocator, Asset_Handle, registry.count);
     
     {
         U32 handle_index = 0;
-        for (auto it = registry.ibegin(); it != registry.iend(); ++it)
+        for (auto it = iterator(&registry); next(&registry, it);)
         {
-            handles[handle_index++] = { .uuid = it.key() };
+            handles[handle_index++] = { .uuid = *it.key };
         }
 
-        std::sort(handles, handles + registry.size(), [&dependency](Asset_Handle a, Asset_Handle b)
+        std::sort(handles, handles + registry.count, [&dependency](Asset_Handle a, Asset_Handle b)
         {
             U32 a_count = 0;
             U32 b_count = 0;
@@ -1053,11 +1323,11 @@ static bool serialize_asset_registry()
     begin_string_builder(&builder, memory_context.temprary_memory.arena);
     
     append(&builder, "version 1\n");
-    append(&builder, "entry_count %u\n", registry.size());
+    append(&builder, "entry_count %u\n", registry.count);
 
-    for (U32 i = 0; i < registry.size(); i++)
+    for (U32 i = 0; i < registry.count; i++)
     {
-        const Asset_Registry_Entry &entry = registry[handles[i].uuid];
+        const Asset_Registry_Entry &entry = internal_get_asset_registry_entry(handles[i]);
         append(&builder, "\nasset %llu\n", handles[i].uuid);
         append(&builder, "parent %llu\n", entry.parent.uuid);
         append(&builder, "path %llu %.*s\n", entry.path.count, HE_EXPAND_STRING(entry.path));
@@ -1174,7 +1444,16 @@ static bool deserialize_asset_registry()
         String absolute_path = internal_get_asset_absolute_path(entry, memory_context.temp_allocator);
         entry.is_deleted = !file_exists(absolute_path);
 
-        registry.emplace(asset_uuid, entry);
+        insert(&registry, asset_uuid, entry);
+
+        if (entry.is_deleted)
+        {
+            internal_add_deleted_asset(asset_handle, entry.path);
+        }
+        else
+        {
+            insert(&asset_manager_state->path_index, entry.path, asset_uuid);
+        }
         
         Asset_Handle embeder_handle = {};
         bool is_embeded = is_asset_embeded(path, &embeder_handle);
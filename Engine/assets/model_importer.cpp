@@ -4,12 +4,13 @@
 #include "core/logging.h"
 #include "core/memory.h"
 #include "core/platform.h"
+#include "core/pool_allocator.h"
 #include "assets/asset_manager.h"
 
 #include "rendering/renderer.h"
 #include "rendering/renderer_utils.h" 
 
-#include <ExcaliburHash/ExcaliburHash.h>
+#include "containers/hash_map.h"
 
 struct Model_Instance
 {
@@ -17,7 +18,52 @@ struct Model_Instance
     U32 ref_count;
 };
 
-using Model_Cache = Excalibur::HashMap< U64,  Model_Instance>;
+using Model_Cache = Hash_Map< U64, Model_Instance >;
+
+// cooked static mesh: header | sub meshes | material paths | indices | positions | normals | uvs | tangents
+#define HE_STATIC_MESH_FILE_MAGIC 0x534D4148 // HAMS
+#define HE_STATIC_MESH_FILE_VERSION 1
+#define HE_STATIC_MESH_FILE_STREAM_ALIGNMENT 16
+
+struct Static_Mesh_File_Header
+{
+    U32 magic;
+    U32 version;
+    U64 source_last_write_time; // the mesh is cooked again when the model changes.
+
+    U32 sub_mesh_count;
+    U32 vertex_count;
+    U32 index_count;
+    U32 material_paths_size;
+
+    glm::vec3 min;
+    glm::vec3 max;
+
+    U64 sub_meshes_offset;
+    U64 material_paths_offset;
+
+    U64 data_offset;
+    U64 data_size;
+
+    // relative to data_offset.
+    U64 indices_offset;
+    U64 positions_offset;
+    U64 normals_offset;
+    U64 uvs_offset;
+    U64 tangents_offset;
+};
+
+struct Static_Mesh_File_Sub_Mesh
+{
+    U32 vertex_count;
+    U32 index_count;
+    U32 vertex_offset;
+    U32 index_offset;
+
+    // into the material paths, a count of zero means the sub mesh has no material.
+    U32 material_path_offset;
+    U32 material_path_count;
+};
 
 #pragma warning(push, 0)
 
@@ -29,14 +75,30 @@ using Model_Cache = Excalibur::HashMap< U64,  Model_Instance>;
 static Model_Cache model_cache;
 static Mutex model_cache_mutex;
 
+static Pool_Allocator< Model > model_pool;
+
+bool init_model_importer()
+{
+    bool mutex_created = platform_create_mutex(&model_cache_mutex);
+    if (!mutex_created)
+    {
+        return false;
+    }
+
+    Memory_Context memory_context = grab_memory_context();
+    init(&model_cache, 64, memory_context.general_allocator);
+    init(&model_pool, 16, memory_context.general_allocator);
+    return true;
+}
+
 static void* cgltf_alloc(void *user, cgltf_size size)
 {
-    return allocate((Free_List_Allocator *)user, size, 16);
+    return allocate((Thread_Cached_Allocator *)user, size, 16);
 }
 
 static void cgltf_free(void *user, void *ptr)
 {
-    deallocate((Free_List_Allocator *)user, ptr);
+    deallocate((Thread_Cached_Allocator *)user, ptr);
 }
 
 static Asset_Handle get_texture_asset_handle(String model_relative_path, const cgltf_image *image)
@@ -111,8 +173,8 @@ static cgltf_data *aquire_model_from_cache(U64 asset_uuid, String path)
 
     cgltf_data *result = nullptr;
 
-    auto it = model_cache.find(asset_uuid);
-    if (it == model_cache.iend())
+    auto it = find(&model_cache, asset_uuid);
+    if (!is_valid(it))
     {
         Read_Entire_File_Result file_result = read_entire_file(path, memory_context.temp_allocator);
 
@@ -133,11 +195,11 @@ static cgltf_data *aquire_model_from_cache(U64 asset_uuid, String path)
             return {};
         }
 
-        model_cache.emplace(asset_uuid, Model_Instance { .data = (void *)result, .ref_count = 1 });
+        insert(&model_cache, asset_uuid, Model_Instance { .data = (void *)result, .ref_count = 1 });
     }
     else
     {
-        Model_Instance &instance = it.value();
+        Model_Instance &instance = *it.value;
         result = (cgltf_data *)instance.data;
         instance.ref_count++;
     }
@@ -149,21 +211,407 @@ static void release_model_from_cache(U64 asset_uuid)
 {
     platform_lock_mutex(&model_cache_mutex);
 
-    auto it = model_cache.find(asset_uuid);
-    HE_ASSERT(it != model_cache.iend());
-    Model_Instance &instance = it.value();
+    auto it = find(&model_cache, asset_uuid);
+    HE_ASSERT(is_valid(it));
+    Model_Instance &instance = *it.value;
     HE_ASSERT(instance.ref_count);
     instance.ref_count--;
 
     if (instance.ref_count == 0)
     {
         cgltf_free((cgltf_data *)instance.data);
-        model_cache.erase(it);
+        remove(&model_cache, asset_uuid);
     }
 
     platform_unlock_mutex(&model_cache_mutex);
 }
 
+HE_FORCE_INLINE static U64 align_up(U64 value, U64 alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static String get_cooked_static_mesh_path(String model_path, U32 static_mesh_index, Allocator allocator)
+{
+    return format_string(allocator, "%.*s.%u.%s", HE_EXPAND_STRING(model_path), static_mesh_index, HE_STATIC_MESH_FILE_EXTENSION);
+}
+
+static void copy_attribute(U8 *dst, const cgltf_attribute *attribute)
+{
+    const cgltf_accessor *accessor = attribute->data;
+    const cgltf_buffer_view *view = accessor->buffer_view;
+    U8 *data = (U8 *)view->buffer->data + view->offset + accessor->offset;
+    copy_memory(dst, data, accessor->stride * accessor->count);
+}
+
+static bool cook_static_mesh(cgltf_data *model_data, U32 static_mesh_index, Asset_Handle asset_handle, String cooked_path, U64 source_last_write_time)
+{
+    Memory_Context memory_context = grab_memory_context();
+
+    cgltf_mesh *static_mesh = &model_data->meshes[static_mesh_index];
+    U32 sub_mesh_count = u64_to_u32(static_mesh->primitives_count);
+
+    Static_Mesh_File_Sub_Mesh *sub_meshes = HE_ALLOCATOR_ALLOCATE_ARRAY(memory_context.temp_allocator, Static_Mesh_File_Sub_Mesh, sub_mesh_count);
+    String *material_paths = HE_ALLOCATOR_ALLOCATE_ARRAY(memory_context.temp_allocator, String, sub_mesh_count);
+
+    U64 total_vertex_count = 0;
+    U64 total_index_count = 0;
+    U64 material_paths_size = 0;
+
+    for (U32 sub_mesh_index = 0; sub_mesh_index < sub_mesh_count; sub_mesh_index++)
+    {
+        cgltf_primitive *primitive = &static_mesh->primitives[sub_mesh_index];
+        HE_ASSERT(primitive->type == cgltf_primitive_type_triangles);
+
+        HE_ASSERT(primitive->indices->type == cgltf_type_scalar);
+        HE_ASSERT(primitive->indices->component_type == cgltf_component_type_r_16u || primitive->indices->component_type == cgltf_component_type_r_8u);
+        HE_ASSERT(primitive->indices->stride == sizeof(U16) || primitive->indices->stride == sizeof(U8));
+
+        Static_Mesh_File_Sub_Mesh &sub_mesh = sub_meshes[sub_mesh_index];
+        sub_mesh.vertex_offset = u64_to_u32(total_vertex_count);
+        sub_mesh.index_offset = u64_to_u32(total_index_count);
+
+        total_index_count += primitive->indices->count;
+        sub_mesh.index_count = u64_to_u32(primitive->indices->count);
+
+        if (primitive->material)
+        {
+            material_paths[sub_mesh_index] = get_embedded_asset_path(model_data, primitive->material, asset_handle, memory_context.temp_allocator);
+            sub_mesh.material_path_offset = u64_to_u32(material_paths_size);
+            sub_mesh.material_path_count = u64_to_u32(material_paths[sub_mesh_index].count);
+            material_paths_size += material_paths[sub_mesh_index].count;
+        }
+
+        for (U32 attribute_index = 0; attribute_index < primitive->attributes_count; attribute_index++)
+        {
+            cgltf_attribute *attribute = &primitive->attributes[attribute_index];
+            switch (attribute->type)
+            {
+                case cgltf_attribute_type_position:
+                {
+                    HE_ASSERT(attribute->data->type == cgltf_type_vec3);
+                    HE_ASSERT(attribute->data->component_type == cgltf_component_type_r_32f);
+                    HE_ASSERT(attribute->data->stride == sizeof(glm::vec3));
+                    total_vertex_count += attribute->data->count;
+                    sub_mesh.vertex_count = u64_to_u32(attribute->data->count);
+                } break;
+
+                case cgltf_attribute_type_normal:
+                {
+                    HE_ASSERT(attribute->data->type == cgltf_type_vec3);
+                    HE_ASSERT(attribute->data->component_type == cgltf_component_type_r_32f);
+                    HE_ASSERT(attribute->data->stride == sizeof(glm::vec3));
+                } break;
+
+                case cgltf_attribute_type_texcoord:
+                {
+                    HE_ASSERT(attribute->data->type == cgltf_type_vec2);
+                    HE_ASSERT(attribute->data->component_type == cgltf_component_type_r_32f);
+                    HE_ASSERT(attribute->data->stride == sizeof(glm::vec2));
+                } break;
+
+                case cgltf_attribute_type_tangent:
+                {
+                    HE_ASSERT(attribute->data->type == cgltf_type_vec4);
+                    HE_ASSERT(attribute->data->component_type == cgltf_component_type_r_32f);
+                    HE_ASSERT(attribute->data->stride == sizeof(glm::vec4));
+                } break;
+            }
+        }
+    }
+
+    Static_Mesh_File_Header header =
+    {
+        .magic = HE_STATIC_MESH_FILE_MAGIC,
+        .version = HE_STATIC_MESH_FILE_VERSION,
+        .source_last_write_time = source_last_write_time,
+        .sub_mesh_count = sub_mesh_count,
+        .vertex_count = u64_to_u32(total_vertex_count),
+        .index_count = u64_to_u32(total_index_count),
+        .material_paths_size = u64_to_u32(material_paths_size),
+        .min = glm::vec3(HE_MAX_F32),
+        .max = glm::vec3(-HE_MAX_F32),
+    };
+
+    header.sub_meshes_offset = sizeof(Static_Mesh_File_Header);
+    header.material_paths_offset = header.sub_meshes_offset + sizeof(Static_Mesh_File_Sub_Mesh) * sub_mesh_count;
+    header.data_offset = align_up(header.material_paths_offset + material_paths_size, HE_STATIC_MESH_FILE_STREAM_ALIGNMENT);
+
+    header.indices_offset = 0;
+    header.positions_offset = align_up(header.indices_offset + sizeof(U16) * total_index_count, HE_STATIC_MESH_FILE_STREAM_ALIGNMENT);
+    header.normals_offset = align_up(header.positions_offset + sizeof(glm::vec3) * total_vertex_count, HE_STATIC_MESH_FILE_STREAM_ALIGNMENT);
+    header.uvs_offset = align_up(header.normals_offset + sizeof(glm::vec3) * total_vertex_count, HE_STATIC_MESH_FILE_STREAM_ALIGNMENT);
+    header.tangents_offset = align_up(header.uvs_offset + sizeof(glm::vec2) * total_vertex_count, HE_STATIC_MESH_FILE_STREAM_ALIGNMENT);
+    header.data_size = header.tangents_offset + sizeof(glm::vec4) * total_vertex_count;
+
+    U64 file_size = header.data_offset + header.data_size;
+    U8 *file_data = HE_ALLOCATOR_ALLOCATE_ARRAY(memory_context.general_allocator, U8, file_size);
+    HE_DEFER { HE_ALLOCATOR_DEALLOCATE(memory_context.general_allocator, file_data); };
+
+    copy_memory(file_data + header.sub_meshes_offset, sub_meshes, sizeof(Static_Mesh_File_Sub_Mesh) * sub_mesh_count);
+
+    for (U32 sub_mesh_index = 0; sub_mesh_index < sub_mesh_count; sub_mesh_index++)
+    {
+        const String &material_path = material_paths[sub_mesh_index];
+        if (material_path.count)
+        {
+            copy_memory(file_data + header.material_paths_offset + sub_meshes[sub_mesh_index].material_path_offset, material_path.data, material_path.count);
+        }
+    }
+
+    U8 *data = file_data + header.data_offset;
+    U16 *indices = (U16 *)(data + header.indices_offset);
+    glm::vec3 *positions = (glm::vec3 *)(data + header.positions_offset);
+    glm::vec3 *normals = (glm::vec3 *)(data + header.normals_offset);
+    glm::vec2 *uvs = (glm::vec2 *)(data + header.uvs_offset);
+    glm::vec4 *tangents = (glm::vec4 *)(data + header.tangents_offset);
+
+    for (U32 sub_mesh_index = 0; sub_mesh_index < sub_mesh_count; sub_mesh_index++)
+    {
+        cgltf_primitive *primitive = &static_mesh->primitives[sub_mesh_index];
+        const Static_Mesh_File_Sub_Mesh &sub_mesh = sub_meshes[sub_mesh_index];
+
+        const cgltf_accessor *accessor = primitive->indices;
+        const cgltf_buffer_view *view = accessor->buffer_view;
+        U8 *index_data = (U8 *)view->buffer->data + view->offset + accessor->offset;
+        U16 *sub_mesh_indices = indices + sub_mesh.index_offset;
+
+        if (accessor->stride == sizeof(U8))
+        {
+            for (U32 i = 0; i < accessor->count; i++)
+            {
+                sub_mesh_indices[i] = index_data[i];
+            }
+        }
+        else
+        {
+            copy_memory(sub_mesh_indices, index_data, accessor->count * sizeof(U16));
+        }
+
+        for (U32 attribute_index = 0; attribute_index < primitive->attributes_count; attribute_index++)
+        {
+            cgltf_attribute *attribute = &primitive->attributes[attribute_index];
+            switch (attribute->type)
+            {
+                case cgltf_attribute_type_position:
+                {
+                    copy_attribute((U8 *)(positions + sub_mesh.vertex_offset), attribute);
+                } break;
+
+                case cgltf_attribute_type_normal:
+                {
+                    copy_attribute((U8 *)(normals + sub_mesh.vertex_offset), attribute);
+                } break;
+
+                case cgltf_attribute_type_texcoord:
+                {
+                    copy_attribute((U8 *)(uvs + sub_mesh.vertex_offset), attribute);
+                } break;
+
+                case cgltf_attribute_type_tangent:
+                {
+                    copy_attribute((U8 *)(tangents + sub_mesh.vertex_offset), attribute);
+                } break;
+            }
+        }
+    }
+
+    for (U32 vertex_index = 0; vertex_index < header.vertex_count; vertex_index++)
+    {
+        header.min = glm::min(header.min, positions[vertex_index]);
+        header.max = glm::max(header.max, positions[vertex_index]);
+    }
+
+    copy_memory(file_data, &header, sizeof(Static_Mesh_File_Header));
+
+    bool success = write_entire_file(cooked_path, file_data, file_size);
+    if (!success)
+    {
+        HE_LOG(Resource, Error, "cook_static_mesh -- failed to write cooked static mesh file: %.*s\n", HE_EXPAND_STRING(cooked_path));
+    }
+
+    return success;
+}
+
+// offset and size come from the file so the sum can't be trusted not to overflow.
+static bool is_range_in_file(U64 offset, U64 size, U64 file_size)
+{
+    return offset <= file_size && size <= file_size - offset;
+}
+
+// everything read from the mapping is checked here, a corrupt or foreign file is cooked again.
+static bool is_cooked_static_mesh_valid(const Map_File_Result &map_file_result, U64 source_last_write_time)
+{
+    if (map_file_result.size < sizeof(Static_Mesh_File_Header))
+    {
+        return false;
+    }
+
+    const Static_Mesh_File_Header *header = (const Static_Mesh_File_Header *)map_file_result.data;
+    if (header->magic != HE_STATIC_MESH_FILE_MAGIC ||
+        header->version != HE_STATIC_MESH_FILE_VERSION ||
+        header->source_last_write_time != source_last_write_time)
+    {
+        return false;
+    }
+
+    U64 file_size = map_file_result.size;
+    if (!is_range_in_file(header->data_offset, header->data_size, file_size) ||
+        header->data_offset + header->data_size != file_size ||
+        header->data_offset % HE_STATIC_MESH_FILE_STREAM_ALIGNMENT != 0)
+    {
+        return false;
+    }
+
+    if (header->sub_meshes_offset % alignof(Static_Mesh_File_Sub_Mesh) != 0 ||
+        !is_range_in_file(header->sub_meshes_offset, sizeof(Static_Mesh_File_Sub_Mesh) * (U64)header->sub_mesh_count, file_size) ||
+        !is_range_in_file(header->material_paths_offset, header->material_paths_size, file_size))
+    {
+        return false;
+    }
+
+    struct Stream
+    {
+        U64 offset;
+        U64 size;
+    };
+
+    U64 vertex_count = header->vertex_count;
+    Stream streams[] =
+    {
+        { header->indices_offset, sizeof(U16) * (U64)header->index_count },
+        { header->positions_offset, sizeof(glm::vec3) * vertex_count },
+        { header->normals_offset, sizeof(glm::vec3) * vertex_count },
+        { header->uvs_offset, sizeof(glm::vec2) * vertex_count },
+        { header->tangents_offset, sizeof(glm::vec4) * vertex_count },
+    };
+
+    for (const Stream &stream : streams)
+    {
+        if (stream.offset % HE_STATIC_MESH_FILE_STREAM_ALIGNMENT != 0 || !is_range_in_file(stream.offset, stream.size, header->data_size))
+        {
+            return false;
+        }
+    }
+
+    const Static_Mesh_File_Sub_Mesh *sub_meshes = (const Static_Mesh_File_Sub_Mesh *)(map_file_result.data + header->sub_meshes_offset);
+    for (U32 sub_mesh_index = 0; sub_mesh_index < header->sub_mesh_count; sub_mesh_index++)
+    {
+        const Static_Mesh_File_Sub_Mesh &sub_mesh = sub_meshes[sub_mesh_index];
+        if (sub_mesh.vertex_count > HE_MAX_U16 ||
+            !is_range_in_file(sub_mesh.vertex_offset, sub_mesh.vertex_count, header->vertex_count) ||
+            !is_range_in_file(sub_mesh.index_offset, sub_mesh.index_count, header->index_count) ||
+            !is_range_in_file(sub_mesh.material_path_offset, sub_mesh.material_path_count, header->material_paths_size))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// maps the cooked mesh, cooking it first if it's missing or older than the model.
+// the streams are already laid out for the gpu so they are copied to the transfer buffer as one block.
+static Load_Asset_Result load_cooked_static_mesh(String path, Asset_Handle asset_handle, const Embeded_Asset_Params *params)
+{
+    Memory_Context memory_context = grab_memory_context();
+
+    U32 static_mesh_index = u64_to_u32(params->data_id);
+    String cooked_path = get_cooked_static_mesh_path(path, static_mesh_index, memory_context.temp_allocator);
+    U64 source_last_write_time = platform_get_file_last_write_time(path.data);
+
+    Map_File_Result map_file_result = platform_map_file(cooked_path.data);
+    if (!map_file_result.success || !is_cooked_static_mesh_valid(map_file_result, source_last_write_time))
+    {
+        if (map_file_result.success)
+        {
+            platform_unmap_file(&map_file_result);
+        }
+
+        cgltf_data *model_data = aquire_model_from_cache(asset_handle.uuid, path);
+        if (model_data == nullptr)
+        {
+            return {};
+        }
+
+        bool cooked = cook_static_mesh(model_data, static_mesh_index, asset_handle, cooked_path, source_last_write_time);
+        release_model_from_cache(asset_handle.uuid);
+
+        if (!cooked)
+        {
+            return {};
+        }
+
+        map_file_result = platform_map_file(cooked_path.data);
+        if (!map_file_result.success)
+        {
+            HE_LOG(Resource, Error, "load_cooked_static_mesh -- failed to map cooked static mesh file: %.*s\n", HE_EXPAND_STRING(cooked_path));
+            return {};
+        }
+
+        if (!is_cooked_static_mesh_valid(map_file_result, source_last_write_time))
+        {
+            HE_LOG(Resource, Error, "load_cooked_static_mesh -- cooked static mesh file is invalid after cooking: %.*s\n", HE_EXPAND_STRING(cooked_path));
+            platform_unmap_file(&map_file_result);
+            return {};
+        }
+    }
+
+    HE_DEFER { platform_unmap_file(&map_file_result); };
+
+    const Static_Mesh_File_Header *header = (const Static_Mesh_File_Header *)map_file_result.data;
+    const Static_Mesh_File_Sub_Mesh *file_sub_meshes = (const Static_Mesh_File_Sub_Mesh *)(map_file_result.data + header->sub_meshes_offset);
+    const char *material_paths = (const char *)(map_file_result.data + header->material_paths_offset);
+
+    Dynamic_Array< Sub_Mesh > sub_meshes = {};
+    set_count(&sub_meshes, header->sub_mesh_count);
+
+    for (U32 sub_mesh_index = 0; sub_mesh_index < header->sub_mesh_count; sub_mesh_index++)
+    {
+        const Static_Mesh_File_Sub_Mesh &file_sub_mesh = file_sub_meshes[sub_mesh_index];
+        Sub_Mesh &sub_mesh = sub_meshes[sub_mesh_index];
+
+        sub_mesh.vertex_count = u32_to_u16(file_sub_mesh.vertex_count);
+        sub_mesh.index_count = file_sub_mesh.index_count;
+        sub_mesh.vertex_offset = file_sub_mesh.vertex_offset;
+        sub_mesh.index_offset = file_sub_mesh.index_offset;
+        sub_mesh.material_asset = 0;
+
+        if (file_sub_mesh.material_path_count)
+        {
+            String material_path = { .count = file_sub_mesh.material_path_count, .data = material_paths + file_sub_mesh.material_path_offset };
+            sub_mesh.material_asset = get_asset_handle(material_path).uuid;
+        }
+    }
+
+    Render_Context render_context = get_render_context();
+    Renderer_State *renderer_state = render_context.renderer_state;
+    U8 *static_mesh_data = HE_ALLOCATE_ARRAY_NO_ZERO(&renderer_state->transfer_allocator, U8, header->data_size);
+    copy_memory(static_mesh_data, map_file_result.data + header->data_offset, header->data_size);
+
+    void *data_array[] = { static_mesh_data };
+
+    Static_Mesh_Descriptor static_mesh_descriptor =
+    {
+        .name = copy_string(params->name, memory_context.general_allocator),
+        .data_array = to_array_view(data_array),
+
+        .indices = (U16 *)(static_mesh_data + header->indices_offset),
+        .index_count = header->index_count,
+
+        .vertex_count = header->vertex_count,
+        .positions = (glm::vec3 *)(static_mesh_data + header->positions_offset),
+        .normals = (glm::vec3 *)(static_mesh_data + header->normals_offset),
+        .uvs = (glm::vec2 *)(static_mesh_data + header->uvs_offset),
+        .tangents = (glm::vec4 *)(static_mesh_data + header->tangents_offset),
+
+        .sub_meshes = sub_meshes
+    };
+
+    Static_Mesh_Handle static_mesh_handle = renderer_create_static_mesh(static_mesh_descriptor);
+    return { .success = true, .index = static_mesh_handle.index, .generation = static_mesh_handle.generation };
+}
+
 void on_import_model(Asset_Handle asset_handle)
 {
     Memory_Context memory_context = grab_memory_context();
@@ -179,6 +627,7 @@ void on_import_model(Asset_Handle asset_handle)
        release_model_from_cache(asset_handle.uuid);
     };
 
+    U64 source_last_write_time = platform_get_file_last_write_time(path.data);
     Asset_Handle opaque_pbr_shader_asset = import_asset(HE_STRING_LITERAL("opaque_pbr.glsl"));
 
     for (U32 material_index = 0; material_index < model_data->materials_count; material_index++)
@@ -193,7 +642,12 @@ void on_import_model(Asset_Handle asset_handle)
     {
         cgltf_mesh *static_mesh = &model_data->meshes[static_mesh_index];
         String static_mesh_path = get_embedded_asset_path(model_data, static_mesh, asset_handle, memory_context.temp_allocator);
-        Asset_Handle asset = import_asset(static_mesh_path);
+
+        // cooked before the mesh asset is published, a load job could otherwise find the file missing and cook the same path.
+        String cooked_path = get_cooked_static_mesh_path(path, static_mesh_index, memory_context.temp_allocator);
+        cook_static_mesh(model_data, static_mesh_index, asset_handle, cooked_path, source_last_write_time);
+
+        import_asset(static_mesh_path);
     }
 }
 
@@ -211,7 +665,22 @@ Load_Asset_Result load_model(String path, const Embeded_Asset_Params *params)
     String relative_path = sub_string(path, asset_path.count + 1);
 
     Asset_Handle asset_handle = get_asset_handle(relative_path);
-    
+
+    bool embeded_material = false;
+    bool embeded_static_mesh = false;
+
+    if (params)
+    {
+        const Asset_Info *info = get_asset_info(params->type_info_index);
+        embeded_material = info->name == HE_STRING_LITERAL("material");
+        embeded_static_mesh = info->name == HE_STRING_LITERAL("static_mesh");
+    }
+
+    if (embeded_static_mesh)
+    {
+        return load_cooked_static_mesh(path, asset_handle, params);
+    }
+
     cgltf_data *model_data = aquire_model_from_cache(asset_handle.uuid, path);
     
     if (model_data == nullptr)
@@ -224,16 +693,6 @@ Load_Asset_Result load_model(String path, const Embeded_Asset_Params *params)
        release_model_from_cache(asset_handle.uuid);
     };
 
-    bool embeded_material = false;
-    bool embeded_static_mesh = false;
-
-    if (params)
-    {
-        const Asset_Info *info = get_asset_info(params->type_info_index);
-        embeded_material = info->name == HE_STRING_LITERAL("material");
-        embeded_static_mesh = info->name == HE_STRING_LITERAL("static_mesh");
-    }
-
     if (embeded_material)
     {
         Asset_Handle opaque_pbr_shader_asset = import_asset(HE_STRING_LITERAL("opaque_pbr.glsl"));
@@ -344,204 +803,9 @@ Load_Asset_Result load_model(String path, const Embeded_Asset_Params *params)
         return { .success = true, .index = material_handle.index, .generation = material_handle.generation };
     }
 
-    if (embeded_static_mesh)
-    {
-        U32 static_mesh_index = u64_to_u32(params->data_id);
-        cgltf_mesh *static_mesh = &model_data->meshes[static_mesh_index];
-
-        String static_mesh_path = get_embedded_asset_path(model_data, static_mesh, asset_handle, memory_context.temp_allocator);
-        String static_mesh_name = get_name(static_mesh_path);
-
-        U64 total_vertex_count = 0;
-        U64 total_index_count = 0;
-
-        Dynamic_Array< Sub_Mesh > sub_meshes = {};
-        set_count(&sub_meshes, u64_to_u32(static_mesh->primitives_count));
-        
-        for (U32 sub_mesh_index = 0; sub_mesh_index < (U32)static_mesh->primitives_count; sub_mesh_index++)
-        {
-            cgltf_primitive *primitive = &static_mesh->primitives[sub_mesh_index];
-            HE_ASSERT(primitive->type == cgltf_primitive_type_triangles);
-
-            HE_ASSERT(primitive->indices->type == cgltf_type_scalar);
-            HE_ASSERT(primitive->indices->component_type == cgltf_component_type_r_16u || primitive->indices->component_type == cgltf_component_type_r_8u);
-            HE_ASSERT(primitive->indices->stride == sizeof(U16) || primitive->indices->stride == sizeof(U8));
-
-            sub_meshes[sub_mesh_index].vertex_offset = u64_to_u32(total_vertex_count);
-            sub_meshes[sub_mesh_index].index_offset = u64_to_u32(total_index_count);
-
-            total_index_count += primitive->indices->count;
-            sub_meshes[sub_mesh_index].index_count = u64_to_u32(primitive->indices->count);
-
-            if (primitive->material)
-            {
-                cgltf_material *material = primitive->material;
-                String material_path = get_embedded_asset_path(model_data, material, asset_handle, memory_context.temp_allocator);
-                Asset_Handle material_asset = get_asset_handle(material_path);
-                sub_meshes[sub_mesh_index].material_asset = material_asset.uuid;
-            }
-
-            for (U32 attribute_index = 0; attribute_index < primitive->attributes_count; attribute_index++)
-            {
-                cgltf_attribute *attribute = &primitive->attributes[attribute_index];
-                switch (attribute->type)
-                {
-                    case cgltf_attribute_type_position:
-                    {
-                        HE_ASSERT(attribute->data->type == cgltf_type_vec3);
-                        HE_ASSERT(attribute->data->component_type == cgltf_component_type_r_32f);
-                        U64 stride = attribute->data->stride;
-                        HE_ASSERT(stride == sizeof(glm::vec3));
-                        total_vertex_count += attribute->data->count;
-                        sub_meshes[sub_mesh_index].vertex_count = u64_to_u32(attribute->data->count);
-                    } break;
-
-                    case cgltf_attribute_type_normal:
-                    {
-                        HE_ASSERT(attribute->data->type == cgltf_type_vec3);
-                        HE_ASSERT(attribute->data->component_type == cgltf_component_type_r_32f);
-
-                        U64 stride = attribute->data->stride;
-                        HE_ASSERT(stride == sizeof(glm::vec3));
-                    } break;
-
-                    case cgltf_attribute_type_texcoord:
-                    {
-                        HE_ASSERT(attribute->data->type == cgltf_type_vec2);
-                        HE_ASSERT(attribute->data->component_type == cgltf_component_type_r_32f);
-
-                        U64 stride = attribute->data->stride;
-                        HE_ASSERT(stride == sizeof(glm::vec2));
-                    } break;
-
-                    case cgltf_attribute_type_tangent:
-                    {
-                        HE_ASSERT(attribute->data->type == cgltf_type_vec4);
-                        HE_ASSERT(attribute->data->component_type == cgltf_component_type_r_32f);
-
-                        U64 stride = attribute->data->stride;
-                        HE_ASSERT(stride == sizeof(glm::vec4));
-                    } break;
-                }
-            }
-        }
-
-        U64 index_size = sizeof(U16) * total_index_count;
-        U64 vertex_size = (sizeof(glm::vec3) + sizeof(glm::vec3) + sizeof(glm::vec2) + sizeof(glm::vec4)) * total_vertex_count;
-        U64 total_size = index_size + vertex_size;
-
-        Render_Context render_context = get_render_context();
-        Renderer_State *renderer_state = render_context.renderer_state;
-        U8 *static_mesh_data = HE_ALLOCATE_ARRAY(&renderer_state->transfer_allocator, U8, total_size);
-
-        U16 *indices = (U16 *)static_mesh_data;
-
-        U8 *vertex_data = static_mesh_data + index_size;
-        glm::vec3 *positions = (glm::vec3 *)vertex_data;
-        glm::vec3 *normals = (glm::vec3 *)(vertex_data + sizeof(glm::vec3) * total_vertex_count);
-        glm::vec2 *uvs = (glm::vec2 *)(vertex_data + (sizeof(glm::vec3) + sizeof(glm::vec3)) * total_vertex_count);
-        glm::vec4 *tangents = (glm::vec4 *)(vertex_data + (sizeof(glm::vec3) + sizeof(glm::vec2) + sizeof(glm::vec3)) * total_vertex_count);
-
-        for (U32 sub_mesh_index = 0; sub_mesh_index < (U32)static_mesh->primitives_count; sub_mesh_index++)
-        {
-            cgltf_primitive *primitive = &static_mesh->primitives[sub_mesh_index];
-
-            const auto *accessor = primitive->indices;
-            const auto *view = accessor->buffer_view;
-            U8 *data = (U8 *)view->buffer->data + view->offset + accessor->offset;
-            if (primitive->indices->stride == sizeof(U8))
-            {
-                U16 *ind = indices + sub_meshes[sub_mesh_index].index_offset;
-
-                for (U32 i = 0; i < primitive->indices->count; i++)
-                {
-                    ind[i] = data[i];
-                }
-            }
-            else
-            {
-                copy_memory(indices + sub_meshes[sub_mesh_index].index_offset, data, primitive->indices->count * sizeof(U16));
-            }
-
-            for (U32 attribute_index = 0; attribute_index < primitive->attributes_count; attribute_index++)
-            {
-                cgltf_attribute *attribute = &primitive->attributes[attribute_index];
-                switch (attribute->type)
-                {
-                    case cgltf_attribute_type_position:
-                    {
-                        const auto *accessor = attribute->data;
-                        const auto *view = accessor->buffer_view;
-                        U8 *data_ptr = (U8 *)view->buffer->data;
-                        U64 element_size = attribute->data->stride;
-                        U64 element_count = attribute->data->count;
-                        U8 *data = data_ptr + view->offset + accessor->offset;
-                        copy_memory(positions + sub_meshes[sub_mesh_index].vertex_offset, data, element_size * element_count);
-                    } break;
-
-                    case cgltf_attribute_type_normal:
-                    {
-                        const auto *accessor = attribute->data;
-                        const auto *view = accessor->buffer_view;
-                        U8 *data_ptr = (U8 *)view->buffer->data;
-                        U64 element_size = attribute->data->stride;
-                        U64 element_count = attribute->data->count;
-                        U8 *data = data_ptr + view->offset + accessor->offset;
-                        copy_memory(normals + sub_meshes[sub_mesh_index].vertex_offset, data, element_size * element_count);
-                    } break;
-
-
-                    case cgltf_attribute_type_texcoord:
-                    {
-                        const auto *accessor = attribute->data;
-                        const auto *view = accessor->buffer_view;
-                        U8 *data_ptr = (U8 *)view->buffer->data;
-                        U64 element_size = attribute->data->stride;
-                        U64 element_count = attribute->data->count;
-                        U8 *data = data_ptr + view->offset + accessor->offset;
-                        copy_memory(uvs + sub_meshes[sub_mesh_index].vertex_offset, data, element_size * element_count);
-                    } break;
-
-                    case cgltf_attribute_type_tangent:
-                    {
-                        const auto *accessor = attribute->data;
-                        const auto *view = accessor->buffer_view;
-                        U8 *data_ptr = (U8 *)view->buffer->data;
-                        U64 element_size = attribute->data->stride;
-                        U64 element_count = attribute->data->count;
-                        U8 *data = data_ptr + view->offset + accessor->offset;
-                        copy_memory(tangents + sub_meshes[sub_mesh_index].vertex_offset, data, element_size * element_count);
-                    } break;
-                }
-            }
-        }
-
-        void *data_array[] = { static_mesh_data };
-
-        Static_Mesh_Descriptor static_mesh_descriptor =
-        {
-            .name = copy_string(static_mesh_name, memory_context.general_allocator),
-            .data_array = to_array_view(data_array),
-
-            .indices = indices,
-            .index_count = u64_to_u32(total_index_count),
-
-            .vertex_count = u64_to_u32(total_vertex_count),
-            .positions = positions,
-            .normals = normals,
-            .uvs = uvs,
-            .tangents = tangents,
-
-            .sub_meshes = sub_meshes
-        };
-
-        Static_Mesh_Handle static_mesh_handle = renderer_create_static_mesh(static_mesh_descriptor);
-        return { .success = true, .index = static_mesh_handle.index, .generation = static_mesh_handle.generation };
-    }
-
     cgltf_scene *scene = &model_data->scenes[0];
 
-    Model *model = HE_ALLOCATOR_ALLOCATE(memory_context.general_allocator, Model);
+    Model *model = allocate(&model_pool);
     model->name = copy_string(get_name(path), memory_context.general_allocator);
 
     Scene_Node *nodes = HE_ALLOCATOR_ALLOCATE_ARRAY(memory_context.general_allocator, Scene_Node, scene->nodes_count);
@@ -632,7 +896,7 @@ void unload_model(Load_Asset_Result load_result)
     }
 
     HE_ALLOCATOR_DEALLOCATE(memory_context.general_allocator, (void *)model->nodes);
-    HE_ALLOCATOR_DEALLOCATE(memory_context.general_allocator, model);
+    deallocate(&model_pool, model);
 }
 
 
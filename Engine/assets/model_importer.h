@@ -4,6 +4,11 @@
 #include "containers/string.h"
 #include "assets/asset_manager.h"
 
+// embedded static meshes are cooked next to their model as <model path>.<mesh index>.hamesh
+#define HE_STATIC_MESH_FILE_EXTENSION "hamesh"
+
+bool init_model_importer();
+
 void on_import_model(Asset_Handle asset_handle);
 
 Load_Asset_Result load_model(String path, const Embeded_Asset_Params *params);
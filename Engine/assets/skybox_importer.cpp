@@ -89,7 +89,7 @@ Load_Asset_Result load_skybox(String path, const Embeded_Asset_Params *params)
         texture_width = (U32)width;
         texture_height = (U32)height;
 
-        U32 *data = HE_ALLOCATE_ARRAY(&renderer_state->transfer_allocator, U32, width * height);
+        U32 *data = HE_ALLOCATE_ARRAY_NO_ZERO(&renderer_state->transfer_allocator, U32, width * height);
         copy_memory(data, pixels, width * height * sizeof(U32));
 
         stbi_image_free(pixels);
@@ -2,6 +2,7 @@
 #include "core/memory.h"
 #include "core/file_system.h"
 #include "core/logging.h"
+#include "core/pool_allocator.h"
 
 #include "rendering/renderer.h"
 
@@ -12,6 +13,15 @@
 
 #pragma warning(pop)
 
+static Pool_Allocator< Environment_Map > environment_map_pool;
+
+bool init_texture_importer()
+{
+    Memory_Context memory_context = grab_memory_context();
+    init(&environment_map_pool, 16, memory_context.general_allocator);
+    return true;
+}
+
 Load_Asset_Result load_texture(String path, const Embeded_Asset_Params *params)
 {
     Memory_Context memory_context = grab_memory_context();
@@ -40,7 +50,7 @@ Load_Asset_Result load_texture(String path, const Embeded_Asset_Params *params)
         return {};
     }
 
-    U32 *data = HE_ALLOCATE_ARRAY(&renderer_state->transfer_allocator, U32, width * height);
+    U32 *data = HE_ALLOCATE_ARRAY_NO_ZERO(&renderer_state->transfer_allocator, U32, width * height);
     copy_memory(data, pixels, width * height * sizeof(U32));
     stbi_image_free(pixels);
 
@@ -103,11 +113,11 @@ Load_Asset_Result load_environment_map(String path, const Embeded_Asset_Params *
         return {};
     }
 
-    F32 *data = HE_ALLOCATE_ARRAY(&renderer_state->transfer_allocator, F32, 4 * width * height);
+    F32 *data = HE_ALLOCATE_ARRAY_NO_ZERO(&renderer_state->transfer_allocator, F32, 4 * width * height);
     copy_memory(data, pixels, width * height * 4 * sizeof(F32));
     stbi_image_free(pixels);
 
-    Environment_Map *environment_map = HE_ALLOCATOR_ALLOCATE(memory_context.general_allocator, Environment_Map);
+    Environment_Map *environment_map = allocate(&environment_map_pool);
     *environment_map = renderer_hdr_to_environment_map(data, width, height);
     deallocate(&renderer_state->transfer_allocator, (void *)data);
 
@@ -116,11 +126,9 @@ Load_Asset_Result load_environment_map(String path, const Embeded_Asset_Params *
 
 void unload_environment_map(Load_Asset_Result load_result)
 {
-    Memory_Context memory_context = grab_memory_context();
-
     Environment_Map *environment_map = (Environment_Map *)load_result.data;
     renderer_destroy_texture(environment_map->environment_map);
     renderer_destroy_texture(environment_map->irradiance_map);
 
-    HE_ALLOCATOR_DEALLOCATE(memory_context.general_allocator, (void *)environment_map);
+    deallocate(&environment_map_pool, environment_map);
 }
\ No newline at end of file
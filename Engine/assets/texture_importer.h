@@ -2,6 +2,8 @@
 
 #include "assets/asset_manager.h"
 
+bool init_texture_importer();
+
 Load_Asset_Result load_texture(String path, const Embeded_Asset_Params *params = nullptr);
 void unload_texture(Load_Asset_Result load_result);
 
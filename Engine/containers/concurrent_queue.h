@@ -0,0 +1,154 @@
+#pragma once
+
+#include "core/defines.h"
+#include "core/memory.h"
+
+#include <atomic>
+
+// bounded multi-producer multi-consumer queue: https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+template< typename T >
+struct Concurrent_Queue_Cell
+{
+    std::atomic< U64 > sequence;
+    T data;
+};
+
+template< typename T >
+struct Concurrent_Queue
+{
+    Concurrent_Queue_Cell< T > *cells;
+    U32 capacity;
+    U32 mask;
+    Allocator allocator;
+
+    alignas(64) std::atomic< U64 > write;
+    alignas(64) std::atomic< U64 > read;
+};
+
+template< typename T >
+void init(Concurrent_Queue< T > *queue, U32 capacity, Allocator allocator = {})
+{
+    HE_ASSERT(queue);
+    HE_ASSERT(capacity >= 2);
+
+    if ((capacity & (capacity - 1)) != 0)
+    {
+        U32 new_capacity = 2;
+        capacity--;
+        while (capacity >>= 1)
+        {
+            new_capacity <<= 1;
+        }
+        HE_ASSERT((new_capacity & (new_capacity - 1)) == 0);
+        capacity = new_capacity;
+    }
+
+    if (!allocator.data)
+    {
+        Memory_Context memory_context = grab_memory_context();
+        allocator = memory_context.general_allocator;
+    }
+
+    queue->cells = HE_ALLOCATOR_ALLOCATE_ARRAY(allocator, Concurrent_Queue_Cell< T >, capacity);
+    for (U32 cell_index = 0; cell_index < capacity; cell_index++)
+    {
+        queue->cells[cell_index].sequence.store(cell_index, std::memory_order_relaxed);
+    }
+
+    queue->capacity = capacity;
+    queue->mask = capacity - 1;
+    queue->allocator = allocator;
+    queue->write.store(0, std::memory_order_relaxed);
+    queue->read.store(0, std::memory_order_relaxed);
+}
+
+template< typename T >
+void deinit(Concurrent_Queue< T > *queue)
+{
+    HE_ASSERT(queue);
+    HE_ALLOCATOR_DEALLOCATE(queue->allocator, queue->cells);
+}
+
+template< typename T >
+U32 count(Concurrent_Queue< T > *queue)
+{
+    U64 write = queue->write.load(std::memory_order_relaxed);
+    U64 read = queue->read.load(std::memory_order_relaxed);
+    return write > read ? (U32)(write - read) : 0;
+}
+
+template< typename T >
+bool empty(Concurrent_Queue< T > *queue)
+{
+    return count(queue) == 0;
+}
+
+template< typename T >
+bool push(Concurrent_Queue< T > *queue, const T &item)
+{
+    U64 position = queue->write.load(std::memory_order_relaxed);
+    Concurrent_Queue_Cell< T > *cell = nullptr;
+
+    while (true)
+    {
+        cell = &queue->cells[position & queue->mask];
+        U64 sequence = cell->sequence.load(std::memory_order_acquire);
+        S64 difference = (S64)sequence - (S64)position;
+
+        if (difference == 0)
+        {
+            if (queue->write.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            return false; // full
+        }
+        else
+        {
+            position = queue->write.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->data = item;
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+template< typename T >
+bool pop(Concurrent_Queue< T > *queue, T *out_item)
+{
+    HE_ASSERT(out_item);
+
+    U64 position = queue->read.load(std::memory_order_relaxed);
+    Concurrent_Queue_Cell< T > *cell = nullptr;
+
+    while (true)
+    {
+        cell = &queue->cells[position & queue->mask];
+        U64 sequence = cell->sequence.load(std::memory_order_acquire);
+        S64 difference = (S64)sequence - (S64)(position + 1);
+
+        if (difference == 0)
+        {
+            if (queue->read.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            return false; // empty
+        }
+        else
+        {
+            position = queue->read.load(std::memory_order_relaxed);
+        }
+    }
+
+    *out_item = cell->data;
+    cell->sequence.store(position + queue->mask + 1, std::memory_order_release);
+    return true;
+}
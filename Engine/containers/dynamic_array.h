@@ -91,6 +91,37 @@ void set_capacity(Dynamic_Array< T > *dynamic_array, U32 new_capacity)
     dynamic_array->capacity = new_capacity;
 }
 
+// doubles the capacity until required_capacity fits so n appends reallocate O(log n) times.
+template< typename T >
+void grow(Dynamic_Array< T > *dynamic_array, U32 required_capacity)
+{
+    HE_ASSERT(dynamic_array);
+
+    if (required_capacity <= dynamic_array->capacity)
+    {
+        return;
+    }
+
+    U32 new_capacity = dynamic_array->capacity ? dynamic_array->capacity * 2 : HE_DEFAULT_DYNAMIC_ARRAY_INITIAL_CAPACITY;
+    while (new_capacity < required_capacity)
+    {
+        new_capacity *= 2;
+    }
+
+    set_capacity(dynamic_array, new_capacity);
+}
+
+template< typename T >
+void reserve(Dynamic_Array< T > *dynamic_array, U32 capacity)
+{
+    HE_ASSERT(dynamic_array);
+
+    if (capacity > dynamic_array->capacity)
+    {
+        set_capacity(dynamic_array, capacity);
+    }
+}
+
 template< typename T >
 void set_count(Dynamic_Array< T > *dynamic_array, U32 new_count)
 {
@@ -115,11 +146,7 @@ template< typename T >
 void append(Dynamic_Array< T > *dynamic_array, const T &item)
 {
     HE_ASSERT(dynamic_array);
-
-    if (dynamic_array->count == dynamic_array->capacity)
-    {
-        set_capacity(dynamic_array, dynamic_array->count * 2);
-    }
+    grow(dynamic_array, dynamic_array->count + 1);
     dynamic_array->data[dynamic_array->count++] = item;
 }
 
@@ -127,12 +154,35 @@ template< typename T >
 T& append(Dynamic_Array< T > *dynamic_array)
 {
     HE_ASSERT(dynamic_array);
+    grow(dynamic_array, dynamic_array->count + 1);
+    return dynamic_array->data[dynamic_array->count++];
+}
+
+// returns the first of count new items, they are left for the caller to fill.
+template< typename T >
+T* append_uninitialized(Dynamic_Array< T > *dynamic_array, U32 count)
+{
+    HE_ASSERT(dynamic_array);
+    grow(dynamic_array, dynamic_array->count + count);
 
-    if (dynamic_array->count == dynamic_array->capacity)
+    T *result = &dynamic_array->data[dynamic_array->count];
+    dynamic_array->count += count;
+    return result;
+}
+
+template< typename T >
+void append_n(Dynamic_Array< T > *dynamic_array, const T *items, U32 count)
+{
+    HE_ASSERT(dynamic_array);
+    HE_ASSERT(items || !count);
+
+    if (!count)
     {
-        set_capacity(dynamic_array, dynamic_array->count * 2);
+        return;
     }
-    return dynamic_array->data[dynamic_array->count++];
+
+    T *destination = append_uninitialized(dynamic_array, count);
+    copy_memory(destination, items, sizeof(T) * count);
 }
 
 template< typename T >
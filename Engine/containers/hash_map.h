@@ -2,12 +2,27 @@
 
 #include "core/defines.h"
 #include "core/memory.h"
+#include "core/platform.h"
 
-enum class Slot_State : U8
+#include <string.h>
+
+#include <bit>
+#include <emmintrin.h>
+
+// swiss table: https://abseil.io/about/design/swisstables
+// every slot has a control byte that is empty, deleted or the low 7 bits of the hash of its key. a lookup compares a group
+// of 16 control bytes at once with sse2 and only reads the keys whose byte matched. the first group is copied past the
+// end of the control bytes so a group can be loaded at any slot without wrapping.
+#define HE_HASH_MAP_GROUP_WIDTH 16
+
+// rehashes once used and deleted slots reach 7/8 of the capacity.
+#define HE_HASH_MAP_MAX_LOAD_NUMERATOR 7
+#define HE_HASH_MAP_MAX_LOAD_DENOMINATOR 8
+
+enum Hash_Map_Control : U8
 {
-    EMPTY,
-    OCCUPIED,
-    DELETED
+    HashMapControl_Empty = 0x80,
+    HashMapControl_Deleted = 0xFE
 };
 
 template< typename Key_Type, typename Value_Type >
@@ -15,21 +30,101 @@ struct Hash_Map
 {
     void *memory;
 
-    Slot_State *states;
+    U8 *controls; // capacity + HE_HASH_MAP_GROUP_WIDTH.
     Key_Type *keys;
     Value_Type *values;
 
-    U32 capacity;
+    U32 capacity; // slots, a power of two.
     U32 count;
+    U32 growth_left; // inserts into empty slots before the next rehash.
 
     Allocator allocator;
 };
 
 template< typename Key_Type, typename Value_Type >
-void init(Hash_Map< Key_Type, Value_Type > *hash_map, U32 capacity, Allocator allocator = {})
+struct Hash_Map_Iterator
+{
+    const Key_Type *key;
+    Value_Type *value;
+    S32 index;
+};
+
+template< typename Key_Type, typename Value_Type >
+HE_FORCE_INLINE bool is_valid(const Hash_Map_Iterator< Key_Type, Value_Type > &iterator)
+{
+    return iterator.value != nullptr;
+}
+
+// murmur3 finalizer so sequential keys spread over the whole table.
+inline U64 hash_key(U64 key)
+{
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDull;
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53ull;
+    key ^= key >> 33;
+    return key;
+}
+
+inline U64 hash_key(U32 key)
+{
+    return hash_key((U64)key);
+}
+
+HE_FORCE_INLINE U32 hash_map_match(const U8 *group, U8 control)
+{
+    __m128i controls = _mm_loadu_si128((const __m128i *)group);
+    return (U32)_mm_movemask_epi8(_mm_cmpeq_epi8(controls, _mm_set1_epi8((char)control)));
+}
+
+// empty and deleted are the only controls with the high bit set.
+HE_FORCE_INLINE U32 hash_map_match_empty_or_deleted(const U8 *group)
+{
+    return (U32)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
+}
+
+HE_FORCE_INLINE U32 get_hash_map_max_load(U32 capacity)
+{
+    return (U32)((U64)capacity * HE_HASH_MAP_MAX_LOAD_NUMERATOR / HE_HASH_MAP_MAX_LOAD_DENOMINATOR);
+}
+
+template< typename Key_Type, typename Value_Type >
+HE_FORCE_INLINE void set_hash_map_control(Hash_Map< Key_Type, Value_Type > *hash_map, U32 slot_index, U8 control)
+{
+    hash_map->controls[slot_index] = control;
+    if (slot_index < HE_HASH_MAP_GROUP_WIDTH)
+    {
+        hash_map->controls[hash_map->capacity + slot_index] = control;
+    }
+}
+
+template< typename Key_Type, typename Value_Type >
+void allocate_hash_map_slots(Hash_Map< Key_Type, Value_Type > *hash_map, U32 capacity)
+{
+    HE_ASSERT(capacity >= HE_HASH_MAP_GROUP_WIDTH && (capacity & (capacity - 1)) == 0);
+
+    U64 controls_size = ((U64)capacity + HE_HASH_MAP_GROUP_WIDTH + alignof(Key_Type) - 1) & ~((U64)alignof(Key_Type) - 1);
+    U64 keys_size = (sizeof(Key_Type) * capacity + alignof(Value_Type) - 1) & ~((U64)alignof(Value_Type) - 1);
+    U64 total_size = controls_size + keys_size + sizeof(Value_Type) * capacity;
+
+    // only the control bytes have to be initialized, keys and values are written on insert.
+    U8 *memory = HE_ALLOCATOR_ALLOCATE_ARRAY_NO_ZERO(hash_map->allocator, U8, total_size);
+    memset(memory, HashMapControl_Empty, (U64)capacity + HE_HASH_MAP_GROUP_WIDTH);
+
+    hash_map->memory = memory;
+    hash_map->controls = memory;
+    hash_map->keys = (Key_Type *)(memory + controls_size);
+    hash_map->values = (Value_Type *)(memory + controls_size + keys_size);
+    hash_map->capacity = capacity;
+    hash_map->count = 0;
+    hash_map->growth_left = get_hash_map_max_load(capacity);
+}
+
+// capacity is how many keys fit before the first rehash.
+template< typename Key_Type, typename Value_Type >
+void init(Hash_Map< Key_Type, Value_Type > *hash_map, U32 capacity = 0, Allocator allocator = {})
 {
     HE_ASSERT(hash_map);
-    HE_ASSERT(capacity);
 
     if (!allocator.data)
     {
@@ -37,146 +132,286 @@ void init(Hash_Map< Key_Type, Value_Type > *hash_map, U32 capacity, Allocator al
         allocator = memory_context.general_allocator;
     }
 
-    if ((capacity & (capacity - 1)) != 0)
+    U64 min_slot_count = ((U64)capacity * HE_HASH_MAP_MAX_LOAD_DENOMINATOR + HE_HASH_MAP_MAX_LOAD_NUMERATOR - 1) / HE_HASH_MAP_MAX_LOAD_NUMERATOR;
+    U32 slot_count = HE_HASH_MAP_GROUP_WIDTH;
+    while (slot_count < min_slot_count)
     {
-        U32 new_capacity = 2;
-        capacity--;
-        while (capacity >>= 1)
-        {
-            new_capacity <<= 1;
-        }
-        HE_ASSERT((new_capacity & (new_capacity - 1)) == 0);
-        capacity = new_capacity;
+        slot_count <<= 1;
     }
 
-    U64 total_size = (sizeof(Slot_State) + sizeof(Key_Type) + sizeof(Value_Type)) * capacity;
-    U8 *memory = HE_ALLOCATOR_ALLOCATE_ARRAY(allocator, U8, total_size);
-    
-    hash_map->memory = memory;
-    hash_map->states = (Slot_State*)memory;
-    hash_map->keys = (Key_Type*)(memory + sizeof(Slot_State) * capacity);
-    hash_map->values = (Value_Type*)(memory + (sizeof(Slot_State) + sizeof(Key_Type)) * capacity);
-    hash_map->capacity = capacity;
-    hash_map->count = 0;
     hash_map->allocator = allocator;
+    allocate_hash_map_slots(hash_map, slot_count);
 }
 
 template< typename Key_Type, typename Value_Type >
 void deinit(Hash_Map< Key_Type, Value_Type > *hash_map)
 {
+    HE_ASSERT(hash_map);
     HE_ALLOCATOR_DEALLOCATE(hash_map->allocator, hash_map->memory);
+    hash_map->memory = nullptr;
+    hash_map->count = 0;
 }
 
-template< typename Value_Type >
-struct Hash_Map_Iterator
+template< typename Key_Type, typename Value_Type >
+Hash_Map_Iterator< Key_Type, Value_Type > find(Hash_Map< Key_Type, Value_Type > *hash_map, const Key_Type &key)
 {
-    Value_Type *value;
-};
+    HE_ASSERT(hash_map);
 
-template< typename Value_Type >
-HE_FORCE_INLINE bool is_valid(const Hash_Map_Iterator< Value_Type > &iterator)
-{
-    return iterator.value != nullptr;
-}
+    U64 hash = hash_key(key);
+    U8 control = (U8)(hash & 0x7F);
+    U32 mask = hash_map->capacity - 1;
+    U32 position = (U32)(hash >> 7) & mask;
 
-inline U64 hash_key(U64 key)
-{
-    return key;
+    // triangular probing visits every group once since the capacity is a power of two.
+    for (U32 stride = HE_HASH_MAP_GROUP_WIDTH;; stride += HE_HASH_MAP_GROUP_WIDTH)
+    {
+        const U8 *group = &hash_map->controls[position];
+
+        for (U32 matches = hash_map_match(group, control); matches; matches &= matches - 1)
+        {
+            U32 slot_index = (position + std::countr_zero(matches)) & mask;
+            if (hash_map->keys[slot_index] == key)
+            {
+                return { &hash_map->keys[slot_index], &hash_map->values[slot_index], (S32)slot_index };
+            }
+        }
+
+        // there is always an empty slot since rehashing keeps used and deleted slots below the max load.
+        if (hash_map_match(group, HashMapControl_Empty))
+        {
+            return { nullptr, nullptr, -1 };
+        }
+
+        position = (position + stride) & mask;
+    }
 }
 
-inline U64 hash_key(U32 key)
+template< typename Key_Type, typename Value_Type >
+U32 find_hash_map_insert_slot(Hash_Map< Key_Type, Value_Type > *hash_map, U64 hash)
 {
-    return key;
+    U32 mask = hash_map->capacity - 1;
+    U32 position = (U32)(hash >> 7) & mask;
+
+    for (U32 stride = HE_HASH_MAP_GROUP_WIDTH;; stride += HE_HASH_MAP_GROUP_WIDTH)
+    {
+        U32 matches = hash_map_match_empty_or_deleted(&hash_map->controls[position]);
+        if (matches)
+        {
+            return (position + std::countr_zero(matches)) & mask;
+        }
+
+        position = (position + stride) & mask;
+    }
 }
 
+// doubles the capacity, or keeps it and only drops the deleted slots when at most half the max load is live.
 template< typename Key_Type, typename Value_Type >
-Hash_Map_Iterator< Value_Type > find(Hash_Map< Key_Type, Value_Type > *hash_map, const Key_Type &key, S32 *out_insert_index = nullptr)
+void rehash(Hash_Map< Key_Type, Value_Type > *hash_map)
 {
     HE_ASSERT(hash_map);
 
-    U32 slot_index = hash_key(key) & (hash_map->capacity - 1);
-    U32 start_slot = slot_index;
-    S32 insert_index = -1;
-
-    Hash_Map_Iterator< Value_Type > result;
-    result.value = nullptr;
+    Hash_Map< Key_Type, Value_Type > old_hash_map = *hash_map;
 
-    do
+    U32 new_capacity = old_hash_map.capacity;
+    if (old_hash_map.count + 1 > get_hash_map_max_load(old_hash_map.capacity) / 2)
     {
-        Slot_State *state = &hash_map->states[slot_index];
+        new_capacity *= 2;
+    }
 
-        if (*state == Slot_State::EMPTY)
-        {
-            if (insert_index == -1)
-            {
-                insert_index = slot_index;
-                break;
-            }
-        }
-        else if (*state == Slot_State::OCCUPIED)
-        {
-            if (hash_map->keys[slot_index] == key)
-            {
-                result.value = &hash_map->values[slot_index];
-                insert_index = slot_index;
-                break;
-            }
-        }
-        else if (*state == Slot_State::DELETED)
+    allocate_hash_map_slots(hash_map, new_capacity);
+
+    for (U32 slot_index = 0; slot_index < old_hash_map.capacity; slot_index++)
+    {
+        if (old_hash_map.controls[slot_index] & 0x80)
         {
-            if (insert_index == -1)
-            {
-                insert_index = slot_index;
-            }
+            continue;
         }
 
-        slot_index = (slot_index + 1) & (hash_map->capacity - 1);
+        U64 hash = hash_key(old_hash_map.keys[slot_index]);
+        U32 new_slot_index = find_hash_map_insert_slot(hash_map, hash);
+        set_hash_map_control(hash_map, new_slot_index, (U8)(hash & 0x7F));
+        hash_map->keys[new_slot_index] = old_hash_map.keys[slot_index];
+        hash_map->values[new_slot_index] = old_hash_map.values[slot_index];
+    }
+
+    hash_map->count = old_hash_map.count;
+    hash_map->growth_left -= old_hash_map.count;
+
+    HE_ALLOCATOR_DEALLOCATE(hash_map->allocator, old_hash_map.memory);
+}
+
+// iterators into the map are invalidated when the insert rehashes.
+template< typename Key_Type, typename Value_Type >
+Hash_Map_Iterator< Key_Type, Value_Type > insert(Hash_Map< Key_Type, Value_Type > *hash_map, const Key_Type &key, const Value_Type &value = {})
+{
+    HE_ASSERT(hash_map);
+
+    auto it = find(hash_map, key);
+    if (is_valid(it))
+    {
+        *it.value = value;
+        return it;
     }
-    while (slot_index != start_slot);
 
-    if (out_insert_index)
+    U64 hash = hash_key(key);
+    U32 slot_index = find_hash_map_insert_slot(hash_map, hash);
+
+    // reusing a deleted slot doesn't use up an empty one.
+    if (hash_map->growth_left == 0 && hash_map->controls[slot_index] != HashMapControl_Deleted)
     {
-        *out_insert_index = insert_index;
+        rehash(hash_map);
+        slot_index = find_hash_map_insert_slot(hash_map, hash);
     }
 
-    return result;
+    if (hash_map->controls[slot_index] == HashMapControl_Empty)
+    {
+        hash_map->growth_left--;
+    }
+
+    set_hash_map_control(hash_map, slot_index, (U8)(hash & 0x7F));
+    hash_map->keys[slot_index] = key;
+    hash_map->values[slot_index] = value;
+    hash_map->count++;
+
+    return { &hash_map->keys[slot_index], &hash_map->values[slot_index], (S32)slot_index };
 }
 
 template< typename Key_Type, typename Value_Type >
-S32 insert(Hash_Map< Key_Type, Value_Type > *hash_map, const Key_Type &key, const Value_Type &value = {})
+bool remove(Hash_Map< Key_Type, Value_Type > *hash_map, const Key_Type &key)
 {
     HE_ASSERT(hash_map);
-    HE_ASSERT(hash_map->count < hash_map->capacity);
 
-    S32 insert_index = -1;
-    auto it = find(hash_map, key, &insert_index);
-    if (is_valid(it))
+    auto it = find(hash_map, key);
+    if (!is_valid(it))
     {
-        hash_map->values[insert_index] = value;
+        return false;
+    }
+
+    U32 slot_index = (U32)it.index;
+    U32 mask = hash_map->capacity - 1;
+
+    // the slot can go back to empty if no group that covers it was ever full, a probe would never have gone past it.
+    U32 empty_after = hash_map_match(&hash_map->controls[slot_index], HashMapControl_Empty);
+    U32 empty_before = hash_map_match(&hash_map->controls[(slot_index - HE_HASH_MAP_GROUP_WIDTH) & mask], HashMapControl_Empty);
+    bool was_never_full = empty_after && empty_before && (U32)(std::countr_zero(empty_after) + std::countl_zero((U16)empty_before)) < HE_HASH_MAP_GROUP_WIDTH;
+
+    if (was_never_full)
+    {
+        set_hash_map_control(hash_map, slot_index, HashMapControl_Empty);
+        hash_map->growth_left++;
     }
     else
     {
-        HE_ASSERT(insert_index != -1);
-        hash_map->states[insert_index] = Slot_State::OCCUPIED;
-        hash_map->keys[insert_index] = key;
-        hash_map->values[insert_index] = value;
-        hash_map->count++;
+        set_hash_map_control(hash_map, slot_index, HashMapControl_Deleted);
     }
 
-    return insert_index;
+    hash_map->count--;
+    return true;
+}
+
+template< typename Key_Type, typename Value_Type >
+void reset(Hash_Map< Key_Type, Value_Type > *hash_map)
+{
+    HE_ASSERT(hash_map);
+    memset(hash_map->controls, HashMapControl_Empty, (U64)hash_map->capacity + HE_HASH_MAP_GROUP_WIDTH);
+    hash_map->count = 0;
+    hash_map->growth_left = get_hash_map_max_load(hash_map->capacity);
 }
 
 template< typename Key_Type, typename Value_Type >
-void remove(Hash_Map< Key_Type, Value_Type > *hash_map, const Key_Type &key)
+Hash_Map_Iterator< Key_Type, Value_Type > iterator(Hash_Map< Key_Type, Value_Type > *hash_map)
 {
     HE_ASSERT(hash_map);
-    HE_ASSERT(hash_map->count);
+    return { nullptr, nullptr, -1 };
+}
+
+template< typename Key_Type, typename Value_Type >
+bool next(Hash_Map< Key_Type, Value_Type > *hash_map, Hash_Map_Iterator< Key_Type, Value_Type > &it)
+{
+    for (U32 position = (U32)(it.index + 1); position < hash_map->capacity; position += HE_HASH_MAP_GROUP_WIDTH)
+    {
+        U32 full = ~hash_map_match_empty_or_deleted(&hash_map->controls[position]) & 0xFFFF;
+        if (full)
+        {
+            U32 slot_index = position + std::countr_zero(full);
+            if (slot_index >= hash_map->capacity)
+            {
+                break;
+            }
+
+            it = { &hash_map->keys[slot_index], &hash_map->values[slot_index], (S32)slot_index };
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//
+// Concurrent Hash Map
+//
+
+// readers share the lock so lookups from many threads don't serialize, writers take it exclusively.
+// values are copied out since a slot can move as soon as the lock is released.
+template< typename Key_Type, typename Value_Type >
+struct Concurrent_Hash_Map
+{
+    Hash_Map< Key_Type, Value_Type > hash_map;
+    Read_Write_Lock lock;
+};
+
+template< typename Key_Type, typename Value_Type >
+void init(Concurrent_Hash_Map< Key_Type, Value_Type > *concurrent_hash_map, U32 capacity = 0, Allocator allocator = {})
+{
+    HE_ASSERT(concurrent_hash_map);
+    init(&concurrent_hash_map->hash_map, capacity, allocator);
 
-    S32 slot_index = -1;
-    auto it = find(hash_map, key, &slot_index);
+    bool lock_created = platform_create_read_write_lock(&concurrent_hash_map->lock);
+    HE_ASSERT(lock_created);
+}
+
+template< typename Key_Type, typename Value_Type >
+void deinit(Concurrent_Hash_Map< Key_Type, Value_Type > *concurrent_hash_map)
+{
+    HE_ASSERT(concurrent_hash_map);
+    deinit(&concurrent_hash_map->hash_map);
+}
+
+template< typename Key_Type, typename Value_Type >
+bool find(Concurrent_Hash_Map< Key_Type, Value_Type > *concurrent_hash_map, const Key_Type &key, Value_Type *out_value)
+{
+    HE_ASSERT(concurrent_hash_map);
+    HE_ASSERT(out_value);
+
+    platform_lock_read(&concurrent_hash_map->lock);
+
+    auto it = find(&concurrent_hash_map->hash_map, key);
     if (is_valid(it))
     {
-        hash_map->states[slot_index] = Slot_State::DELETED;
-        hash_map->count--;
+        *out_value = *it.value;
     }
-}
\ No newline at end of file
+
+    platform_unlock_read(&concurrent_hash_map->lock);
+    return is_valid(it);
+}
+
+template< typename Key_Type, typename Value_Type >
+void insert(Concurrent_Hash_Map< Key_Type, Value_Type > *concurrent_hash_map, const Key_Type &key, const Value_Type &value)
+{
+    HE_ASSERT(concurrent_hash_map);
+
+    platform_lock_write(&concurrent_hash_map->lock);
+    insert(&concurrent_hash_map->hash_map, key, value);
+    platform_unlock_write(&concurrent_hash_map->lock);
+}
+
+template< typename Key_Type, typename Value_Type >
+bool remove(Concurrent_Hash_Map< Key_Type, Value_Type > *concurrent_hash_map, const Key_Type &key)
+{
+    HE_ASSERT(concurrent_hash_map);
+
+    platform_lock_write(&concurrent_hash_map->lock);
+    bool removed = remove(&concurrent_hash_map->hash_map, key);
+    platform_unlock_write(&concurrent_hash_map->lock);
+    return removed;
+}
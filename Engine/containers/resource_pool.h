@@ -4,6 +4,9 @@
 #include "core/memory.h"
 #include "core/platform.h"
 
+#include <atomic>
+#include <bit>
+
 template< typename T >
 struct Resource_Handle
 {
@@ -21,32 +24,30 @@ struct Resource_Handle
     }
 };
 
-struct Resource_Pool_Node
-{
-    S32 next;
-};
+#define HE_RESOURCE_POOL_EMPTY 0xFFFFFFFF
 
+// acquire, release, get and iteration are lock-free. a slot's generation is odd while it is allocated and
+// is bumped on both acquire and release so validating a handle is a single atomic load. live slots are also
+// tracked in a bitset so iteration only touches one word per 64 slots. there is no live count, it would be
+// one more contended read-modify-write on every acquire and release.
 template< typename T >
 struct Resource_Pool
 {
     constexpr static Resource_Handle< T > invalid_handle = { -1, 0 };
 
-    static_assert(sizeof(T) >= sizeof(U32));
-
     void *memory;
 
     T *data;
-    U32 *generations;
-    bool *is_allocated;
-
-    S32 first_free_node_index;
+    std::atomic< U32 > *generations;
+    std::atomic< U32 > *next_free_indices;
+    std::atomic< U64 > *live_masks;
 
     U32 capacity;
-    U32 count;
 
     Allocator allocator;
 
-    Mutex mutex;
+    // low 32 bits are the first free index, high 32 bits are a tag bumped on every change to avoid ABA.
+    std::atomic< U64 > first_free;
 };
 
 template< typename T >
@@ -55,30 +56,33 @@ void init(Resource_Pool< T > *resource_pool, U32 capacity, Allocator allocator)
     HE_ASSERT(resource_pool);
     HE_ASSERT(capacity);
 
-    U64 size = (sizeof(T) + sizeof(U32) + sizeof(bool)) * capacity;
-    U8 *memory = HE_ALLOCATOR_ALLOCATE_ARRAY(allocator, U8, size);
+    U32 live_mask_count = (capacity + 63) / 64;
+    U64 data_offset = sizeof(std::atomic< U64 >) * live_mask_count + sizeof(std::atomic< U32 >) * capacity * 2;
+    data_offset = (data_offset + alignof(T) - 1) & ~(U64)(alignof(T) - 1);
+
+    U64 size = data_offset + sizeof(T) * capacity;
+    U64 alignment = alignof(T) > alignof(std::atomic< U64 >) ? alignof(T) : alignof(std::atomic< U64 >);
+    U8 *memory = (U8 *)allocator.allocate(allocator.data, size, (U16)alignment, AllocationFlag_None);
     resource_pool->memory = memory;
-    resource_pool->data = (T *)memory;
-    resource_pool->generations = (U32 *)(memory + sizeof(T) * capacity);
-    resource_pool->is_allocated = (bool *)(memory + (sizeof(T) + sizeof(U32)) * capacity);
+    resource_pool->live_masks = (std::atomic< U64 > *)memory;
+    resource_pool->generations = (std::atomic< U32 > *)(resource_pool->live_masks + live_mask_count);
+    resource_pool->next_free_indices = resource_pool->generations + capacity;
+    resource_pool->data = (T *)(memory + data_offset);
 
-    for (U32 slot_index = 0; slot_index < capacity - 1; slot_index++)
+    for (U32 slot_index = 0; slot_index < capacity; slot_index++)
     {
-        Resource_Pool_Node *node = (Resource_Pool_Node *)&resource_pool->data[slot_index];
-        node->next = slot_index + 1;
+        resource_pool->generations[slot_index].store(0, std::memory_order_relaxed);
+        resource_pool->next_free_indices[slot_index].store(slot_index + 1 < capacity ? slot_index + 1 : HE_RESOURCE_POOL_EMPTY, std::memory_order_relaxed);
     }
-    Resource_Pool_Node *last_node = (Resource_Pool_Node *)&resource_pool->data[capacity - 1];
-    last_node->next = -1;
-    resource_pool->first_free_node_index = 0;
 
-    zero_memory(resource_pool->generations, sizeof(U32) * capacity);
-    zero_memory(resource_pool->is_allocated, sizeof(bool) * capacity);
+    for (U32 mask_index = 0; mask_index < live_mask_count; mask_index++)
+    {
+        resource_pool->live_masks[mask_index].store(0, std::memory_order_relaxed);
+    }
 
     resource_pool->capacity = capacity;
-    resource_pool->count = 0;
     resource_pool->allocator = allocator;
-
-    platform_create_mutex(&resource_pool->mutex);
+    resource_pool->first_free.store(0);
 }
 
 template< typename T >
@@ -92,37 +96,55 @@ template< typename T >
 HE_FORCE_INLINE bool is_valid_handle(Resource_Pool< T > *resource_pool, Resource_Handle< T > handle)
 {
     HE_ASSERT(resource_pool);
-    platform_lock_mutex(&resource_pool->mutex);
-
-    bool result = handle.index >= 0 && handle.index < (S32)resource_pool->capacity && resource_pool->is_allocated[handle.index] && resource_pool->generations[handle.index] == handle.generation;
-    
-    platform_unlock_mutex(&resource_pool->mutex);
-
-    return result;
+    return handle.index >= 0 && handle.index < (S32)resource_pool->capacity && (handle.generation & 1) && resource_pool->generations[handle.index].load(std::memory_order_acquire) == handle.generation;
 }
 
 template< typename T >
 Resource_Handle< T > acquire_handle(Resource_Pool< T > *resource_pool)
 {
     HE_ASSERT(resource_pool);
-    HE_ASSERT(resource_pool->count < resource_pool->capacity);
-    HE_ASSERT(resource_pool->first_free_node_index >= 0 && (U32)resource_pool->first_free_node_index < resource_pool->capacity);
 
-    platform_lock_mutex(&resource_pool->mutex);
+    U64 first_free = resource_pool->first_free.load(std::memory_order_acquire);
+    U32 index;
 
-    S32 index = resource_pool->first_free_node_index;
-    HE_ASSERT(!resource_pool->is_allocated[index]);
+    do
+    {
+        index = (U32)first_free;
+        HE_ASSERT(index != HE_RESOURCE_POOL_EMPTY);
+
+        // may read a stale next index if another thread popped this slot in between, the tag makes the exchange fail then.
+        U64 next = resource_pool->next_free_indices[index].load(std::memory_order_relaxed);
+        U64 tag = (first_free >> 32) + 1;
 
-    Resource_Pool_Node *node = (Resource_Pool_Node *)&resource_pool->data[index];
-    resource_pool->first_free_node_index = node->next;
-    resource_pool->count++;
-    resource_pool->is_allocated[index] = true;
-    Resource_Handle< T > handle = { index, resource_pool->generations[index] };
+        if (resource_pool->first_free.compare_exchange_weak(first_free, (tag << 32) | next, std::memory_order_acquire))
+        {
+            break;
+        }
+    }
+    while (true);
 
-    platform_unlock_mutex(&resource_pool->mutex);
-    
     zero_memory(&resource_pool->data[index], sizeof(T));
-    return handle;
+
+    // the slot is ours once popped so the generation doesn't need a read-modify-write.
+    U32 generation = resource_pool->generations[index].load(std::memory_order_relaxed) + 1;
+    HE_ASSERT(generation & 1);
+    resource_pool->generations[index].store(generation, std::memory_order_release);
+
+    resource_pool->live_masks[index / 64].fetch_or(1ull << (index % 64), std::memory_order_release);
+
+    return { (S32)index, generation };
+}
+
+template< typename T >
+void acquire_handles(Resource_Pool< T > *resource_pool, U32 count, Resource_Handle< T > *out_handles)
+{
+    HE_ASSERT(resource_pool);
+    HE_ASSERT(out_handles);
+
+    for (U32 handle_index = 0; handle_index < count; handle_index++)
+    {
+        out_handles[handle_index] = acquire_handle(resource_pool);
+    }
 }
 
 template< typename T >
@@ -137,19 +159,23 @@ template< typename T >
 void release_handle(Resource_Pool< T > *resource_pool, Resource_Handle< T > handle)
 {
     HE_ASSERT(resource_pool);
-    HE_ASSERT(resource_pool->count);
     HE_ASSERT(is_valid_handle(resource_pool, handle));
 
-    platform_lock_mutex(&resource_pool->mutex);
+    U32 index = (U32)handle.index;
+    resource_pool->generations[index].store(handle.generation + 1, std::memory_order_release);
+
+    resource_pool->live_masks[index / 64].fetch_and(~(1ull << (index % 64)), std::memory_order_relaxed);
 
-    Resource_Pool_Node *node = (Resource_Pool_Node *)&resource_pool->data[handle.index];
-    node->next = resource_pool->first_free_node_index;
-    resource_pool->first_free_node_index = handle.index;
-    resource_pool->generations[handle.index]++;
-    resource_pool->is_allocated[handle.index] = false;
-    resource_pool->count--;
+    U64 first_free = resource_pool->first_free.load(std::memory_order_relaxed);
+    U64 new_first_free;
 
-    platform_unlock_mutex(&resource_pool->mutex);
+    do
+    {
+        resource_pool->next_free_indices[index].store((U32)first_free, std::memory_order_relaxed);
+        U64 tag = (first_free >> 32) + 1;
+        new_first_free = (tag << 32) | index;
+    }
+    while (!resource_pool->first_free.compare_exchange_weak(first_free, new_first_free, std::memory_order_release, std::memory_order_relaxed));
 }
 
 template< typename T >
@@ -162,15 +188,41 @@ Resource_Handle< T > iterator(Resource_Pool< T > *resource_pool)
 template< typename T >
 bool next(Resource_Pool< T > *resource_pool, Resource_Handle< T > &handle)
 {
-    for (U32 index = handle.index + 1; index < resource_pool->capacity; index++)
+    U32 index = (U32)(handle.index + 1);
+    if (index >= resource_pool->capacity)
+    {
+        return false;
+    }
+
+    U32 live_mask_count = (resource_pool->capacity + 63) / 64;
+    U32 mask_index = index / 64;
+
+    // drop the bits of slots already visited in the first word.
+    U64 live_mask = resource_pool->live_masks[mask_index].load(std::memory_order_acquire) & (~0ull << (index % 64));
+
+    while (true)
     {
-        if (resource_pool->is_allocated[index])
+        while (live_mask)
         {
-            handle.index = (S32)index;
-            handle.generation = resource_pool->generations[index];
-            return true;
+            index = mask_index * 64 + (U32)std::countr_zero(live_mask);
+            U32 generation = resource_pool->generations[index].load(std::memory_order_acquire);
+
+            // skip a slot that is being released, its bit is cleared right after the generation bump.
+            if (generation & 1)
+            {
+                handle.index = (S32)index;
+                handle.generation = generation;
+                return true;
+            }
+
+            live_mask &= live_mask - 1;
         }
-    }
 
-    return false;
-}
\ No newline at end of file
+        if (++mask_index == live_mask_count)
+        {
+            return false;
+        }
+
+        live_mask = resource_pool->live_masks[mask_index].load(std::memory_order_acquire);
+    }
+}
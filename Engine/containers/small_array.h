@@ -0,0 +1,244 @@
+#pragma once
+
+#include "core/defines.h"
+#include "core/memory.h"
+
+#include "containers/array_view.h"
+
+// keeps up to N items inline and moves them to the allocator only when they outgrow it. the inline items are not
+// referenced by pointer so the struct can be copied like the other containers, a copy of a spilled array shares
+// its heap items.
+template< typename T, U32 N >
+struct Small_Array
+{
+    static_assert(N > 0);
+
+    T inline_data[N];
+    T *heap_data; // null while the items fit inline.
+
+    U32 count;
+    U32 heap_capacity;
+
+    Allocator allocator;
+
+    HE_FORCE_INLINE T* get_data()
+    {
+        return heap_data ? heap_data : inline_data;
+    }
+
+    HE_FORCE_INLINE const T* get_data() const
+    {
+        return heap_data ? heap_data : inline_data;
+    }
+
+    HE_FORCE_INLINE T& operator[](U32 index)
+    {
+        HE_ASSERT(index < count);
+        return get_data()[index];
+    }
+
+    HE_FORCE_INLINE const T& operator[](U32 index) const
+    {
+        HE_ASSERT(index < count);
+        return get_data()[index];
+    }
+
+    HE_FORCE_INLINE T* begin()
+    {
+        return get_data();
+    }
+
+    HE_FORCE_INLINE T* end()
+    {
+        return get_data() + count;
+    }
+
+    HE_FORCE_INLINE const T* begin() const
+    {
+        return get_data();
+    }
+
+    HE_FORCE_INLINE const T* end() const
+    {
+        return get_data() + count;
+    }
+};
+
+template< typename T, U32 N >
+Small_Array< T, N > make_small_array(Allocator allocator)
+{
+    HE_ASSERT(allocator.data);
+    Small_Array< T, N > result = {};
+    result.allocator = allocator;
+    return result;
+}
+
+template< typename T, U32 N >
+void deinit(Small_Array< T, N > *small_array)
+{
+    HE_ASSERT(small_array);
+
+    if (small_array->heap_data)
+    {
+        HE_ALLOCATOR_DEALLOCATE(small_array->allocator, small_array->heap_data);
+        small_array->heap_data = nullptr;
+        small_array->heap_capacity = 0;
+    }
+
+    small_array->count = 0;
+}
+
+template< typename T, U32 N >
+HE_FORCE_INLINE U32 get_capacity(const Small_Array< T, N > *small_array)
+{
+    HE_ASSERT(small_array);
+    return small_array->heap_data ? small_array->heap_capacity : N;
+}
+
+template< typename T, U32 N >
+void reserve(Small_Array< T, N > *small_array, U32 capacity)
+{
+    HE_ASSERT(small_array);
+
+    if (capacity <= get_capacity(small_array))
+    {
+        return;
+    }
+
+    if (!small_array->allocator.data)
+    {
+        Memory_Context memory_context = grab_memory_context();
+        small_array->allocator = memory_context.general_allocator;
+    }
+
+    if (small_array->heap_data)
+    {
+        small_array->heap_data = HE_ALLOCATOR_REALLOCATE_ARRAY_SIZED(small_array->allocator, small_array->heap_data, T, small_array->heap_capacity, capacity);
+    }
+    else
+    {
+        small_array->heap_data = HE_ALLOCATOR_ALLOCATE_ARRAY_NO_ZERO(small_array->allocator, T, capacity);
+        copy_memory(small_array->heap_data, small_array->inline_data, sizeof(T) * small_array->count);
+    }
+
+    small_array->heap_capacity = capacity;
+}
+
+// doubles the capacity until required_capacity fits, the first spill goes to 2 * N.
+template< typename T, U32 N >
+void grow(Small_Array< T, N > *small_array, U32 required_capacity)
+{
+    U32 capacity = get_capacity(small_array);
+    if (required_capacity <= capacity)
+    {
+        return;
+    }
+
+    U32 new_capacity = capacity * 2;
+    while (new_capacity < required_capacity)
+    {
+        new_capacity *= 2;
+    }
+
+    reserve(small_array, new_capacity);
+}
+
+template< typename T, U32 N >
+void set_count(Small_Array< T, N > *small_array, U32 new_count)
+{
+    HE_ASSERT(small_array);
+    grow(small_array, new_count);
+    small_array->count = new_count;
+}
+
+template< typename T, U32 N >
+HE_FORCE_INLINE void reset(Small_Array< T, N > *small_array)
+{
+    HE_ASSERT(small_array);
+    small_array->count = 0;
+}
+
+template< typename T, U32 N >
+void append(Small_Array< T, N > *small_array, const T &item)
+{
+    HE_ASSERT(small_array);
+    grow(small_array, small_array->count + 1);
+    small_array->get_data()[small_array->count++] = item;
+}
+
+template< typename T, U32 N >
+T& append(Small_Array< T, N > *small_array)
+{
+    HE_ASSERT(small_array);
+    grow(small_array, small_array->count + 1);
+    return small_array->get_data()[small_array->count++];
+}
+
+// returns the first of count new items, they are left for the caller to fill.
+template< typename T, U32 N >
+T* append_uninitialized(Small_Array< T, N > *small_array, U32 count)
+{
+    HE_ASSERT(small_array);
+    grow(small_array, small_array->count + count);
+
+    T *result = small_array->get_data() + small_array->count;
+    small_array->count += count;
+    return result;
+}
+
+template< typename T, U32 N >
+void append_n(Small_Array< T, N > *small_array, const T *items, U32 count)
+{
+    HE_ASSERT(small_array);
+    HE_ASSERT(items || !count);
+
+    if (!count)
+    {
+        return;
+    }
+
+    T *destination = append_uninitialized(small_array, count);
+    copy_memory(destination, items, sizeof(T) * count);
+}
+
+template< typename T, U32 N >
+void remove_back(Small_Array< T, N > *small_array)
+{
+    HE_ASSERT(small_array);
+    HE_ASSERT(small_array->count);
+    small_array->count--;
+}
+
+template< typename T, U32 N >
+void remove_and_swap_back(Small_Array< T, N > *small_array, U32 index)
+{
+    HE_ASSERT(small_array);
+    HE_ASSERT(index < small_array->count);
+
+    T *data = small_array->get_data();
+    data[index] = data[small_array->count - 1];
+    small_array->count--;
+}
+
+template< typename T, U32 N >
+S32 find(const Small_Array< T, N > *small_array, const T &target)
+{
+    HE_ASSERT(small_array);
+
+    const T *data = small_array->get_data();
+    for (S32 index = 0; index < (S32)small_array->count; index++)
+    {
+        if (data[index] == target)
+        {
+            return index;
+        }
+    }
+
+    return -1;
+}
+
+template< typename T, U32 N >
+HE_FORCE_INLINE Array_View< T > to_array_view(const Small_Array< T, N > &small_array)
+{
+    return { small_array.count, small_array.get_data() };
+}
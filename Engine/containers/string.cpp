@@ -1,9 +1,15 @@
 #include "string.h"
 #include "core/memory.h"
+#include "core/platform.h"
+
+#include "containers/hash_map.h"
+#include "containers/dynamic_array.h"
 
 #include <stdio.h>
 #include <stdarg.h>
 #include <stdlib.h>
+#include <bit>
+#include <emmintrin.h>
 
 static constexpr String white_space = HE_STRING_LITERAL(" \n\t\r\v\f");
 
@@ -19,17 +25,7 @@ U64 string_length(const char *str)
 
 U64 hash_key(String str)
 {
-    const U64 p = 31;
-    const U64 m = U64(1e9) + 7;
-
-    U64 hash = 0;
-    U64 multiplier = 1;
-    for (U32 i = 0; i < str.count; i++)
-    {
-        hash = ((hash + (str.data[i] - 'a' + 1) * multiplier)) % m;
-        multiplier = (multiplier * p) % m;
-    }
-    return hash;
+    return hash_string(str.data, str.count);
 }
 
 String copy_string(const char *str, U64 count, Allocator allocator)
@@ -49,13 +45,62 @@ String copy_string(const char *str, U64 count, Allocator allocator)
     return { .count = count, .data = data };
 }
 
-// todo(amer): SIMD Version
 bool equal(const char *a, U64 a_length, const char *b, U64 b_length)
 {
     if (a_length != b_length)
     {
         return false;
     }
+
+    if (a == b)
+    {
+        return true;
+    }
+
+    if (a_length >= 16)
+    {
+        U64 char_index = 0;
+        for (; char_index + 16 <= a_length; char_index += 16)
+        {
+            __m128i a_chars = _mm_loadu_si128((const __m128i *)(a + char_index));
+            __m128i b_chars = _mm_loadu_si128((const __m128i *)(b + char_index));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(a_chars, b_chars)) != 0xFFFF)
+            {
+                return false;
+            }
+        }
+
+        // the last 16 chars overlap the ones already compared instead of falling back to a scalar tail.
+        if (char_index < a_length)
+        {
+            __m128i a_chars = _mm_loadu_si128((const __m128i *)(a + a_length - 16));
+            __m128i b_chars = _mm_loadu_si128((const __m128i *)(b + a_length - 16));
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(a_chars, b_chars)) == 0xFFFF;
+        }
+
+        return true;
+    }
+
+    if (a_length >= 8)
+    {
+        U64 a_head, b_head, a_tail, b_tail;
+        memcpy(&a_head, a, sizeof(U64));
+        memcpy(&b_head, b, sizeof(U64));
+        memcpy(&a_tail, a + a_length - 8, sizeof(U64));
+        memcpy(&b_tail, b + a_length - 8, sizeof(U64));
+        return a_head == b_head && a_tail == b_tail;
+    }
+
+    if (a_length >= 4)
+    {
+        U32 a_head, b_head, a_tail, b_tail;
+        memcpy(&a_head, a, sizeof(U32));
+        memcpy(&b_head, b, sizeof(U32));
+        memcpy(&a_tail, a + a_length - 4, sizeof(U32));
+        memcpy(&b_tail, b + a_length - 4, sizeof(U32));
+        return a_head == b_head && a_tail == b_tail;
+    }
+
     for (U64 char_index = 0; char_index < a_length; char_index++)
     {
         if (a[char_index] != b[char_index])
@@ -63,15 +108,34 @@ bool equal(const char *a, U64 a_length, const char *b, U64 b_length)
             return false;
         }
     }
+
     return true;
 }
 
-// todo(amer): SIMD version
 S64 find_first_char_from_left(String str, String chars, U64 offset)
 {
     HE_ASSERT(offset <= str.count);
 
-    for (U64 i = offset; i < str.count; i++)
+    U64 i = offset;
+
+    for (; i + 16 <= str.count; i += 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i *)(str.data + i));
+        __m128i matches = _mm_setzero_si128();
+
+        for (U64 j = 0; j < chars.count; j++)
+        {
+            matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, _mm_set1_epi8(chars.data[j])));
+        }
+
+        U32 mask = (U32)_mm_movemask_epi8(matches);
+        if (mask)
+        {
+            return (S64)(i + std::countr_zero(mask));
+        }
+    }
+
+    for (; i < str.count; i++)
     {
         for (U64 j = 0; j < chars.count; j++)
         {
@@ -358,4 +422,100 @@ F32 str_to_f32(String str)
     Memory_Context memory_context = grab_memory_context();
     String temp = copy_string(str, memory_context.temp_allocator);
     return (F32)atof(temp.data);
-}
\ No newline at end of file
+}
+//
+// String Interning
+//
+
+#define HE_STRING_TABLE_INITIAL_CAPACITY 4096
+
+struct String_Table
+{
+    Hash_Map< String, String_Id > ids;
+    Dynamic_Array< String > strings;
+    Read_Write_Lock lock;
+    Allocator allocator;
+};
+
+static String_Table string_table;
+
+bool init_string_table()
+{
+    Memory_Context memory_context = grab_memory_context();
+    string_table.allocator = memory_context.general_allocator;
+
+    init(&string_table.ids, HE_STRING_TABLE_INITIAL_CAPACITY, string_table.allocator);
+    string_table.strings = make_dynamic_array< String >(string_table.allocator);
+    set_capacity(&string_table.strings, HE_STRING_TABLE_INITIAL_CAPACITY);
+
+    // id 0 is the empty string.
+    append(&string_table.strings, String {});
+
+    return platform_create_read_write_lock(&string_table.lock);
+}
+
+void deinit_string_table()
+{
+    for (U32 string_index = 1; string_index < string_table.strings.count; string_index++)
+    {
+        HE_ALLOCATOR_DEALLOCATE(string_table.allocator, (void *)string_table.strings[string_index].data);
+    }
+
+    deinit(&string_table.ids);
+    deinit(&string_table.strings);
+}
+
+String_Id find_string_id(String str)
+{
+    if (!str.count)
+    {
+        return 0;
+    }
+
+    platform_lock_read(&string_table.lock);
+
+    auto it = find(&string_table.ids, str);
+    String_Id string_id = is_valid(it) ? *it.value : 0;
+
+    platform_unlock_read(&string_table.lock);
+    return string_id;
+}
+
+String_Id intern_string(String str)
+{
+    String_Id string_id = find_string_id(str);
+    if (string_id || !str.count)
+    {
+        return string_id;
+    }
+
+    platform_lock_write(&string_table.lock);
+
+    // another thread may have interned it between the two locks.
+    auto it = find(&string_table.ids, str);
+    if (is_valid(it))
+    {
+        string_id = *it.value;
+    }
+    else
+    {
+        String interned = copy_string(str, string_table.allocator);
+        string_id = string_table.strings.count;
+        append(&string_table.strings, interned);
+        insert(&string_table.ids, interned, string_id);
+    }
+
+    platform_unlock_write(&string_table.lock);
+    return string_id;
+}
+
+String get_string(String_Id string_id)
+{
+    platform_lock_read(&string_table.lock);
+
+    HE_ASSERT(string_id < string_table.strings.count);
+    String result = string_table.strings[string_id];
+
+    platform_unlock_read(&string_table.lock);
+    return result;
+}
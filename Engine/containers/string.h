@@ -3,6 +3,13 @@
 #include "core/defines.h"
 #include "core/memory.h"
 
+#include <string.h>
+#include <type_traits>
+
+#if HE_COMPILER_MSVC
+#include <intrin.h>
+#endif
+
 struct String
 {
     U64 count;
@@ -22,20 +29,128 @@ constexpr U64 comptime_string_length(const char(&)[Count])
     return Count - 1;
 }
 
-template< U64 Count >
-constexpr U64 comptime_string_hash(const char(&str)[Count])
+// full 128 bit product of a and b, low half in a and high half in b.
+HE_FORCE_INLINE constexpr void hash_multiply(U64 *a, U64 *b)
+{
+    if (std::is_constant_evaluated())
+    {
+        U64 lo_lo = (*a & 0xFFFFFFFF) * (*b & 0xFFFFFFFF);
+        U64 hi_lo = (*a >> 32) * (*b & 0xFFFFFFFF);
+        U64 lo_hi = (*a & 0xFFFFFFFF) * (*b >> 32);
+        U64 hi_hi = (*a >> 32) * (*b >> 32);
+        U64 cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+        *a = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+        *b = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+        return;
+    }
+
+#if HE_COMPILER_MSVC
+    *a = _umul128(*a, *b, b);
+#else
+    __uint128_t product = (__uint128_t)*a * *b;
+    *a = (U64)product;
+    *b = (U64)(product >> 64);
+#endif
+}
+
+HE_FORCE_INLINE constexpr U64 hash_mix(U64 a, U64 b)
+{
+    hash_multiply(&a, &b);
+    return a ^ b;
+}
+
+// little endian reads, the constant evaluated path can't reinterpret the chars.
+HE_FORCE_INLINE constexpr U64 hash_read(const char *data, U32 size)
+{
+    if (std::is_constant_evaluated())
+    {
+        U64 result = 0;
+        for (U32 i = 0; i < size; i++)
+        {
+            result |= (U64)(U8)data[i] << (i * 8);
+        }
+        return result;
+    }
+
+    if (size == 8)
+    {
+        U64 result;
+        memcpy(&result, data, sizeof(U64));
+        return result;
+    }
+
+    U32 result;
+    memcpy(&result, data, sizeof(U32));
+    return result;
+}
+
+// wyhash final version 4 with a zero seed, consumes 16 to 48 bytes per round of 64 bit multiplies.
+constexpr U64 hash_string(const char *data, U64 count)
 {
-    const U64 p = 31;
-    const U64 m = U64(1e9) + 7;
+    constexpr U64 secret[] = { 0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull };
+
+    U64 seed = hash_mix(secret[0], secret[1]);
+    U64 a = 0;
+    U64 b = 0;
 
-    U64 hash = 0;
-    U64 multiplier = 1;
-    for (U32 i = 0; i < Count - 1; i++)
+    if (count <= 16)
     {
-        hash = ((hash + (str[i] - 'a' + 1) * multiplier)) % m;
-        multiplier = (multiplier * p) % m;
+        if (count >= 4)
+        {
+            U64 offset = (count >> 3) << 2;
+            a = (hash_read(data, 4) << 32) | hash_read(data + offset, 4);
+            b = (hash_read(data + count - 4, 4) << 32) | hash_read(data + count - 4 - offset, 4);
+        }
+        else if (count > 0)
+        {
+            a = ((U64)(U8)data[0] << 16) | ((U64)(U8)data[count >> 1] << 8) | (U64)(U8)data[count - 1];
+        }
     }
-    return hash;
+    else
+    {
+        const char *p = data;
+        U64 remaining = count;
+
+        if (remaining > 48)
+        {
+            U64 seed1 = seed;
+            U64 seed2 = seed;
+
+            do
+            {
+                seed = hash_mix(hash_read(p, 8) ^ secret[1], hash_read(p + 8, 8) ^ seed);
+                seed1 = hash_mix(hash_read(p + 16, 8) ^ secret[2], hash_read(p + 24, 8) ^ seed1);
+                seed2 = hash_mix(hash_read(p + 32, 8) ^ secret[3], hash_read(p + 40, 8) ^ seed2);
+                p += 48;
+                remaining -= 48;
+            }
+            while (remaining > 48);
+
+            seed ^= seed1 ^ seed2;
+        }
+
+        while (remaining > 16)
+        {
+            seed = hash_mix(hash_read(p, 8) ^ secret[1], hash_read(p + 8, 8) ^ seed);
+            p += 16;
+            remaining -= 16;
+        }
+
+        a = hash_read(p + remaining - 16, 8);
+        b = hash_read(p + remaining - 8, 8);
+    }
+
+    a ^= secret[1];
+    b ^= seed;
+    hash_multiply(&a, &b);
+    return hash_mix(a ^ secret[0] ^ count, b ^ secret[1]);
+}
+
+// same value hash_key returns for the string at runtime.
+template< U64 Count >
+constexpr U64 comptime_string_hash(const char(&str)[Count])
+{
+    return hash_string(str, Count - 1);
 }
 
 String copy_string(const char *str, U64 count, Allocator allocator = {});
@@ -102,6 +217,25 @@ String eat_none_white_space(String *str);
 
 bool contains(String a, String b);
 
+//
+// String Interning
+//
+
+// an interned string is stored once until deinit_string_table and has a stable id so lookups compare integers.
+// id 0 is the empty string.
+typedef U32 String_Id;
+
+bool init_string_table();
+void deinit_string_table();
+
+// thread safe, only takes the table's write lock for strings seen for the first time.
+String_Id intern_string(String str);
+
+// returns 0 when the string was never interned.
+String_Id find_string_id(String str);
+
+String get_string(String_Id string_id);
+
 struct String_Builder
 {
     Memory_Arena *arena;
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "core/defines.h"
+#include "core/memory.h"
+
+#include <atomic>
+
+// Chase-Lev work stealing deque: https://www.di.ens.fr/~zappa/readings/ppopp13.pdf
+// the owner thread pushes and pops at the bottom (LIFO) and any other thread can steal from the top (FIFO).
+template< typename T >
+struct Work_Stealing_Queue
+{
+    static_assert(std::atomic< T >::is_always_lock_free);
+
+    alignas(64) std::atomic< S64 > top;
+    alignas(64) std::atomic< S64 > bottom;
+
+    std::atomic< T > *data;
+    U32 capacity;
+    U32 mask;
+    Allocator allocator;
+};
+
+template< typename T >
+void init(Work_Stealing_Queue< T > *queue, U32 capacity, Allocator allocator = {})
+{
+    HE_ASSERT(queue);
+    HE_ASSERT(capacity);
+
+    if ((capacity & (capacity - 1)) != 0)
+    {
+        U32 new_capacity = 2;
+        capacity--;
+        while (capacity >>= 1)
+        {
+            new_capacity <<= 1;
+        }
+        HE_ASSERT((new_capacity & (new_capacity - 1)) == 0);
+        capacity = new_capacity;
+    }
+
+    if (!allocator.data)
+    {
+        Memory_Context memory_context = grab_memory_context();
+        allocator = memory_context.general_allocator;
+    }
+
+    queue->data = HE_ALLOCATOR_ALLOCATE_ARRAY(allocator, std::atomic< T >, capacity);
+    queue->capacity = capacity;
+    queue->mask = capacity - 1;
+    queue->allocator = allocator;
+    queue->top.store(0, std::memory_order_relaxed);
+    queue->bottom.store(0, std::memory_order_relaxed);
+}
+
+template< typename T >
+void deinit(Work_Stealing_Queue< T > *queue)
+{
+    HE_ASSERT(queue);
+    HE_ALLOCATOR_DEALLOCATE(queue->allocator, (void *)queue->data);
+}
+
+template< typename T >
+U32 count(Work_Stealing_Queue< T > *queue)
+{
+    S64 bottom = queue->bottom.load(std::memory_order_relaxed);
+    S64 top = queue->top.load(std::memory_order_relaxed);
+    return bottom > top ? (U32)(bottom - top) : 0;
+}
+
+template< typename T >
+bool empty(Work_Stealing_Queue< T > *queue)
+{
+    return count(queue) == 0;
+}
+
+// owner thread only.
+template< typename T >
+bool push(Work_Stealing_Queue< T > *queue, const T &item)
+{
+    S64 bottom = queue->bottom.load(std::memory_order_relaxed);
+    S64 top = queue->top.load(std::memory_order_acquire);
+
+    if (bottom - top >= (S64)queue->capacity)
+    {
+        return false;
+    }
+
+    queue->data[bottom & queue->mask].store(item, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    queue->bottom.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+}
+
+// owner thread only.
+template< typename T >
+bool pop(Work_Stealing_Queue< T > *queue, T *out_item)
+{
+    HE_ASSERT(out_item);
+
+    S64 bottom = queue->bottom.load(std::memory_order_relaxed) - 1;
+    queue->bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    S64 top = queue->top.load(std::memory_order_relaxed);
+
+    if (top > bottom)
+    {
+        queue->bottom.store(bottom + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    *out_item = queue->data[bottom & queue->mask].load(std::memory_order_relaxed);
+
+    if (top == bottom)
+    {
+        // last item in the queue we have to race the stealers for it.
+        bool won = queue->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        queue->bottom.store(bottom + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    return true;
+}
+
+// any thread.
+template< typename T >
+bool steal(Work_Stealing_Queue< T > *queue, T *out_item)
+{
+    HE_ASSERT(out_item);
+
+    S64 top = queue->top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    S64 bottom = queue->bottom.load(std::memory_order_acquire);
+
+    if (top >= bottom)
+    {
+        return false;
+    }
+
+    T item = queue->data[top & queue->mask].load(std::memory_order_relaxed);
+    if (!queue->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        return false;
+    }
+
+    *out_item = item;
+    return true;
+}
@@ -28,7 +28,15 @@ bool startup(Engine *engine)
         return false;
     }
 
+    HE_MEMORY_TAG_SCOPE(Memory_Tag::CORE);
+
     init_logging_system();
+
+    bool string_table_inited = init_string_table();
+    if (!string_table_inited)
+    {
+        return false;
+    }
     
     init_cvars(HE_STRING_LITERAL("config.cvars"));
     
@@ -116,8 +124,15 @@ void on_event(Engine *engine, Event event)
 
 void game_loop(Engine *engine, F32 delta_time)
 {
-    Memory_Arena *frame_arena = get_frame_arena();
-    Temprary_Memory frame_temprary_memory = begin_temprary_memory(frame_arena);
+    job_profiler_new_frame();
+    memory_new_frame();
+
+    // nothing is submitted while minimized so once the gpu is idle the current frame memory can be reused.
+    if (engine->is_minimized)
+    {
+        renderer_wait_for_gpu_to_finish_all_work();
+        begin_frame_memory(get_render_context().renderer_state->current_frame_in_flight_index);
+    }
 
     renderer_handle_upload_requests();
     reload_assets();
@@ -128,8 +143,6 @@ void game_loop(Engine *engine, F32 delta_time)
     }
 
     hope_app_on_update(engine, delta_time);
-
-    end_temprary_memory(frame_temprary_memory);
 }
 
 void shutdown(Engine *engine)
@@ -146,5 +159,7 @@ void shutdown(Engine *engine)
 
     deinit_logging_system();
 
+    deinit_string_table();
+
     deinit_memory_system();
 }
\ No newline at end of file
@@ -211,7 +211,7 @@ Read_Entire_File_Result read_entire_file(String path, Allocator allocator)
         return { .success = false, .data = nullptr, .size = 0 };
     }
 
-    U8 *data = HE_ALLOCATOR_ALLOCATE_ARRAY(allocator, U8, open_file_result.size);
+    U8 *data = HE_ALLOCATOR_ALLOCATE_ARRAY_NO_ZERO(allocator, U8, open_file_result.size);
     bool read = platform_read_data_from_file(&open_file_result, 0, data, open_file_result.size);
     if (!read)
     {
@@ -5,379 +5,1549 @@
 #include "memory.h"
 #include "logging.h"
 #include "file_system.h"
+#include "cvars.h"
 
-#include "containers/queue.h"
+#include "containers/work_stealing_queue.h"
+#include "containers/concurrent_queue.h"
 
 #include <atomic>
+#include <algorithm>
+#include <immintrin.h>
 
 #define JOB_COUNT_PER_THREAD 4096
 
+// idle workers spin for spin_count rounds of HE_JOB_SPIN_PAUSE_COUNT pauses before parking on the semaphore.
+#define HE_JOB_MIN_SPIN_COUNT 4
+#define HE_JOB_MAX_SPIN_COUNT 64
+#define HE_JOB_SPIN_PAUSE_COUNT 16
+
+#if HE_JOB_PROFILING
+
+#define HE_JOB_PROFILE_EVENT_COUNT_PER_THREAD 16384
+
+enum class Job_Profile_Event_Type : U8
+{
+    JOB,
+    WAIT
+};
+
+struct Job_Profile_Event
+{
+    const char *name;
+    U64 enqueue_time;
+    U64 start_time;
+    U64 end_time;
+    Job_Profile_Event_Type type;
+};
+
+// written only by its thread, readers may see a partially overwritten event once the buffer wraps which is fine for profiling.
+struct Job_Profile_Event_Buffer
+{
+    Job_Profile_Event *events;
+    std::atomic< U64 > write_index;
+};
+
+#endif
+
 struct Thread_State
 {
     Memory_Arena *arena;
     U32 thread_index;
+    S32 numa_node;
     Thread thread;
 
-    Semaphore job_queue_semaphore;
-    Mutex job_queue_mutex;
-    Mutex dependency_mutex;
+    U32 background_job_depth;
+    U32 spin_count;
+    Work_Stealing_Queue< Job_Handle > job_queues[(U32)Job_Priority::COUNT];
+
+#if HE_JOB_PROFILING
+    Job_Profile_Event_Buffer profile_events;
+#endif
+};
+
+// lock-free free list of job slots, a handle stays valid until its job is released and the slot's generation bumped.
+// a released slot only goes back to the free list once nothing pins it, so a pinned job's counter can't be reset under us.
+struct Job_Pool
+{
+    Job *jobs;
+    std::atomic< U32 > *generations;
+    std::atomic< U32 > *slot_states; // HE_JOB_SLOT_LIVE or HE_JOB_SLOT_RELEASED plus the pin count.
+    std::atomic< U32 > *next_free_indices;
+    U32 capacity;
+
+    // low 32 bits are the first free index, high 32 bits are a tag bumped on every change to avoid ABA.
+    alignas(64) std::atomic< U64 > first_free;
+};
+
+#define HE_JOB_POOL_EMPTY 0xFFFFFFFF
+
+#define HE_JOB_SLOT_LIVE 0x80000000
+#define HE_JOB_SLOT_RELEASED 0x40000000
+
+static void init(Job_Pool *job_pool, U32 capacity, Allocator allocator)
+{
+    job_pool->jobs = HE_ALLOCATOR_ALLOCATE_ARRAY(allocator, Job, capacity);
+    job_pool->generations = HE_ALLOCATOR_ALLOCATE_ARRAY(allocator, std::atomic< U32 >, capacity);
+    job_pool->slot_states = HE_ALLOCATOR_ALLOCATE_ARRAY(allocator, std::atomic< U32 >, capacity);
+    job_pool->next_free_indices = HE_ALLOCATOR_ALLOCATE_ARRAY(allocator, std::atomic< U32 >, capacity);
+    job_pool->capacity = capacity;
+
+    for (U32 slot_index = 0; slot_index < capacity; slot_index++)
+    {
+        job_pool->generations[slot_index].store(0, std::memory_order_relaxed);
+        job_pool->slot_states[slot_index].store(0, std::memory_order_relaxed);
+        job_pool->next_free_indices[slot_index].store(slot_index + 1 < capacity ? slot_index + 1 : HE_JOB_POOL_EMPTY, std::memory_order_relaxed);
+    }
+
+    job_pool->first_free.store(0);
+}
+
+static Job_Handle acquire_handle(Job_Pool *job_pool)
+{
+    U64 first_free = job_pool->first_free.load(std::memory_order_acquire);
+    U32 index;
+
+    do
+    {
+        index = (U32)first_free;
+        HE_ASSERT(index != HE_JOB_POOL_EMPTY);
+
+        // may read a stale next index if another thread popped this slot in between, the tag makes the exchange fail then.
+        U64 next = job_pool->next_free_indices[index].load(std::memory_order_relaxed);
+        U64 tag = (first_free >> 32) + 1;
+
+        if (job_pool->first_free.compare_exchange_weak(first_free, (tag << 32) | next, std::memory_order_acquire))
+        {
+            break;
+        }
+    }
+    while (true);
+
+    // added rather than stored since a stale pin may still be in flight, it sees the generation mismatch and drops itself.
+    job_pool->slot_states[index].fetch_add(HE_JOB_SLOT_LIVE);
+
+    return { .index = (S32)index, .generation = job_pool->generations[index].load(std::memory_order_relaxed) };
+}
+
+static void push_free_slot(Job_Pool *job_pool, U32 index)
+{
+    U64 first_free = job_pool->first_free.load(std::memory_order_relaxed);
+    U64 new_first_free;
+
+    do
+    {
+        job_pool->next_free_indices[index].store((U32)first_free, std::memory_order_relaxed);
+        U64 tag = (first_free >> 32) + 1;
+        new_first_free = (tag << 32) | index;
+    }
+    while (!job_pool->first_free.compare_exchange_weak(first_free, new_first_free, std::memory_order_release, std::memory_order_relaxed));
+}
+
+// whoever drops the last reference to a released slot frees it, the exchange makes sure only one of them does.
+static void try_free_slot(Job_Pool *job_pool, U32 index)
+{
+    U32 released = HE_JOB_SLOT_RELEASED;
+    if (job_pool->slot_states[index].compare_exchange_strong(released, 0))
+    {
+        push_free_slot(job_pool, index);
+    }
+}
+
+static void release_handle(Job_Pool *job_pool, Job_Handle handle)
+{
+    U32 index = (U32)handle.index;
+    job_pool->generations[index].fetch_add(1);
+
+    U32 slot_state = job_pool->slot_states[index].fetch_add(HE_JOB_SLOT_RELEASED - HE_JOB_SLOT_LIVE) + HE_JOB_SLOT_RELEASED - HE_JOB_SLOT_LIVE;
+    if (slot_state == HE_JOB_SLOT_RELEASED)
+    {
+        try_free_slot(job_pool, index);
+    }
+}
+
+// keeps the slot from being reused until it's unpinned, fails if the job was already released.
+// the pin is taken before the generation is checked so release_handle either sees the pin or we see the new generation.
+static bool pin_handle(Job_Pool *job_pool, Job_Handle handle)
+{
+    U32 index = (U32)handle.index;
+    job_pool->slot_states[index].fetch_add(1);
+
+    if (job_pool->generations[index].load() == handle.generation)
+    {
+        return true;
+    }
+
+    if (job_pool->slot_states[index].fetch_sub(1) - 1 == HE_JOB_SLOT_RELEASED)
+    {
+        try_free_slot(job_pool, index);
+    }
+
+    return false;
+}
+
+static void unpin_handle(Job_Pool *job_pool, Job_Handle handle)
+{
+    U32 index = (U32)handle.index;
+    if (job_pool->slot_states[index].fetch_sub(1) - 1 == HE_JOB_SLOT_RELEASED)
+    {
+        try_free_slot(job_pool, index);
+    }
+}
+
+static bool is_valid_handle(Job_Pool *job_pool, Job_Handle handle)
+{
+    return handle.index >= 0 && (U32)handle.index < job_pool->capacity && job_pool->generations[handle.index].load() == handle.generation;
+}
+
+static Job *get(Job_Pool *job_pool, Job_Handle handle)
+{
+    HE_ASSERT(is_valid_handle(job_pool, handle));
+    return &job_pool->jobs[handle.index];
+}
+
+struct Job_System_State
+{
+    std::atomic< bool > running;
+    std::atomic< U32 > in_progress_job_count;
+    std::atomic< U32 > sleeping_thread_count;
+    std::atomic< U32 > spinning_thread_count;
+
+    U32 max_background_thread_count;
+    std::atomic< U32 > background_job_count;
+
+    // bumped whenever a job is scheduled or finished so threads blocked in wait_for_* can re-check their condition.
+    std::atomic< U32 > job_event_count;
+    std::atomic< U32 > waiting_thread_count;
+
+    Free_List_Allocator job_data_allocator;
+
+    U32 thread_count;
+    Thread_State *thread_states; // thread_count worker threads followed by the main thread.
+
+    bool pin_worker_threads;
+    bool one_worker_per_physical_core;
+    bool has_cpu_topology;
+    CPU_Topology cpu_topology;
+
+    // jobs scheduled from threads that don't own a job queue (file watcher thread, ...).
+    Concurrent_Queue< Job_Handle > submission_queues[(U32)Job_Priority::COUNT];
+    Semaphore job_semaphore;
+
+    Job_Pool job_pool;
+
+#if HE_JOB_PROFILING
+    std::atomic< bool > profiling;
+    bool profiling_before_capture;
+    U64 performance_frequency;
+
+    U64 frame_start_time;
+    U64 last_frame_start_time;
+
+    U32 capture_frame_count; // frames left to capture, zero if not capturing.
+    U64 capture_start_time;
+    String capture_path;
+#endif
+};
+
+static Job_System_State job_system_state;
+static thread_local Thread_State *current_thread_state;
+
+#if HE_JOB_PROFILING
+
+static void record_job_profile_event(Thread_State *thread_state, Job_Profile_Event_Type type, const char *name, U64 enqueue_time, U64 start_time, U64 end_time)
+{
+    Job_Profile_Event_Buffer *buffer = &thread_state->profile_events;
+    U64 write_index = buffer->write_index.load(std::memory_order_relaxed);
+
+    Job_Profile_Event *event = &buffer->events[write_index & (HE_JOB_PROFILE_EVENT_COUNT_PER_THREAD - 1)];
+    event->name = name;
+    event->enqueue_time = enqueue_time ? enqueue_time : start_time;
+    event->start_time = start_time;
+    event->end_time = end_time;
+    event->type = type;
+
+    buffer->write_index.store(write_index + 1, std::memory_order_release);
+}
+
+#endif
+
+static void signal_job_event()
+{
+    job_system_state.job_event_count.fetch_add(1);
+
+    if (job_system_state.waiting_thread_count.load())
+    {
+        job_system_state.job_event_count.notify_all();
+    }
+}
+
+// releases up to job_count parked workers with a single semaphore signal, spinning workers will pick up jobs on their own.
+static void wake_threads(U32 job_count)
+{
+    // pairs with the fence in execute_thread_work: either a parking thread sees the jobs or we see the parking thread.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    U32 spinning_thread_count = job_system_state.spinning_thread_count.load(std::memory_order_relaxed);
+    if (job_count <= spinning_thread_count)
+    {
+        return;
+    }
+
+    U32 sleeping_thread_count = job_system_state.sleeping_thread_count.load(std::memory_order_relaxed);
+    U32 wake_count = HE_MIN(job_count - spinning_thread_count, sleeping_thread_count);
+    if (wake_count)
+    {
+        bool signaled = platform_signal_semaphore(&job_system_state.job_semaphore, wake_count);
+        HE_ASSERT(signaled);
+    }
+}
+
+static void schedule_jobs(const Job_Handle *job_handles, U32 job_count)
+{
+    Thread_State *thread_state = current_thread_state;
+
+    for (U32 job_index = 0; job_index < job_count; job_index++)
+    {
+        Job_Handle job_handle = job_handles[job_index];
+        Job *job = get(&job_system_state.job_pool, job_handle);
+        U32 priority = (U32)job->data.priority;
+
+#if HE_JOB_PROFILING
+        job->enqueue_time = job_system_state.profiling.load(std::memory_order_relaxed) ? platform_get_performance_counter() : 0;
+#endif
+
+        if (!thread_state || !push(&thread_state->job_queues[priority], job_handle))
+        {
+            bool pushed = push(&job_system_state.submission_queues[priority], job_handle);
+            HE_ASSERT(pushed);
+        }
+    }
+
+    wake_threads(job_count);
+    signal_job_event();
+}
+
+HE_FORCE_INLINE static void schedule_job(Job_Handle job_handle)
+{
+    schedule_jobs(&job_handle, 1);
+}
+
+static bool find_job_with_priority(Thread_State *thread_state, U32 priority, Job_Handle *out_job_handle)
+{
+    if (thread_state && pop(&thread_state->job_queues[priority], out_job_handle))
+    {
+        return true;
+    }
+
+    if (pop(&job_system_state.submission_queues[priority], out_job_handle))
+    {
+        return true;
+    }
+
+    U32 thread_count = job_system_state.thread_count + 1;
+    U32 first_victim_index = thread_state ? thread_state->thread_index + 1 : 0;
+
+    for (U32 victim_offset = 0; victim_offset < thread_count; victim_offset++)
+    {
+        Thread_State *victim_thread_state = &job_system_state.thread_states[(first_victim_index + victim_offset) % thread_count];
+        if (victim_thread_state == thread_state)
+        {
+            continue;
+        }
+
+        if (steal(&victim_thread_state->job_queues[priority], out_job_handle))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool reserve_background_job_slot()
+{
+    U32 background_job_count = job_system_state.background_job_count.load();
+
+    while (background_job_count < job_system_state.max_background_thread_count)
+    {
+        if (job_system_state.background_job_count.compare_exchange_weak(background_job_count, background_job_count + 1))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool has_queued_background_jobs()
+{
+    U32 priority = (U32)Job_Priority::BACKGROUND;
+    if (!empty(&job_system_state.submission_queues[priority]))
+    {
+        return true;
+    }
+
+    for (U32 thread_index = 0; thread_index < job_system_state.thread_count + 1; thread_index++)
+    {
+        if (!empty(&job_system_state.thread_states[thread_index].job_queues[priority]))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// a thread that failed to reserve a slot goes back to sleep, so whoever gives a slot back
+// has to wake a worker if background jobs are still queued or they would wait for unrelated work.
+static void release_background_job_slot()
+{
+    job_system_state.background_job_count.fetch_sub(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (has_queued_background_jobs())
+    {
+        wake_threads(1);
+    }
+}
+
+// higher priorities are always drained first, background jobs are capped to max_background_thread_count
+// unless ignore_background_cap is set for threads that are already inside a background job.
+static bool find_job(Thread_State *thread_state, Job_Handle *out_job_handle, Job_Priority lowest_priority, bool ignore_background_cap = false)
+{
+    for (U32 priority = 0; priority <= (U32)lowest_priority; priority++)
+    {
+        if (priority != (U32)Job_Priority::BACKGROUND)
+        {
+            if (find_job_with_priority(thread_state, priority, out_job_handle))
+            {
+                return true;
+            }
+
+            continue;
+        }
+
+        if (ignore_background_cap)
+        {
+            job_system_state.background_job_count.fetch_add(1);
+        }
+        else if (!reserve_background_job_slot())
+        {
+            return false;
+        }
+
+        if (find_job_with_priority(thread_state, priority, out_job_handle))
+        {
+            return true;
+        }
+
+        release_background_job_slot();
+    }
+
+    return false;
+}
+
+#define HE_JOB_COUNTER_EMPTY -1
+#define HE_JOB_COUNTER_CLOSED -2
+
+static Job_Handle get_job_handle(S32 job_index)
+{
+    return { .index = job_index, .generation = job_system_state.job_pool.generations[job_index].load() };
+}
+
+// returns false if the counter already hit zero.
+static bool add_waiting_job(Job_Counter *counter, Job_Handle job_handle)
+{
+    Job *job = get(&job_system_state.job_pool, job_handle);
+    S32 first_waiting_job_index = counter->first_waiting_job_index.load();
+
+    do
+    {
+        if (first_waiting_job_index == HE_JOB_COUNTER_CLOSED)
+        {
+            return false;
+        }
+
+        job->next_waiting_job_index = first_waiting_job_index;
+    }
+    while (!counter->first_waiting_job_index.compare_exchange_weak(first_waiting_job_index, job_handle.index));
+
+    return true;
+}
+
+// the counter of a job dependency is returned with the job pinned so the slot can't be handed to another job and its
+// counter reset while we link into it, out_pinned_handle is invalid for wait_for_counter which the caller owns.
+static Job_Counter *pin_dependency_counter(Job *job, U32 dependency_index, Job_Handle *out_pinned_handle)
+{
+    *out_pinned_handle = Resource_Pool< Job >::invalid_handle;
+
+    if (job->wait_for_counter)
+    {
+        if (dependency_index == 0)
+        {
+            return job->wait_for_counter;
+        }
+
+        dependency_index--;
+    }
+
+    Job_Handle dependency_handle = { job->wait_for_jobs[dependency_index].index, job->wait_for_jobs[dependency_index].generation };
+
+    // finished jobs are released back to the pool so a job we can't pin is a finished one.
+    if (!pin_handle(&job_system_state.job_pool, dependency_handle))
+    {
+        return nullptr;
+    }
+
+    *out_pinned_handle = dependency_handle;
+    return &job_system_state.job_pool.jobs[dependency_handle.index].counter;
+}
+
+static void abort_job(Job_Handle job_handle);
+
+// links the job into the counter of its next unfinished dependency or schedules it if there are none left.
+static void wait_for_next_dependency(Job_Handle job_handle)
+{
+    Job *job = get(&job_system_state.job_pool, job_handle);
+    U32 dependency_count = job->wait_for_job_count + (job->wait_for_counter ? 1 : 0);
+
+    while (job->next_dependency_index < dependency_count)
+    {
+        Job_Handle pinned_handle = {};
+        Job_Counter *counter = pin_dependency_counter(job, job->next_dependency_index++, &pinned_handle);
+        if (!counter)
+        {
+            continue;
+        }
+
+        // once linked the job may be scheduled and finished by another thread so it can't be touched anymore.
+        bool added = add_waiting_job(counter, job_handle);
+        bool failed = !added && counter->failed.load();
+
+        if (pinned_handle.index != -1)
+        {
+            unpin_handle(&job_system_state.job_pool, pinned_handle);
+        }
+
+        if (added)
+        {
+            return;
+        }
+
+        if (failed)
+        {
+            abort_job(job_handle);
+            return;
+        }
+    }
+
+    schedule_job(job_handle);
+}
+
+static void signal_job_counter(Job_Counter *counter, bool failed)
+{
+    if (failed)
+    {
+        counter->failed.store(true);
+    }
+
+    if (counter->value.fetch_sub(1) != 1)
+    {
+        return;
+    }
+
+    failed = counter->failed.load();
+
+    S32 job_index = counter->first_waiting_job_index.exchange(HE_JOB_COUNTER_CLOSED);
+    while (job_index >= 0)
+    {
+        Job_Handle job_handle = get_job_handle(job_index);
+        job_index = get(&job_system_state.job_pool, job_handle)->next_waiting_job_index;
+
+        if (failed)
+        {
+            abort_job(job_handle);
+        }
+        else
+        {
+            wait_for_next_dependency(job_handle);
+        }
+    }
+}
+
+static void finalize_job(Job_Handle job_handle, Job_Result result);
+
+static void finalize_batch_job(Job_Handle job_handle, Job_Result result)
+{
+    Job *job = get(&job_system_state.job_pool, job_handle);
+    Job_Handle join_job_handle = { job->join_job.index, job->join_job.generation };
+    Job *join_job = get(&job_system_state.job_pool, join_job_handle);
+    Job_Counter *signal_counter = job->data.signal_counter;
+
+    if (result != Job_Result::SUCCEEDED)
+    {
+        std::atomic_store((std::atomic<bool>*)&join_job->failed, true);
+    }
+
+    // batch jobs aren't visible to the caller so no one can depend on them and their data is owned by the join job.
+    release_handle(&job_system_state.job_pool, job_handle);
+
+    if (signal_counter)
+    {
+        signal_job_counter(signal_counter, result != Job_Result::SUCCEEDED);
+    }
+
+    U32 old_value = std::atomic_fetch_sub((std::atomic<U32>*)&join_job->remaining_job_count, 1);
+    if (old_value == 1)
+    {
+        Job_Result join_result = std::atomic_load((std::atomic<bool>*)&join_job->failed) ? Job_Result::FAILED : Job_Result::SUCCEEDED;
+        finalize_job(join_job_handle, join_result);
+        job_system_state.in_progress_job_count.fetch_sub(1);
+    }
+}
+
+static void finalize_job(Job_Handle job_handle, Job_Result result)
+{
+    Job *job = get(&job_system_state.job_pool, job_handle);
+
+    if (job->join_job.index != -1)
+    {
+        finalize_batch_job(job_handle, result);
+        return;
+    }
+
+    bool failed = result != Job_Result::SUCCEEDED;
+    Job_Counter *signal_counter = job->data.signal_counter;
+
+    void *parameters_data = job->data.parameters.data;
+    if (parameters_data && parameters_data != job->inline_parameters)
+    {
+        deallocate(&job_system_state.job_data_allocator, parameters_data);
+    }
+
+    if (job->wait_for_jobs != job->inline_wait_for_jobs)
+    {
+        deallocate(&job_system_state.job_data_allocator, job->wait_for_jobs);
+    }
+
+    signal_job_counter(&job->counter, failed);
+    release_handle(&job_system_state.job_pool, job_handle);
+
+    if (signal_counter)
+    {
+        signal_job_counter(signal_counter, failed);
+    }
+}
+
+// jobs that depend on a failed job are never executed.
+static void abort_job(Job_Handle job_handle)
+{
+    finalize_job(job_handle, Job_Result::ABORTED);
+    job_system_state.in_progress_job_count.fetch_sub(1);
+}
+
+static void run_job(Thread_State *thread_state, Job_Handle job_handle)
+{
+    Job *job = get(&job_system_state.job_pool, job_handle);
+    HE_ASSERT(job->data.proc);
+
+    bool is_background_job = job->data.priority == Job_Priority::BACKGROUND;
+    if (is_background_job)
+    {
+        thread_state->background_job_depth++;
+    }
+
+#if HE_JOB_PROFILING
+    bool profiling = job_system_state.profiling.load(std::memory_order_relaxed);
+    U64 start_time = profiling ? platform_get_performance_counter() : 0;
+#endif
+
+    Temprary_Memory temprary_memory = begin_temprary_memory(thread_state->arena);
+    job->data.parameters.arena = thread_state->arena;
+
+    Job_Result result = job->data.proc(job->data.parameters);
+    if (job->data.completed_proc)
+    {
+        job->data.completed_proc(result);
+    }
+
+    end_temprary_memory(temprary_memory);
+
+#if HE_JOB_PROFILING
+    if (profiling)
+    {
+        const char *name = job->data.name ? job->data.name : "job";
+        record_job_profile_event(thread_state, Job_Profile_Event_Type::JOB, name, job->enqueue_time, start_time, platform_get_performance_counter());
+    }
+#endif
+
+    finalize_job(job_handle, result);
+
+    if (is_background_job)
+    {
+        thread_state->background_job_depth--;
+        release_background_job_slot();
+    }
+
+    job_system_state.in_progress_job_count.fetch_sub(1);
+
+    signal_job_event();
+}
+
+// the spin budget doubles when spinning finds a job and halves when it doesn't, so bursts of short jobs
+// don't pay the semaphore wake up latency and idle workers quickly stop burning cpu.
+static bool spin_for_job(Thread_State *thread_state, Job_Handle *out_job_handle)
+{
+    job_system_state.spinning_thread_count.fetch_add(1);
+
+    bool found = false;
+    for (U32 spin_index = 0; spin_index < thread_state->spin_count && job_system_state.running.load(std::memory_order_relaxed); spin_index++)
+    {
+        for (U32 pause_index = 0; pause_index < HE_JOB_SPIN_PAUSE_COUNT; pause_index++)
+        {
+            _mm_pause();
+        }
+
+        if (find_job(thread_state, out_job_handle, Job_Priority::BACKGROUND))
+        {
+            found = true;
+            break;
+        }
+    }
+
+    job_system_state.spinning_thread_count.fetch_sub(1);
+
+    if (found)
+    {
+        thread_state->spin_count = HE_MIN(thread_state->spin_count * 2, (U32)HE_JOB_MAX_SPIN_COUNT);
+    }
+    else
+    {
+        thread_state->spin_count = HE_MAX(thread_state->spin_count / 2, (U32)HE_JOB_MIN_SPIN_COUNT);
+    }
+
+    return found;
+}
+
+unsigned long execute_thread_work(void *params)
+{
+    Thread_State *thread_state = (Thread_State *)params;
+    current_thread_state = thread_state;
+
+    bool thread_context_inited = init_thread_context((S32)thread_state->thread_index, thread_state->numa_node);
+    HE_ASSERT(thread_context_inited);
+    thread_state->arena = get_thread_arena();
+
+    while (true)
+    {
+        Job_Handle job_handle = Resource_Pool< Job >::invalid_handle;
+
+        if (find_job(thread_state, &job_handle, Job_Priority::BACKGROUND) || spin_for_job(thread_state, &job_handle))
+        {
+            run_job(thread_state, job_handle);
+            continue;
+        }
+
+        job_system_state.sleeping_thread_count.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (find_job(thread_state, &job_handle, Job_Priority::BACKGROUND))
+        {
+            job_system_state.sleeping_thread_count.fetch_sub(1);
+            run_job(thread_state, job_handle);
+            continue;
+        }
+
+        if (!job_system_state.running)
+        {
+            job_system_state.sleeping_thread_count.fetch_sub(1);
+            break;
+        }
+
+        // gives back what a spike committed before parking.
+        trim_thread_memory();
+
+        bool signaled = platform_wait_for_semaphore(&job_system_state.job_semaphore);
+        HE_ASSERT(signaled);
+
+        job_system_state.sleeping_thread_count.fetch_sub(1);
+    }
+
+    deinit_thread_context();
+    return 0;
+}
+
+struct Worker_Placement
+{
+    U16 processor_group;
+    U64 logical_processor_mask;
+    S32 numa_node;
+};
+
+// workers are spread over the physical cores before they share a core with an smt sibling, the first core is left to the main thread.
+static Worker_Placement get_worker_placement(U32 worker_index)
+{
+    const CPU_Topology &topology = job_system_state.cpu_topology;
+    U32 slot_index = worker_index + 1;
+    const CPU_Core &core = topology.cores[slot_index % topology.physical_core_count];
+
+    Worker_Placement placement =
+    {
+        .processor_group = core.processor_group,
+        .logical_processor_mask = core.logical_processor_mask,
+        .numa_node = (S32)core.numa_node
+    };
+
+    if (job_system_state.one_worker_per_physical_core)
+    {
+        return placement;
+    }
+
+    U32 sibling_count = 0;
+    for (U64 mask = core.logical_processor_mask; mask; mask &= mask - 1)
+    {
+        sibling_count++;
+    }
+
+    U32 sibling_index = (slot_index / topology.physical_core_count) % sibling_count;
+    U64 mask = core.logical_processor_mask;
+    for (U32 skipped = 0; skipped < sibling_index; skipped++)
+    {
+        mask &= mask - 1;
+    }
+
+    placement.logical_processor_mask = mask & (~mask + 1);
+    return placement;
+}
+
+bool init_job_system(U32 thread_count)
+{
+    Memory_Context memory_context = grab_memory_context();
+
+    bool inited = init_free_list_allocator(&job_system_state.job_data_allocator, nullptr, HE_MEGA_BYTES(64), HE_MEGA_BYTES(64), "job_allocator", Memory_Tag::JOBS);
+    HE_ASSERT(inited);
+
+    bool &pin_worker_threads = job_system_state.pin_worker_threads;
+    bool &one_worker_per_physical_core = job_system_state.one_worker_per_physical_core;
+    pin_worker_threads = true;
+    one_worker_per_physical_core = false;
+    HE_DECLARE_CVAR("job_system", pin_worker_threads, CVarFlag_None);
+    HE_DECLARE_CVAR("job_system", one_worker_per_physical_core, CVarFlag_None);
+
+    CPU_Topology *cpu_topology = &job_system_state.cpu_topology;
+    job_system_state.has_cpu_topology = platform_get_cpu_topology(cpu_topology);
+    if (job_system_state.has_cpu_topology)
+    {
+        HE_LOG(Core, Trace, "cpu topology: %u logical processors, %u physical cores, %u numa nodes\n", cpu_topology->logical_processor_count, cpu_topology->physical_core_count, cpu_topology->numa_node_count);
+    }
+    else
+    {
+        pin_worker_threads = false;
+        one_worker_per_physical_core = false;
+    }
+
+    if (!thread_count)
+    {
+        thread_count = get_job_thread_count();
+        if (one_worker_per_physical_core)
+        {
+            thread_count = cpu_topology->physical_core_count > 1 ? cpu_topology->physical_core_count - 1 : 1;
+        }
+    }
+    HE_ASSERT(thread_count);
+
+    job_system_state.running.store(true);
+    job_system_state.in_progress_job_count.store(0);
+    job_system_state.sleeping_thread_count.store(0);
+    job_system_state.spinning_thread_count.store(0);
+    job_system_state.thread_count = thread_count;
+    job_system_state.job_event_count.store(0);
+    job_system_state.waiting_thread_count.store(0);
+
+#if HE_JOB_PROFILING
+    job_system_state.profiling.store(false);
+    job_system_state.performance_frequency = platform_get_performance_frequency();
+    job_system_state.frame_start_time = platform_get_performance_counter();
+    job_system_state.last_frame_start_time = job_system_state.frame_start_time;
+    job_system_state.capture_frame_count = 0;
+#endif
+    job_system_state.thread_states = HE_ALLOCATOR_ALLOCATE_ARRAY(memory_context.permenent_allocator, Thread_State, thread_count + 1);
+
+    init(&job_system_state.job_pool, thread_count * JOB_COUNT_PER_THREAD, memory_context.permenent_allocator);
+    for (U32 priority = 0; priority < (U32)Job_Priority::COUNT; priority++)
+    {
+        init(&job_system_state.submission_queues[priority], thread_count * JOB_COUNT_PER_THREAD, memory_context.permenent_allocator);
+    }
+
+    // leave at least one worker for frame critical work by default.
+    U32 &max_background_thread_count = job_system_state.max_background_thread_count;
+    max_background_thread_count = thread_count > 1 ? thread_count - 1 : 1;
+    HE_DECLARE_CVAR("job_system", max_background_thread_count, CVarFlag_None);
+    max_background_thread_count = HE_CLAMP(max_background_thread_count, 1u, thread_count);
+    job_system_state.background_job_count.store(0);
+
+    bool job_semaphore_created = platform_create_semaphore(&job_system_state.job_semaphore);
+    HE_ASSERT(job_semaphore_created);
+
+    for (U32 thread_index = 0; thread_index < thread_count; thread_index++)
+    {
+        Thread_State *thread_state = &job_system_state.thread_states[thread_index];
+        thread_state->thread_index = thread_index;
+        thread_state->spin_count = HE_JOB_MIN_SPIN_COUNT;
+
+        for (U32 priority = 0; priority < (U32)Job_Priority::COUNT; priority++)
+        {
+            init(&thread_state->job_queues[priority], JOB_COUNT_PER_THREAD, memory_context.permenent_allocator);
+        }
+
+#if HE_JOB_PROFILING
+        thread_state->profile_events.events = HE_ALLOCATOR_ALLOCATE_ARRAY(memory_context.permenent_allocator, Job_Profile_Event, HE_JOB_PROFILE_EVENT_COUNT_PER_THREAD);
+        thread_state->profile_events.write_index.store(0);
+#endif
 
-    Ring_Queue< Job_Handle > job_queue;
-};
+        // the worker creates its thread context as soon as it starts so the numa node has to be known before the affinity is set.
+        Worker_Placement placement = {};
+        thread_state->numa_node = -1;
+        if (pin_worker_threads)
+        {
+            placement = get_worker_placement(thread_index);
+            thread_state->numa_node = cpu_topology->numa_node_count > 1 ? placement.numa_node : -1;
+        }
 
-struct Job_System_State
-{
-    std::atomic< bool > running;
-    std::atomic< U32 > in_progress_job_count;
+        bool thread_created_and_started = platform_create_and_start_thread(&thread_state->thread, execute_thread_work, thread_state, "HopeWorkerThread");
+        HE_ASSERT(thread_created_and_started);
 
-    Free_List_Allocator job_data_allocator;
+        if (pin_worker_threads && !platform_set_thread_affinity(&thread_state->thread, placement.processor_group, placement.logical_processor_mask))
+        {
+            HE_LOG(Core, Warn, "init_job_system -- failed to set the affinity of worker thread %u\n", thread_index);
+        }
+    }
 
-    U32 thread_count;
-    Thread_State *thread_states;
+    // the main thread owns a job queue as well and executes jobs while waiting for them to finish.
+    Thread_State *main_thread_state = &job_system_state.thread_states[thread_count];
+    main_thread_state->thread_index = thread_count;
+    main_thread_state->arena = get_thread_arena();
+    for (U32 priority = 0; priority < (U32)Job_Priority::COUNT; priority++)
+    {
+        init(&main_thread_state->job_queues[priority], JOB_COUNT_PER_THREAD, memory_context.permenent_allocator);
+    }
 
-    Resource_Pool< Job > job_pool;
-};
+#if HE_JOB_PROFILING
+    main_thread_state->profile_events.events = HE_ALLOCATOR_ALLOCATE_ARRAY(memory_context.permenent_allocator, Job_Profile_Event, HE_JOB_PROFILE_EVENT_COUNT_PER_THREAD);
+    main_thread_state->profile_events.write_index.store(0);
+#endif
+    current_thread_state = main_thread_state;
 
-static Job_System_State job_system_state;
+    return true;
+}
 
-static void schedule_job_to_least_worked_thread(Job_Handle job_handle)
+void deinit_job_system()
 {
-    Thread_State *least_worked_thread_state = nullptr;
-    U32 least_worked_thread_index = 0;
-    U32 least_work_count_so_far = HE_MAX_U32;
+    wait_for_all_jobs_to_finish();
+    job_system_state.running.store(false);
+
+    // every worker either sees running is false before parking or gets released here.
+    bool signaled = platform_signal_semaphore(&job_system_state.job_semaphore, job_system_state.thread_count);
+    HE_ASSERT(signaled);
 
     for (U32 thread_index = 0; thread_index < job_system_state.thread_count; thread_index++)
     {
         Thread_State *thread_state = &job_system_state.thread_states[thread_index];
-
-        platform_lock_mutex(&thread_state->job_queue_mutex);
-        U32 job_count_in_queue = count(&thread_state->job_queue);
-        if (job_count_in_queue < least_work_count_so_far)
-        {
-            least_worked_thread_index = thread_index;
-            least_worked_thread_state = thread_state;
-            least_work_count_so_far = job_count_in_queue;
-        }
-        platform_unlock_mutex(&thread_state->job_queue_mutex);
+        bool joined = platform_join_thread(&thread_state->thread);
+        HE_ASSERT(joined);
     }
 
-    HE_ASSERT(least_worked_thread_state);
+    current_thread_state = nullptr;
+    job_system_state.thread_count = 0;
+}
 
-    platform_lock_mutex(&least_worked_thread_state->job_queue_mutex);
-    S32 index = push(&least_worked_thread_state->job_queue, job_handle);
-    HE_ASSERT(index != -1);
-    platform_unlock_mutex(&least_worked_thread_state->job_queue_mutex);
+static void init_job_counter_value(Job_Counter *counter, U32 count)
+{
+    counter->value.store(count);
+    counter->failed.store(false);
+    counter->first_waiting_job_index.store(count ? HE_JOB_COUNTER_EMPTY : HE_JOB_COUNTER_CLOSED);
+}
 
-    bool signaled = platform_signal_semaphore(&least_worked_thread_state->job_queue_semaphore);
-    HE_ASSERT(signaled);
+static U16 get_job_parameters_alignment(const Job_Parameters &parameters)
+{
+    return parameters.alignment ? parameters.alignment : HE_DEFAULT_ALIGNMENT;
 }
 
-static void terminate_job(Job_Handle job_handle)
+static bool fits_in_inline_parameters(const Job_Parameters &parameters)
 {
-    job_system_state.in_progress_job_count.fetch_sub(1);
+    return parameters.size <= HE_JOB_INLINE_PARAMETERS_SIZE && get_job_parameters_alignment(parameters) <= HE_JOB_INLINE_PARAMETERS_ALIGNMENT;
+}
 
-    Job *job = get(&job_system_state.job_pool, job_handle);
+static void init_job(Job *job, Job_Data job_data)
+{
+    job->data = job_data;
 
-    for (Job_Ref dependent_job_ref : job->dependent_jobs)
+    if (job_data.parameters.data)
     {
-        Job_Handle dependent_job_handle = { .index = dependent_job_ref.index, .generation = dependent_job_ref.generation };
-        if (is_valid_handle(&job_system_state.job_pool, dependent_job_handle))
+        void *data = nullptr;
+        if (fits_in_inline_parameters(job_data.parameters))
+        {
+            data = job->inline_parameters;
+        }
+        else
         {
-            terminate_job(dependent_job_handle);
+            data = allocate(&job_system_state.job_data_allocator, job_data.parameters.size, get_job_parameters_alignment(job_data.parameters), AllocationFlag_NoZero);
         }
+        copy_memory(data, job_data.parameters.data, job_data.parameters.size);
+        job->data.parameters.data = data;
     }
 
-    release_handle(&job_system_state.job_pool, job_handle);
+    init_job_counter_value(&job->counter, 1);
+    job->wait_for_counter = nullptr;
+    job->wait_for_jobs = job->inline_wait_for_jobs;
+    job->wait_for_job_count = 0;
+    job->next_dependency_index = 0;
+    job->join_job = { .index = -1, .generation = 0 };
 }
 
-static void finalize_job(Job_Handle job_handle, Job_Result result)
+static Job_Handle internal_execute_job(Job_Data job_data, Array_View< Job_Handle > wait_for_jobs, Job_Counter *wait_for_counter)
 {
+    Job_Handle job_handle = acquire_handle(&job_system_state.job_pool);
     Job *job = get(&job_system_state.job_pool, job_handle);
-    platform_lock_mutex(&job->dependent_jobs_mutex);
+    init_job(job, job_data);
 
-    std::atomic_store((std::atomic<bool>*)&job->finished, true);
+    if (wait_for_jobs.count > HE_JOB_INLINE_DEPENDENCY_COUNT)
+    {
+        job->wait_for_jobs = HE_ALLOCATE_ARRAY_NO_ZERO(&job_system_state.job_data_allocator, Job_Ref, wait_for_jobs.count);
+    }
 
-    for (Job_Ref job_ref : job->dependent_jobs)
+    job->wait_for_counter = wait_for_counter;
+    for (Job_Handle wait_for_job_handle : wait_for_jobs)
     {
-        Job_Handle dependent_job_handle = { job_ref.index, job_ref.generation };
-        if (!is_valid_handle(&job_system_state.job_pool, dependent_job_handle))
+        if (wait_for_job_handle.index != -1)
         {
-            continue;
+            job->wait_for_jobs[job->wait_for_job_count++] = { .index = wait_for_job_handle.index, .generation = wait_for_job_handle.generation };
         }
+    }
 
-        Job *dependent_job = get(&job_system_state.job_pool, dependent_job_handle);
+    job_system_state.in_progress_job_count.fetch_add(1);
+    wait_for_next_dependency(job_handle);
 
-        if (result == Job_Result::SUCCEEDED)
-        {
-            U32 old_value = std::atomic_fetch_sub((std::atomic<U32>*)&dependent_job->remaining_job_count, 1);
-            if (old_value == 1)
-            {
-                schedule_job_to_least_worked_thread(dependent_job_handle);
-            }
-        }
-        else
-        {
-            terminate_job(dependent_job_handle);
-        }
-    }
+    return job_handle;
+}
+
+Job_Handle execute_job(Job_Data job_data, Array_View< Job_Handle > wait_for_jobs)
+{
+    return internal_execute_job(job_data, wait_for_jobs, nullptr);
+}
 
-    reset(&job->dependent_jobs);
+Job_Handle execute_job(Job_Data job_data, Job_Counter *wait_for_counter)
+{
+    HE_ASSERT(wait_for_counter);
+    return internal_execute_job(job_data, { 0, nullptr }, wait_for_counter);
+}
 
-    platform_unlock_mutex(&job->dependent_jobs_mutex);
+// acquires job_count + 1 handles, the last one is the join job which owns batch_data and finishes with the batch.
+static Job_Handle begin_job_batch(U32 job_count, void *batch_data, Job_Handle *out_job_handles)
+{
+    for (U32 job_index = 0; job_index < job_count + 1; job_index++)
+    {
+        out_job_handles[job_index] = acquire_handle(&job_system_state.job_pool);
+    }
 
-    deallocate(&job_system_state.job_data_allocator, job->data.parameters.data);
+    Job_Handle join_job_handle = out_job_handles[job_count];
+    Job *join_job = get(&job_system_state.job_pool, join_job_handle);
+    init_job(join_job, {});
+    join_job->data.parameters.data = batch_data;
+    std::atomic_store((std::atomic<U32>*)&join_job->remaining_job_count, job_count);
+    std::atomic_store((std::atomic<bool>*)&join_job->failed, false);
 
-    release_handle(&job_system_state.job_pool, job_handle);
+    return join_job_handle;
 }
 
-unsigned long execute_thread_work(void *params)
+// small parameters are copied inline, bigger ones have to point into the batch data already.
+static void init_batch_job(Job_Handle job_handle, Job_Handle join_job_handle, const Job_Data &job_data)
 {
-    Thread_State *thread_state = (Thread_State *)params;
-    Semaphore *job_queue_semaphore = &thread_state->job_queue_semaphore;
-    Mutex *job_queue_mutex = &thread_state->job_queue_mutex;
-    Mutex *dependency_mutex = &thread_state->dependency_mutex;
-    Ring_Queue< Job_Handle > *job_queue = &thread_state->job_queue;
+    Job *job = get(&job_system_state.job_pool, job_handle);
+    job->data = job_data;
 
-    while (true)
+    if (job_data.parameters.data && fits_in_inline_parameters(job_data.parameters))
     {
-        bool signaled = platform_wait_for_semaphore(job_queue_semaphore);
-        HE_ASSERT(signaled);
+        copy_memory(job->inline_parameters, job_data.parameters.data, job_data.parameters.size);
+        job->data.parameters.data = job->inline_parameters;
+    }
 
-        platform_lock_mutex(job_queue_mutex);
+    job->join_job = { .index = join_job_handle.index, .generation = join_job_handle.generation };
+}
 
-        if (!job_system_state.running && count(job_queue) == 0)
-        {
-            platform_unlock_mutex(job_queue_mutex);
-            break;
-        }
+static void end_job_batch(const Job_Handle *job_handles, U32 job_count)
+{
+    job_system_state.in_progress_job_count.fetch_add(job_count + 1);
+    schedule_jobs(job_handles, job_count);
+}
 
-        U32 index = 0;
-        Job_Handle job_handle = Resource_Pool<Job>::invalid_handle;
-        bool peeked = peek_front(job_queue, &job_handle, &index);
-        Job *job = get(&job_system_state.job_pool, job_handle);
-        platform_unlock_mutex(job_queue_mutex);
+Job_Handle execute_job_batch(Array_View< Job_Data > jobs)
+{
+    if (!jobs.count)
+    {
+        return Resource_Pool< Job >::invalid_handle;
+    }
 
-        HE_ASSERT(peeked);
-        HE_ASSERT(job->data.proc);
+    Memory_Context memory_context = grab_memory_context();
 
-        Temprary_Memory temprary_memory = begin_temprary_memory(thread_state->arena);
-        job->data.parameters.arena = thread_state->arena;
+    // parameters that don't fit inline share one allocation, it is aligned to the biggest alignment so every offset aligned to its own alignment stays aligned.
+    U16 batch_alignment = 1;
+    U64 batch_size = 0;
+    U64 *offsets = HE_ALLOCATOR_ALLOCATE_ARRAY(memory_context.temp_allocator, U64, jobs.count);
 
-        Job_Result result = job->data.proc(job->data.parameters);
-        if (job->data.completed_proc)
+    for (U32 job_index = 0; job_index < jobs.count; job_index++)
+    {
+        const Job_Parameters &parameters = jobs[job_index].parameters;
+        if (!parameters.data || fits_in_inline_parameters(parameters))
         {
-            job->data.completed_proc(result);
+            continue;
         }
 
-        end_temprary_memory(temprary_memory);
+        U16 alignment = get_job_parameters_alignment(parameters);
+        batch_alignment = HE_MAX(batch_alignment, alignment);
+        batch_size += get_number_of_bytes_to_align_address(batch_size, alignment);
+        offsets[job_index] = batch_size;
+        batch_size += parameters.size;
+    }
+
+    U8 *batch_data = nullptr;
+    if (batch_size)
+    {
+        batch_data = (U8 *)allocate(&job_system_state.job_data_allocator, batch_size, batch_alignment);
+    }
 
-        pop_front(job_queue);
+    Job_Handle *job_handles = HE_ALLOCATOR_ALLOCATE_ARRAY(memory_context.temp_allocator, Job_Handle, jobs.count + 1);
+    Job_Handle join_job_handle = begin_job_batch(jobs.count, batch_data, job_handles);
 
-        finalize_job(job_handle, result);
+    for (U32 job_index = 0; job_index < jobs.count; job_index++)
+    {
+        Job_Data job_data = jobs[job_index];
+        if (job_data.parameters.data && !fits_in_inline_parameters(job_data.parameters))
+        {
+            U8 *data = batch_data + offsets[job_index];
+            copy_memory(data, job_data.parameters.data, job_data.parameters.size);
+            job_data.parameters.data = data;
+        }
 
-        job_system_state.in_progress_job_count.fetch_sub(1);
+        init_batch_job(job_handles[job_index], join_job_handle, job_data);
     }
 
-    return 0;
+    end_job_batch(job_handles, jobs.count);
+    return join_job_handle;
 }
 
-bool init_job_system()
+struct Parallel_For_Job_Data
 {
-    Memory_Context memory_context = grab_memory_context();
+    Parallel_For_Proc proc;
+    U32 begin;
+    U32 end;
+    Job_Parameters parameters;
+};
 
-    bool inited = init_free_list_allocator(&job_system_state.job_data_allocator, nullptr, HE_MEGA_BYTES(64), HE_MEGA_BYTES(64), "job_allocator");
-    HE_ASSERT(inited);
+static Job_Result parallel_for_job(const Job_Parameters &params)
+{
+    const Parallel_For_Job_Data *job_data = (const Parallel_For_Job_Data *)params.data;
+    Job_Parameters parameters = job_data->parameters;
+    parameters.arena = params.arena;
+    return job_data->proc(job_data->begin, job_data->end, parameters);
+}
 
-    U32 thread_count = get_job_thread_count();
-    HE_ASSERT(thread_count);
+Job_Handle parallel_for(U32 count, U32 grain, Parallel_For_Proc proc, Job_Parameters params, Job_Priority priority)
+{
+    HE_ASSERT(proc);
 
-    job_system_state.running.store(true);
-    job_system_state.in_progress_job_count.store(0);
-    job_system_state.thread_count = thread_count;
-    job_system_state.thread_states = HE_ALLOCATOR_ALLOCATE_ARRAY(memory_context.permenent_allocator, Thread_State, thread_count);
+    if (!count)
+    {
+        return Resource_Pool< Job >::invalid_handle;
+    }
 
-    init(&job_system_state.job_pool, thread_count * JOB_COUNT_PER_THREAD, to_allocator(&job_system_state.job_data_allocator));
+    // a few chunks per thread so threads that finish early can steal the rest.
+    U32 target_chunk_count = get_effective_thread_count() * 4;
+    U32 chunk_size = HE_MAX(HE_MAX(grain, 1u), (count + target_chunk_count - 1) / target_chunk_count);
+    U32 chunk_count = (count + chunk_size - 1) / chunk_size;
 
-    for (U32 thread_index = 0; thread_index < thread_count; thread_index++)
+    static_assert(sizeof(Parallel_For_Job_Data) <= HE_JOB_INLINE_PARAMETERS_SIZE);
+
+    // the chunks are copied inline into their jobs so only the shared parameters need an allocation.
+    void *batch_data = nullptr;
+    if (params.data)
     {
-        Thread_State *thread_state = &job_system_state.thread_states[thread_index];
-        thread_state->thread_index = thread_index;
+        batch_data = allocate(&job_system_state.job_data_allocator, params.size, get_job_parameters_alignment(params), AllocationFlag_NoZero);
+        copy_memory(batch_data, params.data, params.size);
+        params.data = batch_data;
+    }
 
-        init(&thread_state->job_queue, JOB_COUNT_PER_THREAD, memory_context.permenent_allocator);
+    Memory_Context memory_context = grab_memory_context();
+    Job_Handle *job_handles = HE_ALLOCATOR_ALLOCATE_ARRAY(memory_context.temp_allocator, Job_Handle, chunk_count + 1);
+    Job_Handle join_job_handle = begin_job_batch(chunk_count, batch_data, job_handles);
 
-        bool job_queue_semaphore_created = platform_create_semaphore(&thread_state->job_queue_semaphore);
-        HE_ASSERT(job_queue_semaphore_created);
+    for (U32 chunk_index = 0; chunk_index < chunk_count; chunk_index++)
+    {
+        Parallel_For_Job_Data chunk =
+        {
+            .proc = proc,
+            .begin = chunk_index * chunk_size,
+            .end = HE_MIN(chunk_index * chunk_size + chunk_size, count),
+            .parameters = params
+        };
 
-        bool job_queue_mutex_created = platform_create_mutex(&thread_state->job_queue_mutex);
-        HE_ASSERT(job_queue_mutex_created);
+        Job_Data job_data =
+        {
+            .parameters =
+            {
+                .data = &chunk,
+                .size = sizeof(Parallel_For_Job_Data),
+                .alignment = alignof(Parallel_For_Job_Data)
+            },
+            .proc = &parallel_for_job,
+            .priority = priority,
+            .name = "parallel_for"
+        };
+
+        init_batch_job(job_handles[chunk_index], join_job_handle, job_data);
+    }
 
-        bool dependency_mutex_created = platform_create_mutex(&thread_state->dependency_mutex);
-        HE_ASSERT(dependency_mutex_created);
+    end_job_batch(job_handles, chunk_count);
+    return join_job_handle;
+}
 
-        bool thread_created_and_started = platform_create_and_start_thread(&thread_state->thread, execute_thread_work, thread_state, "HopeWorkerThread");
-        HE_ASSERT(thread_created_and_started);
+static bool is_job_finished(const void *data)
+{
+    Job_Handle job_handle = *(const Job_Handle *)data;
 
-        U32 thread_id = platform_get_thread_id(&thread_state->thread);
-        Thread_Memory_State *memory_state = get_thread_memory_state(thread_id);
-        thread_state->arena = &memory_state->arena;
+    // finished jobs are released back to the pool so an invalid handle is a finished one.
+    if (!is_valid_handle(&job_system_state.job_pool, job_handle))
+    {
+        return true;
     }
 
-    return true;
+    // the slot may have been reused since the check above, then the counter belongs to another job and ours is finished.
+    Job *job = &job_system_state.job_pool.jobs[job_handle.index];
+    bool counter_is_zero = job->counter.value.load() == 0;
+    return counter_is_zero || !is_valid_handle(&job_system_state.job_pool, job_handle);
 }
 
-void deinit_job_system()
+static bool is_all_jobs_finished(const void *)
 {
-    wait_for_all_jobs_to_finish();
-    job_system_state.running.store(false);
+    return job_system_state.in_progress_job_count.load() == 0;
 }
 
-static void init_job(Job *job, Job_Data job_data)
+static bool is_job_counter_zero(const void *data)
 {
-    job->data = job_data;
+    const Job_Counter *counter = (const Job_Counter *)data;
+    return counter->value.load() == 0;
+}
 
-    if (job_data.parameters.data)
+typedef bool (*Wait_Condition_Proc)(const void *data);
+
+static void help_until(Wait_Condition_Proc condition, const void *data, const char *name)
+{
+    Thread_State *thread_state = current_thread_state;
+
+#if HE_JOB_PROFILING
+    bool profiling = thread_state && job_system_state.profiling.load(std::memory_order_relaxed);
+    U64 start_time = profiling ? platform_get_performance_counter() : 0;
+#endif
+
+    while (true)
     {
-        U16 alignment = job_data.parameters.alignment; 
-        if (!alignment)
+        U32 job_event_count = job_system_state.job_event_count.load();
+
+        if (condition(data))
         {
-            alignment = HE_DEFAULT_ALIGNMENT;
+            break;
         }
-        void *data = allocate(&job_system_state.job_data_allocator, job_data.parameters.size, alignment);
-        copy_memory(data, job_data.parameters.data, job_data.parameters.size);
-        job->data.parameters.data = data;
+
+        // only threads that own a job queue have an arena to execute jobs on, and they only pick up
+        // background jobs if they are already inside one so frame work doesn't stall behind an asset load.
+        Job_Handle job_to_execute = Resource_Pool< Job >::invalid_handle;
+        Job_Priority lowest_priority = thread_state && thread_state->background_job_depth ? Job_Priority::BACKGROUND : Job_Priority::NORMAL;
+        if (thread_state && find_job(thread_state, &job_to_execute, lowest_priority, true))
+        {
+            run_job(thread_state, job_to_execute);
+            continue;
+        }
+
+        job_system_state.waiting_thread_count.fetch_add(1);
+        job_system_state.job_event_count.wait(job_event_count);
+        job_system_state.waiting_thread_count.fetch_sub(1);
     }
 
-    std::atomic_store((std::atomic<bool>*)&job->finished, false);
-    platform_create_mutex(&job->dependent_jobs_mutex);
+#if HE_JOB_PROFILING
+    if (profiling)
+    {
+        record_job_profile_event(thread_state, Job_Profile_Event_Type::WAIT, name, 0, start_time, platform_get_performance_counter());
+    }
+#endif
 }
 
-Job_Handle execute_job(Job_Data job_data, Array_View< Job_Handle > wait_for_jobs)
+void wait_for_job_to_finish(Job_Handle job_handle)
 {
-    Job_Handle job_handle = acquire_handle(&job_system_state.job_pool);
-    Job *job = get(&job_system_state.job_pool, job_handle);
-    init_job(job, job_data);
+    help_until(&is_job_finished, &job_handle, "wait_for_job_to_finish");
+}
+
+void wait_for_all_jobs_to_finish()
+{
+    help_until(&is_all_jobs_finished, nullptr, "wait_for_all_jobs_to_finish");
+}
+
+void init_job_counter(Job_Counter *counter, U32 count)
+{
+    HE_ASSERT(counter);
+    init_job_counter_value(counter, count);
+}
+
+void wait_for_counter(Job_Counter *counter)
+{
+    HE_ASSERT(counter);
+    help_until(&is_job_counter_zero, counter, "wait_for_counter");
+}
+
+#if HE_JOB_PROFILING
 
-    std::atomic_store((std::atomic<U32>*)&job->remaining_job_count, wait_for_jobs.count);
+static F64 get_job_profile_milliseconds(U64 counts)
+{
+    return (F64)counts * 1000.0 / (F64)job_system_state.performance_frequency;
+}
+
+static F64 get_job_profile_microseconds(U64 time)
+{
+    return (F64)time * 1000000.0 / (F64)job_system_state.performance_frequency;
+}
 
-    for (Job_Handle dependent_job_handle : wait_for_jobs)
+// calls proc for every recorded event that started in [begin_time, end_time).
+template< typename Proc >
+static void for_each_job_profile_event(U64 begin_time, U64 end_time, Proc proc)
+{
+    for (U32 thread_index = 0; thread_index < job_system_state.thread_count + 1; thread_index++)
     {
-        if (is_valid_handle(&job_system_state.job_pool, dependent_job_handle))
-        {
-            Job *dependent_job = get(&job_system_state.job_pool, dependent_job_handle);
-            platform_lock_mutex(&dependent_job->dependent_jobs_mutex);
+        Job_Profile_Event_Buffer *buffer = &job_system_state.thread_states[thread_index].profile_events;
+        U64 write_index = buffer->write_index.load(std::memory_order_acquire);
+        U64 read_index = write_index > HE_JOB_PROFILE_EVENT_COUNT_PER_THREAD ? write_index - HE_JOB_PROFILE_EVENT_COUNT_PER_THREAD : 0;
 
-            if (std::atomic_load((std::atomic<bool>*)&dependent_job->finished) == false)
-            {
-                Job_Ref job_ref = { .index = job_handle.index, .generation = job_handle.generation };
-                append(&dependent_job->dependent_jobs, job_ref);
-            }
-            else
+        for (; read_index < write_index; read_index++)
+        {
+            const Job_Profile_Event &event = buffer->events[read_index & (HE_JOB_PROFILE_EVENT_COUNT_PER_THREAD - 1)];
+            if (event.start_time >= begin_time && event.start_time < end_time)
             {
-                std::atomic_fetch_sub((std::atomic<U32>*)&job->remaining_job_count, 1);
+                proc(thread_index, event);
             }
+        }
+    }
+}
+
+static bool write_job_profile_capture(String path, U64 begin_time, U64 end_time)
+{
+    Memory_Context memory_context = grab_memory_context();
 
-            platform_unlock_mutex(&dependent_job->dependent_jobs_mutex);
+    String_Builder builder = {};
+    begin_string_builder(&builder, memory_context.temprary_memory.arena);
+
+    append(&builder, "{\"traceEvents\":[\n");
+
+    U32 main_thread_index = job_system_state.thread_count;
+    for (U32 thread_index = 0; thread_index < main_thread_index + 1; thread_index++)
+    {
+        if (thread_index == main_thread_index)
+        {
+            append(&builder, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"main thread\"}},\n", thread_index);
         }
         else
         {
-            std::atomic_fetch_sub((std::atomic<U32>*)&job->remaining_job_count, 1);
+            append(&builder, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"worker %u\"}},\n", thread_index, thread_index);
         }
     }
 
-    if (!job->remaining_job_count)
+    for_each_job_profile_event(begin_time, end_time, [&](U32 thread_index, const Job_Profile_Event &event)
     {
-        schedule_job_to_least_worked_thread(job_handle);
+        const char *category = event.type == Job_Profile_Event_Type::JOB ? "job" : "wait";
+        append(&builder, "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"queue_us\":%.3f}},\n",
+               event.name, category, thread_index,
+               get_job_profile_microseconds(event.start_time - begin_time),
+               get_job_profile_microseconds(event.end_time - event.start_time),
+               get_job_profile_microseconds(event.start_time - event.enqueue_time));
+    });
+
+    // chrome accepts a trailing comma but not every viewer does, so close with an event marking the end of the capture.
+    append(&builder, "{\"name\":\"capture_end\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":%u,\"ts\":%.3f}\n]}\n", main_thread_index, get_job_profile_microseconds(end_time - begin_time));
+
+    String contents = end_string_builder(&builder);
+    bool success = write_entire_file(path, (void *)contents.data, contents.count);
+    if (!success)
+    {
+        HE_LOG(Core, Error, "write_job_profile_capture -- failed to write file: %.*s\n", HE_EXPAND_STRING(path));
     }
 
-    job_system_state.in_progress_job_count.fetch_add(1);
+    return success;
+}
 
-    return job_handle;
+#endif
+
+void set_job_profiler_enabled(bool enabled)
+{
+#if HE_JOB_PROFILING
+    job_system_state.profiling.store(enabled);
+#else
+    (void)enabled;
+#endif
 }
 
-void wait_for_job_to_finish(Job_Handle job_handle)
+bool is_job_profiler_enabled()
 {
-    if (!is_valid_handle(&job_system_state.job_pool, job_handle))
+#if HE_JOB_PROFILING
+    return job_system_state.profiling.load();
+#else
+    return false;
+#endif
+}
+
+void job_profiler_new_frame()
+{
+#if HE_JOB_PROFILING
+    U64 now = platform_get_performance_counter();
+    job_system_state.last_frame_start_time = job_system_state.frame_start_time;
+    job_system_state.frame_start_time = now;
+
+    if (!job_system_state.capture_frame_count)
     {
         return;
     }
 
-    Job *job = get(&job_system_state.job_pool, job_handle);
-    if (job)
+    // the capture starts at the first frame boundary after it was requested.
+    if (!job_system_state.capture_start_time)
+    {
+        job_system_state.capture_start_time = now;
+        return;
+    }
+
+    job_system_state.capture_frame_count--;
+    if (job_system_state.capture_frame_count)
     {
-        while (!job->finished);
+        return;
     }
+
+    write_job_profile_capture(job_system_state.capture_path, job_system_state.capture_start_time, now);
+
+    Memory_Context memory_context = grab_memory_context();
+    HE_ALLOCATOR_DEALLOCATE(memory_context.general_allocator, (void *)job_system_state.capture_path.data);
+    job_system_state.capture_path = {};
+    job_system_state.profiling.store(job_system_state.profiling_before_capture);
+#endif
 }
 
-void wait_for_all_jobs_to_finish()
+bool capture_job_profile(U32 frame_count, String path)
 {
-    while (job_system_state.in_progress_job_count.load())
+#if HE_JOB_PROFILING
+    if (!frame_count || job_system_state.capture_frame_count)
     {
+        return false;
     }
-#if 0
-    while (job_system_state.in_progress_job_count.load())
+
+    Memory_Context memory_context = grab_memory_context();
+    job_system_state.capture_path = copy_string(path, memory_context.general_allocator);
+    job_system_state.capture_frame_count = frame_count;
+    job_system_state.capture_start_time = 0;
+    job_system_state.profiling_before_capture = job_system_state.profiling.load();
+    job_system_state.profiling.store(true);
+    return true;
+#else
+    (void)frame_count;
+    (void)path;
+    return false;
+#endif
+}
+
+bool is_capturing_job_profile()
+{
+#if HE_JOB_PROFILING
+    return job_system_state.capture_frame_count != 0;
+#else
+    return false;
+#endif
+}
+
+bool get_job_profile_summary(Job_Profile_Summary *out_summary, Allocator allocator)
+{
+    HE_ASSERT(out_summary);
+
+#if HE_JOB_PROFILING
+    U64 begin_time = job_system_state.last_frame_start_time;
+    U64 end_time = job_system_state.frame_start_time;
+    U32 main_thread_index = job_system_state.thread_count;
+
+    Job_Profile_Summary &summary = *out_summary;
+    summary = {};
+    summary.frame_ms = get_job_profile_milliseconds(end_time - begin_time);
+    summary.thread_count = main_thread_index + 1;
+    summary.thread_busy_ms = HE_ALLOCATOR_ALLOCATE_ARRAY(allocator, F64, summary.thread_count);
+    zero_memory(summary.thread_busy_ms, sizeof(F64) * summary.thread_count);
+
+    U32 max_entry_count = 0;
+    for_each_job_profile_event(begin_time, end_time, [&](U32, const Job_Profile_Event &)
+    {
+        max_entry_count++;
+    });
+    summary.entries = HE_ALLOCATOR_ALLOCATE_ARRAY(allocator, Job_Profile_Entry, HE_MAX(max_entry_count, 1u));
+
+    for_each_job_profile_event(begin_time, end_time, [&](U32 thread_index, const Job_Profile_Event &event)
     {
-        Thread_State *most_worked_thread_state = nullptr;
-        U32 most_work_count_so_far = 0;
+        F64 duration_ms = get_job_profile_milliseconds(event.end_time - event.start_time);
 
-        for (U32 thread_index = 0; thread_index < job_system_state.thread_count; thread_index++)
+        if (event.type == Job_Profile_Event_Type::WAIT)
         {
-            Thread_State *thread_state = &job_system_state.thread_states[thread_index];
-            platform_lock_mutex(&thread_state->job_queue_mutex);
-            U32 job_count_in_queue = count(&thread_state->job_queue);
-            if (job_count_in_queue > 1 && job_count_in_queue > most_work_count_so_far)
+            if (thread_index == main_thread_index)
             {
-                most_worked_thread_state = thread_state;
-                most_work_count_so_far = job_count_in_queue;
+                summary.main_thread_wait_ms += duration_ms;
             }
-            platform_unlock_mutex(&thread_state->job_queue_mutex);
-        }
-
-        if (!most_worked_thread_state)
-        {
-            continue;
+            return;
         }
 
-        platform_lock_mutex(&most_worked_thread_state->job_queue_mutex);
+        summary.thread_busy_ms[thread_index] += duration_ms;
 
-        if (count(&most_worked_thread_state->job_queue) <= 1)
+        // names are static strings so comparing the pointers is enough.
+        Job_Profile_Entry *entry = nullptr;
+        for (U32 entry_index = 0; entry_index < summary.entry_count; entry_index++)
         {
-            platform_unlock_mutex(&most_worked_thread_state->job_queue_mutex);
-            continue;
+            if (summary.entries[entry_index].name == event.name)
+            {
+                entry = &summary.entries[entry_index];
+                break;
+            }
         }
 
-        // we don't actually wait here we just decrement the semaphore counter...
-        wait_for_semaphore(&most_worked_thread_state->job_queue_semaphore);
-
-        Ring_Queue< Job_Handle > *job_queue = &most_worked_thread_state->job_queue;
-
-        Job_Handle job_handle = Resource_Pool< Job >::invalid_handle;
-        bool peeked = peek_back(job_queue, &job_handle);
-        pop_back(job_queue);
-        Job *job = get(&job_system_state.job_pool, job_handle);
-        platform_unlock_mutex(&most_worked_thread_state->job_queue_mutex);
-        HE_ASSERT(job->data.proc);
-
-        Temprary_Memory_Arena scratch_memory = begin_scratch_memory();
-        job->data.parameters.arena = scratch_memory.arena;
-
-        Job_Result result = job->data.proc(job->data.parameters);
-        if (job->data.completed_proc)
+        if (!entry)
         {
-            job->data.completed_proc(result);
+            HE_ASSERT(summary.entry_count < max_entry_count);
+            entry = &summary.entries[summary.entry_count++];
+            *entry = { .name = event.name };
         }
 
-        end_temprary_memory(&scratch_memory);
+        entry->count++;
+        entry->total_ms += duration_ms;
+        entry->max_ms = HE_MAX(entry->max_ms, duration_ms);
+        entry->total_queue_ms += get_job_profile_milliseconds(event.start_time - event.enqueue_time);
+    });
 
-        finalize_job(job_handle, result);
+    std::sort(summary.entries, summary.entries + summary.entry_count, [](const Job_Profile_Entry &a, const Job_Profile_Entry &b)
+    {
+        return a.total_ms > b.total_ms;
+    });
 
-        job_system_state.in_progress_job_count.fetch_sub(1);
-    }
+    return true;
+#else
+    (void)allocator;
+    *out_summary = {};
+    return false;
 #endif
 }
 
-
 U32 get_job_thread_count()
 {
+    if (job_system_state.thread_count)
+    {
+        return job_system_state.thread_count;
+    }
+
     U32 thread_count = platform_get_thread_count();
     if (thread_count > 2)
     {
@@ -4,6 +4,20 @@
 #include "containers/array_view.h"
 #include "containers/dynamic_array.h"
 #include "containers/resource_pool.h"
+#include "containers/string.h"
+
+#include <atomic>
+
+#define HE_JOB_INLINE_DEPENDENCY_COUNT 4
+#define HE_JOB_INLINE_PARAMETERS_SIZE 64
+#define HE_JOB_INLINE_PARAMETERS_ALIGNMENT 16
+
+#define HE_JOB_PROFILING 1
+
+#ifdef HE_SHIPPING
+#undef HE_JOB_PROFILING
+#define HE_JOB_PROFILING 0
+#endif
 
 enum class Job_Result : U8
 {
@@ -12,8 +26,24 @@ enum class Job_Result : U8
     SUCCEEDED
 };
 
+enum class Job_Priority : U8
+{
+    CRITICAL,   // frame work the main thread is waiting on (render graph command recording).
+    NORMAL,
+    BACKGROUND, // long running work (asset loads), limited to job_system.max_background_thread_count workers.
+    COUNT
+};
+
 typedef void (*Job_Completed_Proc)(Job_Result result);
 
+// a wait group: jobs with a signal_counter decrement it when they finish and jobs waiting on it are scheduled once it hits zero.
+struct Job_Counter
+{
+    std::atomic< U32 > value;
+    std::atomic< bool > failed;
+    std::atomic< S32 > first_waiting_job_index;
+};
+
 struct Job_Parameters
 {
     struct Memory_Arena *arena;
@@ -23,12 +53,16 @@ struct Job_Parameters
 };
 
 typedef Job_Result (*Job_Proc)(const Job_Parameters &params);
+typedef Job_Result (*Parallel_For_Proc)(U32 begin, U32 end, const Job_Parameters &params);
 
 struct Job_Data
 {
     Job_Parameters     parameters;
     Job_Proc           proc;
     Job_Completed_Proc completed_proc;
+    Job_Priority       priority = Job_Priority::NORMAL;
+    Job_Counter        *signal_counter = nullptr;
+    const char         *name = nullptr; // static string shown by the job profiler.
 };
 
 struct Job_Ref
@@ -40,22 +74,88 @@ struct Job_Ref
 struct Job
 {
     Job_Data            data;
-    volatile bool       finished;
 
-    volatile U32             remaining_job_count;
-    Mutex                    dependent_jobs_mutex;
-    Dynamic_Array< Job_Ref > dependent_jobs;
+    // parameters up to HE_JOB_INLINE_PARAMETERS_SIZE bytes are copied here instead of the job data allocator.
+    alignas(HE_JOB_INLINE_PARAMETERS_ALIGNMENT) U8 inline_parameters[HE_JOB_INLINE_PARAMETERS_SIZE];
+
+    Job_Counter         counter; // 1 until the job finishes, jobs depending on this one wait on it.
+
+    // dependencies are waited on one at a time so a job is only ever linked into a single counter's waiting list.
+    Job_Counter         *wait_for_counter;
+    Job_Ref             *wait_for_jobs; // points at inline_wait_for_jobs or the job data allocator when there are more.
+    Job_Ref             inline_wait_for_jobs[HE_JOB_INLINE_DEPENDENCY_COUNT];
+    U32                 wait_for_job_count;
+    U32                 next_dependency_index;
+    S32                 next_waiting_job_index;
+
+    // jobs submitted in a batch finish through a join job that owns the batch memory.
+    volatile U32        remaining_job_count;
+    Job_Ref             join_job;
+    volatile bool       failed;
+
+#if HE_JOB_PROFILING
+    U64                 enqueue_time;
+#endif
 };
 
 using Job_Handle = Resource_Handle< Job >;
 
-bool init_job_system();
+// thread_count 0 picks the worker count from the platform and the job_system cvars.
+bool init_job_system(U32 thread_count = 0);
 void deinit_job_system();
 
 Job_Handle execute_job(Job_Data job_data, Array_View< Job_Handle > wait_for_jobs = { 0, nullptr });
 
+// the job is scheduled once wait_for_counter hits zero, it is aborted if any job that signaled the counter failed.
+Job_Handle execute_job(Job_Data job_data, Job_Counter *wait_for_counter);
+
+// submits all jobs with a single allocation and a single wake up, the returned handle finishes when all of them do.
+Job_Handle execute_job_batch(Array_View< Job_Data > jobs);
+
+// splits [0, count) into chunks of at least grain items, params.data is copied once and shared by all chunks.
+Job_Handle parallel_for(U32 count, U32 grain, Parallel_For_Proc proc, Job_Parameters params = {}, Job_Priority priority = Job_Priority::NORMAL);
+
 void wait_for_job_to_finish(Job_Handle job_handle);
 void wait_for_all_jobs_to_finish();
 
+// count has to cover every job that will signal the counter before any of them is executed.
+void init_job_counter(Job_Counter *counter, U32 count);
+void wait_for_counter(Job_Counter *counter);
+
+struct Job_Profile_Entry
+{
+    const char *name;
+    U32 count;
+    F64 total_ms;
+    F64 max_ms;
+    F64 total_queue_ms;
+};
+
+// covers the last finished frame.
+struct Job_Profile_Summary
+{
+    F64 frame_ms;
+
+    U32 thread_count; // worker threads followed by the main thread.
+    F64 *thread_busy_ms;
+
+    F64 main_thread_wait_ms; // time spent inside wait_for_*, including the jobs it executed while waiting.
+
+    U32 entry_count;
+    Job_Profile_Entry *entries; // sorted by total_ms.
+};
+
+void set_job_profiler_enabled(bool enabled);
+bool is_job_profiler_enabled();
+
+// has to be called by the main thread once per frame.
+void job_profiler_new_frame();
+
+// records the next frame_count frames and writes them to path as chrome trace_event json (chrome://tracing, ui.perfetto.dev).
+bool capture_job_profile(U32 frame_count, String path);
+bool is_capturing_job_profile();
+
+bool get_job_profile_summary(Job_Profile_Summary *out_summary, Allocator allocator);
+
 U32 get_job_thread_count();
 U32 get_effective_thread_count();
\ No newline at end of file
@@ -1,10 +1,13 @@
 #include "memory.h"
 #include "platform.h"
 #include "rendering/renderer.h"
-#include "containers/hash_map.h"
 #include "core/logging.h"
+#include "containers/string.h"
 
 #include <string.h>
+#include <stddef.h>
+
+#include <bit>
 
 #include <imgui.h>
 
@@ -22,30 +25,191 @@ void copy_memory(void *dst, const void *src, U64 size)
     memcpy(dst, src, size);
 }
 
+//
+// Memory Tags
+//
+
+#define HE_MEMORY_TAG_UNTRACKED 0xFF
+
+struct Memory_Tag_Counters
+{
+    std::atomic< S64 > live_bytes;
+    std::atomic< U64 > allocation_count;
+    std::atomic< U64 > allocated_bytes;
+};
+
+static thread_local Memory_Tag current_memory_tag = Memory_Tag::GENERAL;
+
+// allocations that reach the general heap directly, thread cache allocations are counted per cache.
+static Memory_Tag_Counters heap_memory_tag_counters[(U32)Memory_Tag::COUNT];
+
+const char *memory_tag_to_string(Memory_Tag tag)
+{
+    switch (tag)
+    {
+        case Memory_Tag::GENERAL: return "general";
+        case Memory_Tag::CORE: return "core";
+        case Memory_Tag::ASSETS: return "assets";
+        case Memory_Tag::RENDERING: return "rendering";
+        case Memory_Tag::JOBS: return "jobs";
+        case Memory_Tag::EDITOR: return "editor";
+        default: HE_ASSERT(!"unsupported memory tag"); break;
+    }
+
+    return "";
+}
+
+Memory_Tag_Scope::Memory_Tag_Scope(Memory_Tag tag)
+{
+    HE_ASSERT(tag < Memory_Tag::COUNT);
+    previous_tag = current_memory_tag;
+    current_memory_tag = tag;
+}
+
+Memory_Tag_Scope::~Memory_Tag_Scope()
+{
+    current_memory_tag = previous_tag;
+}
+
+Memory_Tag get_current_memory_tag()
+{
+    return current_memory_tag;
+}
+
+HE_FORCE_INLINE static void record_memory_tag_allocation(U8 tag, U64 size)
+{
+#if HE_MEMORY_TAGGING
+    if (tag == HE_MEMORY_TAG_UNTRACKED)
+    {
+        return;
+    }
+
+    Memory_Tag_Counters *counters = &heap_memory_tag_counters[tag];
+    counters->live_bytes.fetch_add((S64)size, std::memory_order_relaxed);
+    counters->allocation_count.fetch_add(1, std::memory_order_relaxed);
+    counters->allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+#endif
+}
+
+HE_FORCE_INLINE static void record_memory_tag_deallocation(U8 tag, U64 size)
+{
+#if HE_MEMORY_TAGGING
+    if (tag == HE_MEMORY_TAG_UNTRACKED)
+    {
+        return;
+    }
+
+    heap_memory_tag_counters[tag].live_bytes.fetch_sub((S64)size, std::memory_order_relaxed);
+#endif
+}
+
 struct Memory_System
 {
     U64 thread_arena_capacity;
+    U64 scratch_arena_capacity;
 
     Memory_Arena permenent_arena;
     Allocator permenent_allocator;
 
-    Memory_Arena frame_arena;
-    Allocator frame_allocator;
+    // one per frame in flight, each one is reset when the frame that used it last is done on the gpu.
+    // any thread can allocate from the current one, the main thread publishes it in begin_frame_memory.
+    Memory_Arena frame_arenas[HE_MAX_FRAMES_IN_FLIGHT];
+    std::atomic< Memory_Arena * > frame_arena;
+    Mutex frame_arena_commit_mutex;
 
     Memory_Arena debug_arena;
     Allocator debug_allocator;
 
     Free_List_Allocator general_free_list_allocator;
+    Thread_Cached_Allocator general_thread_cached_allocator;
     Allocator general_allocator;
 
-    Hash_Map< U32, Thread_Memory_State > thread_id_to_memory_state;
+    Mutex thread_contexts_mutex;
+    Thread_Context *thread_contexts;
+
+    U64 frame_index;
+    Memory_Tag_Stats tag_stats[(U32)Memory_Tag::COUNT];
+    U64 last_frame_allocation_counts[(U32)Memory_Tag::COUNT];
+    U64 last_frame_allocated_bytes[(U32)Memory_Tag::COUNT];
 };
 
 static Memory_System memory_system_state;
 
+static thread_local Thread_Context thread_context;
+static thread_local Thread_Context *current_thread_context;
+
+static bool init_thread_context(U64 arena_capacity, S32 worker_index, S32 numa_node)
+{
+    HE_ASSERT(!current_thread_context);
+
+    Thread_Context *context = &thread_context;
+    context->thread_id = platform_get_current_thread_id();
+    context->worker_index = worker_index;
+    context->renderer_thread_state = nullptr;
+
+    if (!init_memory_arena(&context->arena, arena_capacity, memory_system_state.thread_arena_capacity, numa_node))
+    {
+        return false;
+    }
+
+    for (U32 scratch_index = 0; scratch_index < HE_THREAD_SCRATCH_ARENA_COUNT; scratch_index++)
+    {
+        if (!init_memory_arena(&context->scratch_arenas[scratch_index], memory_system_state.scratch_arena_capacity, HE_MEGA_BYTES(1), numa_node))
+        {
+            return false;
+        }
+    }
+
+    platform_lock_mutex(&memory_system_state.thread_contexts_mutex);
+    context->next = memory_system_state.thread_contexts;
+    memory_system_state.thread_contexts = context;
+    platform_unlock_mutex(&memory_system_state.thread_contexts_mutex);
+
+    current_thread_context = context;
+    return true;
+}
+
+bool init_thread_context(S32 worker_index, S32 numa_node)
+{
+    return init_thread_context(memory_system_state.thread_arena_capacity, worker_index, numa_node);
+}
+
+void deinit_thread_context()
+{
+    Thread_Context *context = current_thread_context;
+    HE_ASSERT(context);
+
+    platform_lock_mutex(&memory_system_state.thread_contexts_mutex);
+    Thread_Context **link = &memory_system_state.thread_contexts;
+    while (*link != context)
+    {
+        link = &(*link)->next;
+    }
+    *link = context->next;
+    platform_unlock_mutex(&memory_system_state.thread_contexts_mutex);
+
+    HE_ASSERT(context->arena.temp_count == 0);
+    platform_deallocate_memory(context->arena.base);
+
+    for (U32 scratch_index = 0; scratch_index < HE_THREAD_SCRATCH_ARENA_COUNT; scratch_index++)
+    {
+        HE_ASSERT(context->scratch_arenas[scratch_index].temp_count == 0);
+        platform_deallocate_memory(context->scratch_arenas[scratch_index].base);
+    }
+
+    current_thread_context = nullptr;
+}
+
+Thread_Context *get_thread_context()
+{
+    HE_ASSERT(current_thread_context);
+    return current_thread_context;
+}
+
 bool init_memory_system()
 {
     memory_system_state.thread_arena_capacity = HE_MEGA_BYTES(128);
+    memory_system_state.scratch_arena_capacity = HE_MEGA_BYTES(64);
     U64 capacity = platform_get_total_memory_size();
 
     if (!init_memory_arena(&memory_system_state.permenent_arena, capacity, HE_MEGA_BYTES(64)))
@@ -55,12 +219,18 @@ bool init_memory_system()
 
     memory_system_state.permenent_allocator = to_allocator(&memory_system_state.permenent_arena);
 
-    if (!init_memory_arena(&memory_system_state.frame_arena, capacity, HE_MEGA_BYTES(64)))
+    for (U32 frame_index = 0; frame_index < HE_MAX_FRAMES_IN_FLIGHT; frame_index++)
     {
-        return false;
+        if (!init_memory_arena(&memory_system_state.frame_arenas[frame_index], capacity, HE_MEGA_BYTES(64)))
+        {
+            return false;
+        }
     }
 
-    memory_system_state.frame_allocator = to_allocator(&memory_system_state.frame_arena);
+    memory_system_state.frame_arena.store(&memory_system_state.frame_arenas[0], std::memory_order_release);
+
+    bool frame_arena_mutex_created = platform_create_mutex(&memory_system_state.frame_arena_commit_mutex);
+    HE_ASSERT(frame_arena_mutex_created);
 
     if (!init_memory_arena(&memory_system_state.debug_arena, capacity, HE_MEGA_BYTES(64)))
     {
@@ -74,15 +244,19 @@ bool init_memory_system()
         return false;
     }
 
-    memory_system_state.general_allocator = to_allocator(&memory_system_state.general_free_list_allocator);
+    if (!init_thread_cached_allocator(&memory_system_state.general_thread_cached_allocator, &memory_system_state.general_free_list_allocator))
+    {
+        return false;
+    }
 
-    init(&memory_system_state.thread_id_to_memory_state, get_effective_thread_count(), to_allocator(&memory_system_state.permenent_arena));
+    memory_system_state.general_allocator = to_allocator(&memory_system_state.general_thread_cached_allocator);
 
-    S32 slot_index = insert(&memory_system_state.thread_id_to_memory_state, platform_get_current_thread_id());
-    HE_ASSERT(slot_index != -1);
+    bool mutex_created = platform_create_mutex(&memory_system_state.thread_contexts_mutex);
+    HE_ASSERT(mutex_created);
+    memory_system_state.thread_contexts = nullptr;
 
-    Thread_Memory_State *main_thread_memory_state = &memory_system_state.thread_id_to_memory_state.values[slot_index];
-    if (!init_memory_arena(&main_thread_memory_state->arena, capacity, memory_system_state.thread_arena_capacity))
+    // the main thread arena can grow past the capacity of the other threads.
+    if (!init_thread_context(capacity, -1, -1))
     {
         return false;
     }
@@ -93,48 +267,131 @@ bool init_memory_system()
 void deinit_memory_system()
 {
     HE_ASSERT(memory_system_state.permenent_arena.temp_count == 0);
-    HE_ASSERT(memory_system_state.frame_arena.temp_count == 0);
+    for (U32 frame_index = 0; frame_index < HE_MAX_FRAMES_IN_FLIGHT; frame_index++)
+    {
+        HE_ASSERT(memory_system_state.frame_arenas[frame_index].temp_count == 0);
+    }
     HE_ASSERT(memory_system_state.debug_arena.temp_count == 0);
-    Memory_Arena *arena = get_thread_arena();
-    HE_ASSERT(arena->temp_count == 0);
+    deinit_thread_context();
+}
+
+Memory_Arena* get_permenent_arena()
+{
+    return &memory_system_state.permenent_arena;
+}
+
+Memory_Arena* get_thread_arena()
+{
+    HE_ASSERT(current_thread_context);
+    return &current_thread_context->arena;
+}
+
+void trim_thread_memory()
+{
+    HE_ASSERT(current_thread_context);
+    trim_memory_arena(&current_thread_context->arena);
+    for (U32 scratch_index = 0; scratch_index < HE_THREAD_SCRATCH_ARENA_COUNT; scratch_index++)
+    {
+        trim_memory_arena(&current_thread_context->scratch_arenas[scratch_index]);
+    }
+}
+
+Temprary_Memory begin_scratch_memory(Memory_Arena *conflict)
+{
+    HE_ASSERT(current_thread_context);
+    Memory_Arena *scratch_arenas = current_thread_context->scratch_arenas;
+    return begin_temprary_memory(&scratch_arenas[0] == conflict ? &scratch_arenas[1] : &scratch_arenas[0]);
 }
 
-Thread_Memory_State *get_thread_memory_state(U32 thread_id)
+// the offset is bumped with a compare exchange so any thread can allocate, only committing more pages takes the lock.
+static void *frame_arena_allocate(void *memory_arena, U64 size, U16 alignment, Allocation_Flags flags)
 {
-    auto it = find(&memory_system_state.thread_id_to_memory_state, thread_id);
+    Memory_Arena *arena = (Memory_Arena *)memory_arena;
+    HE_ASSERT(size);
+
+    std::atomic< U64 > *offset = (std::atomic< U64 > *)&arena->offset;
+    U64 old_offset = offset->load(std::memory_order_relaxed);
+    U64 new_offset = 0;
+    U64 padding = 0;
 
-    if (is_valid(it))
+    do
     {
-        return it.value;
+        padding = get_number_of_bytes_to_align_address((uintptr_t)(arena->base + old_offset), alignment);
+        new_offset = old_offset + padding + size;
+        HE_ASSERT(new_offset <= arena->capacity);
     }
+    while (!offset->compare_exchange_weak(old_offset, new_offset, std::memory_order_relaxed));
 
-    S32 slot_index = insert(&memory_system_state.thread_id_to_memory_state, thread_id);
-    Thread_Memory_State *thread_memory_state = &memory_system_state.thread_id_to_memory_state.values[slot_index];
-    if (!init_memory_arena(&thread_memory_state->arena, memory_system_state.thread_arena_capacity, memory_system_state.thread_arena_capacity))
+    std::atomic< U64 > *committed_size = (std::atomic< U64 > *)&arena->size;
+    if (new_offset > committed_size->load(std::memory_order_acquire))
     {
-        return nullptr;
+        platform_lock_mutex(&memory_system_state.frame_arena_commit_mutex);
+
+        U64 arena_size = committed_size->load(std::memory_order_relaxed);
+        if (new_offset > arena_size)
+        {
+            U64 commit_size = HE_MIN(HE_MAX(new_offset - arena_size, arena->min_allocation_size), arena->capacity - arena_size);
+            bool commited = platform_commit_memory(arena->base + arena_size, commit_size);
+            HE_ASSERT(commited);
+            committed_size->store(arena_size + commit_size, std::memory_order_release);
+        }
+
+        platform_unlock_mutex(&memory_system_state.frame_arena_commit_mutex);
     }
-    
-    return thread_memory_state;
+
+    void *result = arena->base + old_offset + padding;
+
+    if ((flags & AllocationFlag_Zero) || !((flags & AllocationFlag_NoZero) || (arena->flags & MemoryArenaFlag_NoZero)))
+    {
+        zero_memory(result, size);
+    }
+
+    return result;
 }
 
-Memory_Arena* get_permenent_arena()
+// other threads may have allocated past the old memory so it never grows in place.
+static void *frame_arena_reallocate(void *memory_arena, void *memory, U64 old_size, U64 new_size, U16 alignment)
 {
-    return &memory_system_state.permenent_arena;
+    if (memory && new_size <= old_size)
+    {
+        return memory;
+    }
+
+    void *new_memory = frame_arena_allocate(memory_arena, new_size, alignment, AllocationFlag_None);
+    if (memory)
+    {
+        copy_memory(new_memory, memory, old_size);
+    }
+    return new_memory;
 }
 
-Memory_Arena* get_thread_arena()
+static void frame_arena_deallocate(void *memory_arena, void *memory)
 {
-    U32 thread_id = platform_get_current_thread_id();
-    auto it = find(&memory_system_state.thread_id_to_memory_state, thread_id);
-    HE_ASSERT(is_valid(it));
-    Thread_Memory_State *memory_state = it.value;
-    return &memory_state->arena;
 }
 
 Memory_Arena* get_frame_arena()
 {
-    return &memory_system_state.frame_arena;
+    return memory_system_state.frame_arena.load(std::memory_order_acquire);
+}
+
+Allocator get_frame_allocator()
+{
+    return { .data = get_frame_arena(), .allocate = &frame_arena_allocate, .reallocate = &frame_arena_reallocate, .deallocate = &frame_arena_deallocate };
+}
+
+void begin_frame_memory(U32 frame_in_flight_index)
+{
+    HE_ASSERT(frame_in_flight_index < HE_MAX_FRAMES_IN_FLIGHT);
+
+    // frame allocations don't track the high water marks since they race, the final offset is all the trim needs.
+    Memory_Arena *arena = &memory_system_state.frame_arenas[frame_in_flight_index];
+    HE_ASSERT(arena->temp_count == 0);
+    arena->high_water_mark = HE_MAX(arena->high_water_mark, arena->offset);
+    arena->trim_high_water_mark = HE_MAX(arena->trim_high_water_mark, arena->offset);
+    arena->offset = 0;
+    trim_memory_arena(arena);
+
+    memory_system_state.frame_arena.store(arena, std::memory_order_release);
 }
 
 Memory_Context::~Memory_Context()
@@ -153,7 +410,7 @@ Memory_Context grab_memory_context()
     {
         .permenent_allocator = memory_system_state.permenent_allocator,
         .general_allocator   = memory_system_state.general_allocator,
-        .frame_allocator     = memory_system_state.frame_allocator,
+        .frame_allocator     = get_frame_allocator(),
         .temprary_memory     = begin_temprary_memory(arena),
         .temp_allocator      = to_allocator(arena),
         .dropped             = false
@@ -182,11 +439,48 @@ bool drop_memory_context(Memory_Context *memory_context, Allocator allocator)
 // Memory Arena
 //
 
-bool init_memory_arena(Memory_Arena *arena, U64 capacity, U64 min_allocation_size)
+HE_FORCE_INLINE static U64 align_up(U64 value, U64 alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// decommitting never goes below this so the commits stay coarse.
+#define HE_MEMORY_ARENA_TRIM_GRANULARITY HE_KILO_BYTES(64)
+
+bool init_memory_arena(Memory_Arena *arena, U64 capacity, U64 min_allocation_size, S32 numa_node, Memory_Arena_Flags flags)
 {
     HE_ASSERT(capacity >= min_allocation_size);
 
-    void *memory = platform_reserve_memory(capacity);
+    if (flags & MemoryArenaFlag_LargePages)
+    {
+        U64 large_page_size = platform_get_large_page_size();
+        void *memory = nullptr;
+
+        if (large_page_size)
+        {
+            capacity = align_up(capacity, large_page_size);
+            memory = platform_allocate_large_pages(capacity);
+        }
+
+        if (memory)
+        {
+            arena->base = (U8 *)memory;
+            arena->capacity = capacity;
+            arena->min_allocation_size = min_allocation_size;
+            arena->size = capacity;
+            arena->offset = 0;
+            arena->high_water_mark = 0;
+            arena->trim_high_water_mark = 0;
+            arena->temp_count = 0;
+            arena->flags = flags;
+            return true;
+        }
+
+        HE_LOG(Core, Warn, "init_memory_arena -- large pages are not available for a %llu bytes arena, falling back to normal pages\n", capacity);
+        flags = (Memory_Arena_Flags)(flags & ~MemoryArenaFlag_LargePages);
+    }
+
+    void *memory = numa_node >= 0 ? platform_reserve_memory_on_numa_node(capacity, (U32)numa_node) : platform_reserve_memory(capacity);
     if (!memory)
     {
         return false;
@@ -202,11 +496,35 @@ bool init_memory_arena(Memory_Arena *arena, U64 capacity, U64 min_allocation_siz
     arena->min_allocation_size = min_allocation_size;
     arena->size = min_allocation_size;
     arena->offset = 0;
+    arena->high_water_mark = 0;
+    arena->trim_high_water_mark = 0;
     arena->temp_count = 0;
+    arena->flags = flags;
 
     return true;
 }
 
+void trim_memory_arena(Memory_Arena *arena)
+{
+    HE_ASSERT(arena);
+
+    // large pages can not be decommitted.
+    if (arena->flags & MemoryArenaFlag_LargePages)
+    {
+        return;
+    }
+
+    U64 keep_size = align_up(HE_MAX(arena->trim_high_water_mark, arena->min_allocation_size), HE_MEMORY_ARENA_TRIM_GRANULARITY);
+    if (arena->size > keep_size && arena->size - keep_size >= arena->min_allocation_size)
+    {
+        bool decommited = platform_decommit_memory(arena->base + keep_size, arena->size - keep_size);
+        HE_ASSERT(decommited);
+        arena->size = keep_size;
+    }
+
+    arena->trim_high_water_mark = arena->offset;
+}
+
 HE_FORCE_INLINE static bool is_power_of_2(U16 value)
 {
     return (value & (value - 1)) == 0;
@@ -229,7 +547,7 @@ U64 get_number_of_bytes_to_align_address(uintptr_t address, U16 alignment)
     return result;
 }
 
-void* allocate(Memory_Arena *arena, U64 size, U16 alignment)
+void* allocate(Memory_Arena *arena, U64 size, U16 alignment, Allocation_Flags flags)
 {
     HE_ASSERT(arena);
     HE_ASSERT(size);
@@ -240,8 +558,10 @@ void* allocate(Memory_Arena *arena, U64 size, U16 alignment)
 
     if (arena->offset + allocation_size > arena->size)
     {
-        U64 commit_size = HE_MAX(allocation_size, arena->min_allocation_size);
-        HE_ASSERT(arena->size + commit_size <= arena->capacity);
+        // only the missing part is committed, the last step is clamped to the capacity.
+        U64 required_size = arena->offset + allocation_size - arena->size;
+        U64 commit_size = HE_MIN(HE_MAX(required_size, arena->min_allocation_size), arena->capacity - arena->size);
+        HE_ASSERT(commit_size >= required_size);
         bool commited = platform_commit_memory(arena->base + arena->size, commit_size);
         HE_ASSERT(commited);
         arena->size += commit_size;
@@ -249,7 +569,14 @@ void* allocate(Memory_Arena *arena, U64 size, U16 alignment)
 
     result = cursor + padding;
     arena->offset += allocation_size;
-    zero_memory(result, size);
+    arena->high_water_mark = HE_MAX(arena->high_water_mark, arena->offset);
+    arena->trim_high_water_mark = HE_MAX(arena->trim_high_water_mark, arena->offset);
+
+    if ((flags & AllocationFlag_Zero) || !((flags & AllocationFlag_NoZero) || (arena->flags & MemoryArenaFlag_NoZero)))
+    {
+        zero_memory(result, size);
+    }
+
     return result;
 }
 
@@ -271,6 +598,8 @@ void *reallocate(Memory_Arena *arena, void *memory, U64 old_size, U64 new_size,
         if (new_size > old_size)
         {
             arena->offset += new_size - old_size;
+            arena->high_water_mark = HE_MAX(arena->high_water_mark, arena->offset);
+            arena->trim_high_water_mark = HE_MAX(arena->trim_high_water_mark, arena->offset);
         }
         else
         {
@@ -289,9 +618,9 @@ void deallocate(Memory_Arena *arena, void *memory)
 {
 }
 
-void *memory_arena_allocate(void *memory_arena, U64 size, U16 alignment)
+void *memory_arena_allocate(void *memory_arena, U64 size, U16 alignment, Allocation_Flags flags)
 {
-    return allocate((Memory_Arena *)memory_arena, size, alignment);
+    return allocate((Memory_Arena *)memory_arena, size, alignment, flags);
 }
 
 void *memory_arena_reallocate(void *memory_arena, void *memory, U64 old_size, U64 new_size, U16 alignment)
@@ -328,78 +657,241 @@ void end_temprary_memory(Temprary_Memory temprary_memory)
 // Free List Allocator
 //
 
-static size_t calc_padding_with_header(uintptr_t ptr, uintptr_t alignment, uintptr_t header_size)
+#define HE_FREE_LIST_ALIGNMENT_LOG2 4
+#define HE_FREE_LIST_ALIGNMENT (1ull << HE_FREE_LIST_ALIGNMENT_LOG2)
+#define HE_FREE_LIST_FIRST_LEVEL_SHIFT (HE_FREE_LIST_SECOND_LEVEL_COUNT_LOG2 + HE_FREE_LIST_ALIGNMENT_LOG2)
+#define HE_FREE_LIST_SMALL_BLOCK_SIZE (1ull << HE_FREE_LIST_FIRST_LEVEL_SHIFT)
+#define HE_FREE_LIST_BLOCK_HEADER_SIZE offsetof(Free_List_Block, next_free)
+#define HE_FREE_LIST_MIN_BLOCK_SIZE sizeof(Free_List_Block)
+#define HE_FREE_LIST_BLOCK_FREE_BIT 1ull
+#define HE_FREE_LIST_BLOCK_TAG_SHIFT 48 // used blocks keep their memory tag above the size bits.
+#define HE_FREE_LIST_BLOCK_SIZE_MASK (((1ull << HE_FREE_LIST_BLOCK_TAG_SHIFT) - 1) & ~HE_FREE_LIST_BLOCK_FREE_BIT)
+
+static_assert(HE_FREE_LIST_BLOCK_HEADER_SIZE == HE_FREE_LIST_ALIGNMENT);
+static_assert(HE_DEFAULT_ALIGNMENT <= HE_FREE_LIST_ALIGNMENT);
+
+HE_FORCE_INLINE static U64 get_block_size(Free_List_Block *block)
+{
+    return block->size & HE_FREE_LIST_BLOCK_SIZE_MASK;
+}
+
+HE_FORCE_INLINE static U8 get_block_tag(Free_List_Block *block)
+{
+    return (U8)(block->size >> HE_FREE_LIST_BLOCK_TAG_SHIFT);
+}
+
+HE_FORCE_INLINE static void set_block_tag(Free_List_Block *block, U8 tag)
+{
+    block->size = get_block_size(block) | ((U64)tag << HE_FREE_LIST_BLOCK_TAG_SHIFT);
+}
+
+HE_FORCE_INLINE static bool is_block_free(Free_List_Block *block)
+{
+    return (block->size & HE_FREE_LIST_BLOCK_FREE_BIT) != 0;
+}
+
+HE_FORCE_INLINE static Free_List_Block *get_next_physical_block(Free_List_Block *block)
+{
+    return (Free_List_Block *)((U8 *)block + get_block_size(block));
+}
+
+HE_FORCE_INLINE static void *get_block_memory(Free_List_Block *block)
+{
+    return (U8 *)block + HE_FREE_LIST_BLOCK_HEADER_SIZE;
+}
+
+HE_FORCE_INLINE static Free_List_Block *get_memory_block(void *memory)
+{
+    return (Free_List_Block *)((U8 *)memory - HE_FREE_LIST_BLOCK_HEADER_SIZE);
+}
+
+HE_FORCE_INLINE static U64 get_block_size_for_allocation(U64 size)
+{
+    return HE_MAX(align_up(size + HE_FREE_LIST_BLOCK_HEADER_SIZE, HE_FREE_LIST_ALIGNMENT), HE_FREE_LIST_MIN_BLOCK_SIZE);
+}
+
+static void get_size_class(U64 size, U32 *out_first_level, U32 *out_second_level)
+{
+    if (size < HE_FREE_LIST_SMALL_BLOCK_SIZE)
+    {
+        *out_first_level = 0;
+        *out_second_level = (U32)(size >> HE_FREE_LIST_ALIGNMENT_LOG2);
+    }
+    else
+    {
+        U32 most_significant_bit = 63 - std::countl_zero(size);
+        *out_first_level = most_significant_bit - (HE_FREE_LIST_FIRST_LEVEL_SHIFT - 1);
+        *out_second_level = (U32)(size >> (most_significant_bit - HE_FREE_LIST_SECOND_LEVEL_COUNT_LOG2)) ^ HE_FREE_LIST_SECOND_LEVEL_COUNT;
+    }
+
+    HE_ASSERT(*out_first_level < HE_FREE_LIST_FIRST_LEVEL_COUNT);
+}
+
+// every block in the size class of the result is at least size bytes.
+static U64 round_up_to_size_class(U64 size)
+{
+    if (size >= HE_FREE_LIST_SMALL_BLOCK_SIZE)
+    {
+        U32 most_significant_bit = 63 - std::countl_zero(size);
+        U64 size_class_granularity = 1ull << (most_significant_bit - HE_FREE_LIST_SECOND_LEVEL_COUNT_LOG2);
+        size = align_up(size, size_class_granularity);
+    }
+    return size;
+}
+
+static void insert_free_block(Free_List_Allocator *allocator, Free_List_Block *block)
 {
-    HE_ASSERT(is_power_of_2((U16)alignment));
-    uintptr_t modulo = ptr & (alignment - 1); // same as ptr % alignment
+    U64 block_size = get_block_size(block);
 
-    uintptr_t padding = 0;
-    if (modulo != 0)
+    U32 first_level, second_level;
+    get_size_class(block_size, &first_level, &second_level);
+
+    Free_List_Block *head = allocator->free_lists[first_level][second_level];
+    block->size = block_size | HE_FREE_LIST_BLOCK_FREE_BIT;
+    block->next_free = head;
+    block->prev_free = nullptr;
+    if (head)
     {
-        padding = alignment - modulo;
+        head->prev_free = block;
     }
 
-    uintptr_t needed = header_size;
-    if (padding < needed)
+    allocator->free_lists[first_level][second_level] = block;
+    allocator->first_level_bitmap |= 1ull << first_level;
+    allocator->second_level_bitmaps[first_level] |= 1u << second_level;
+    allocator->free_block_count++;
+}
+
+static void remove_free_block(Free_List_Allocator *allocator, Free_List_Block *block)
+{
+    HE_ASSERT(is_block_free(block));
+    U64 block_size = get_block_size(block);
+
+    U32 first_level, second_level;
+    get_size_class(block_size, &first_level, &second_level);
+
+    if (block->prev_free)
     {
-        needed -= padding;
-        if ((needed & (alignment - 1)) == 0)
+        block->prev_free->next_free = block->next_free;
+    }
+    else
+    {
+        allocator->free_lists[first_level][second_level] = block->next_free;
+        if (!block->next_free)
         {
-            padding += alignment * (needed / alignment);
+            allocator->second_level_bitmaps[first_level] &= ~(1u << second_level);
+            if (!allocator->second_level_bitmaps[first_level])
+            {
+                allocator->first_level_bitmap &= ~(1ull << first_level);
+            }
         }
-        else
+    }
+
+    if (block->next_free)
+    {
+        block->next_free->prev_free = block->prev_free;
+    }
+
+    block->size = block_size;
+    allocator->free_block_count--;
+}
+
+static Free_List_Block *find_free_block(Free_List_Allocator *allocator, U64 size)
+{
+    U32 first_level, second_level;
+    get_size_class(round_up_to_size_class(size), &first_level, &second_level);
+
+    U32 second_level_bitmap = allocator->second_level_bitmaps[first_level] & (~0u << second_level);
+    if (!second_level_bitmap)
+    {
+        U64 first_level_bitmap = allocator->first_level_bitmap & (~0ull << (first_level + 1));
+        if (!first_level_bitmap)
         {
-            padding += alignment * (1 + (needed / alignment));
+            return nullptr;
         }
+
+        first_level = (U32)std::countr_zero(first_level_bitmap);
+        second_level_bitmap = allocator->second_level_bitmaps[first_level];
     }
-    return padding;
+
+    second_level = (U32)std::countr_zero(second_level_bitmap);
+    return allocator->free_lists[first_level][second_level];
 }
 
-static void insert_node(Free_List_Allocator *allocator, Free_List_Node *prev_node, Free_List_Node *new_node)
+// coalesces a block that is in no free list with its free neighbours and inserts the result.
+static void release_block(Free_List_Allocator *allocator, Free_List_Block *block)
 {
-    if (prev_node)
+    block->size = get_block_size(block); // drops the tag.
+
+    Free_List_Block *prev_block = block->prev_physical;
+    if (prev_block && is_block_free(prev_block))
     {
-        new_node->next = prev_node->next;
-        prev_node->next = new_node;
+        remove_free_block(allocator, prev_block);
+        prev_block->size += get_block_size(block);
+        block = prev_block;
     }
-    else
+
+    Free_List_Block *next_block = get_next_physical_block(block);
+    if (is_block_free(next_block))
     {
-        new_node->next = allocator->head;
-        allocator->head = new_node;
+        remove_free_block(allocator, next_block);
+        block->size = get_block_size(block) + get_block_size(next_block);
+        next_block = get_next_physical_block(block);
     }
 
-    HE_ASSERT(allocator->head->size);
+    next_block->prev_physical = block;
+    insert_free_block(allocator, block);
 }
 
-static void remove_node(Free_List_Allocator *allocator, Free_List_Node *prev_node, Free_List_Node *node)
+// the block is in no free list, the remainder past size is released if it can hold a block.
+static void split_block(Free_List_Allocator *allocator, Free_List_Block *block, U64 size)
 {
-    if (prev_node)
-    {
-        prev_node->next = node->next;
-    }
-    else
+    U64 block_size = get_block_size(block);
+    if (block_size < size + HE_FREE_LIST_MIN_BLOCK_SIZE)
     {
-        allocator->head = node->next;
+        return;
     }
 
-    HE_ASSERT(allocator->head->size);
+    Free_List_Block *remainder = (Free_List_Block *)((U8 *)block + size);
+    remainder->prev_physical = block;
+    remainder->size = block_size - size;
+    block->size = size;
+    get_next_physical_block(remainder)->prev_physical = remainder;
+    release_block(allocator, remainder);
 }
 
-static void merge(Free_List_Allocator *allocator, Free_List_Node *prev_node, Free_List_Node *node)
+static bool grow_free_list_allocator(Free_List_Allocator *allocator, U64 size)
 {
-    HE_ASSERT(prev_node);
-    HE_ASSERT(node);
-    if ((U8 *)prev_node + prev_node->size == (U8 *)node)
+    U64 commit_size = align_up(HE_MAX(size, allocator->min_allocation_size), HE_FREE_LIST_ALIGNMENT);
+    if (allocator->size + commit_size > allocator->capacity)
+    {
+        return false;
+    }
+
+    HE_ASSERT((U8 *)allocator->sentinel + HE_FREE_LIST_BLOCK_HEADER_SIZE == allocator->base + allocator->size);
+    if (!platform_commit_memory(allocator->base + allocator->size, commit_size))
     {
-        prev_node->size += node->size;
-        remove_node(allocator, prev_node, node);
+        return false;
     }
+
+    allocator->size += commit_size;
+
+    // the old sentinel becomes the header of the new block.
+    Free_List_Block *block = allocator->sentinel;
+    block->size = commit_size;
+
+    Free_List_Block *sentinel = get_next_physical_block(block);
+    sentinel->prev_physical = block;
+    sentinel->size = 0;
+    allocator->sentinel = sentinel;
+
+    release_block(allocator, block);
+    return true;
 }
 
-bool init_free_list_allocator(Free_List_Allocator *allocator, void *memory, U64 capacity, U64 size, const char *debug_name)
+bool init_free_list_allocator(Free_List_Allocator *allocator, void *memory, U64 capacity, U64 size, const char *debug_name, Memory_Tag tag)
 {
     HE_ASSERT(allocator);
-    HE_ASSERT(size >= sizeof(Free_List_Node));
+    HE_ASSERT(size >= HE_FREE_LIST_MIN_BLOCK_SIZE + HE_FREE_LIST_ALIGNMENT + HE_FREE_LIST_BLOCK_HEADER_SIZE);
     HE_ASSERT(capacity >= size);
 
     if (!memory)
@@ -417,17 +909,29 @@ bool init_free_list_allocator(Free_List_Allocator *allocator, void *memory, U64
         }
     }
 
+    zero_memory(allocator, sizeof(Free_List_Allocator));
+
     allocator->base = (U8 *)memory;
     allocator->capacity = capacity;
     allocator->min_allocation_size = size;
     allocator->size = size;
     allocator->used = 0;
     allocator->debug_name = debug_name;
+    allocator->tag = tag;
+
+    U8 *begin = (U8 *)align_up((uintptr_t)memory, HE_FREE_LIST_ALIGNMENT);
+    U8 *end = (U8 *)(((uintptr_t)memory + size) & ~(HE_FREE_LIST_ALIGNMENT - 1));
+
+    Free_List_Block *first_block = (Free_List_Block *)begin;
+    first_block->prev_physical = nullptr;
+    first_block->size = (U64)(end - begin) - HE_FREE_LIST_BLOCK_HEADER_SIZE;
 
-    Free_List_Node *first_free_node = (Free_List_Node *)allocator->base;
-    first_free_node->size = size;
-    first_free_node->next = nullptr;
-    allocator->head = first_free_node;
+    Free_List_Block *sentinel = get_next_physical_block(first_block);
+    sentinel->prev_physical = first_block;
+    sentinel->size = 0;
+    allocator->sentinel = sentinel;
+
+    release_block(allocator, first_block);
 
     bool mutex_created = platform_create_mutex(&allocator->mutex);
     HE_ASSERT(mutex_created);
@@ -435,186 +939,878 @@ bool init_free_list_allocator(Free_List_Allocator *allocator, void *memory, U64
     return true;
 }
 
-struct Free_List_Allocation_Header
+static void dump_free_list_allocator(Free_List_Allocator *allocator)
 {
-    U64 size;
-    U64 padding;
-};
-
-static_assert(sizeof(Free_List_Allocation_Header) == sizeof(Free_List_Node));
-
-static void dump_free_list_allocator(Free_List_Allocator *allocator) {
     HE_LOG(Core, Debug, "dumping allocator %s\n", allocator->debug_name);
-    for (Free_List_Node *node = allocator->head; node; node = node->next) {
-        HE_LOG(Core, Debug, "node: addr -> %p, size -> %d\n", (void *)node, node->size);
+    for (Free_List_Block *block = (Free_List_Block *)align_up((uintptr_t)allocator->base, HE_FREE_LIST_ALIGNMENT); block != allocator->sentinel; block = get_next_physical_block(block))
+    {
+        HE_LOG(Core, Debug, "block: addr -> %p, size -> %llu, free -> %d\n", (void *)block, get_block_size(block), is_block_free(block));
     }
 }
 
-static void* allocate_internal(Free_List_Allocator *allocator, U64 size, U16 alignment)
+static void* allocate_internal(Free_List_Allocator *allocator, U64 size, U16 alignment, U8 tag, Allocation_Flags flags = AllocationFlag_None)
 {
     HE_ASSERT(allocator);
     HE_ASSERT(size);
 
-    Free_List_Node *alloc_node = nullptr;
-    Free_List_Node *prev_node = nullptr;
-    U64 padding = 0;
-    U64 required_size = 0;
+    U64 block_size = get_block_size_for_allocation(size);
+
+    // over aligned allocations need room to split off a leading free block.
+    U64 search_size = block_size;
+    if (alignment > HE_FREE_LIST_ALIGNMENT)
+    {
+        HE_ASSERT(is_power_of_2(alignment));
+        search_size += alignment + HE_FREE_LIST_MIN_BLOCK_SIZE;
+    }
 
-    for (Free_List_Node *node = allocator->head; node; node = node->next)
+    Free_List_Block *block = find_free_block(allocator, search_size);
+    if (!block && grow_free_list_allocator(allocator, round_up_to_size_class(search_size)))
     {
-        padding = calc_padding_with_header((uintptr_t)node, (uintptr_t)alignment, sizeof(Free_List_Allocation_Header));
-        required_size = size + padding;
+        block = find_free_block(allocator, search_size);
+    }
+
+    HE_ASSERT(block);
+    remove_free_block(allocator, block);
+
+    if (alignment > HE_FREE_LIST_ALIGNMENT)
+    {
+        uintptr_t memory = (uintptr_t)get_block_memory(block);
+        U64 gap = align_up(memory, alignment) - memory;
+        if (gap && gap < HE_FREE_LIST_MIN_BLOCK_SIZE)
+        {
+            gap = align_up(memory + HE_FREE_LIST_MIN_BLOCK_SIZE, alignment) - memory;
+        }
 
-        if (node->size >= required_size)
+        if (gap)
         {
-            alloc_node = node;
-            break;
+            Free_List_Block *aligned_block = (Free_List_Block *)((U8 *)block + gap);
+            aligned_block->prev_physical = block;
+            aligned_block->size = get_block_size(block) - gap;
+            get_next_physical_block(aligned_block)->prev_physical = aligned_block;
+            block->size = gap;
+            release_block(allocator, block);
+            block = aligned_block;
         }
+    }
+
+    split_block(allocator, block, block_size);
+    set_block_tag(block, tag);
+
+    allocator->used += get_block_size(block);
+    allocator->allocation_count++;
+    record_memory_tag_allocation(tag, get_block_size(block));
+
+    // the whole block is zeroed so growing in place keeps the bytes past the allocation zero, no zero allocations still zero the tail.
+    U8 *result = (U8 *)get_block_memory(block);
+    U64 usable_size = get_block_size(block) - HE_FREE_LIST_BLOCK_HEADER_SIZE;
+    U64 zero_offset = (flags & AllocationFlag_NoZero) ? size : 0;
+    if (usable_size > zero_offset)
+    {
+        zero_memory(result + zero_offset, usable_size - zero_offset);
+    }
+    return result;
+}
+
+static void deallocate_internal(Free_List_Allocator *allocator, void *memory)
+{
+    if (!memory)
+    {
+        return;
+    }
+
+    HE_ASSERT((U8*)memory >= allocator->base && (U8*)memory < allocator->base + allocator->size);
 
-        prev_node = node;
+    Free_List_Block *block = get_memory_block(memory);
+    HE_ASSERT(!is_block_free(block));
+
+    allocator->used -= get_block_size(block);
+    allocator->allocation_count--;
+    record_memory_tag_deallocation(get_block_tag(block), get_block_size(block));
+    release_block(allocator, block);
+}
+
+static void* reallocate_internal(Free_List_Allocator *allocator, void *memory, U64 new_size, U16 alignment, U8 tag)
+{
+    if (!memory)
+    {
+        return allocate_internal(allocator, new_size, alignment, tag);
     }
 
-    HE_ASSERT(alloc_node);
+    HE_ASSERT((U8*)memory >= allocator->base && (U8*)memory < allocator->base + allocator->size);
+    HE_ASSERT(new_size);
+
+    Free_List_Block *block = get_memory_block(memory);
+    HE_ASSERT(!is_block_free(block));
 
-    U64 remaining = alloc_node->size - required_size;
-    if (remaining > sizeof(Free_List_Node))
+    // the allocation keeps its tag when it moves.
+    tag = get_block_tag(block);
+
+    U64 block_size = get_block_size(block);
+    U64 used_block_size = block_size;
+    U64 new_block_size = get_block_size_for_allocation(new_size);
+    bool is_aligned = alignment <= HE_FREE_LIST_ALIGNMENT || ((uintptr_t)memory & (alignment - 1)) == 0;
+
+    if (is_aligned)
     {
-        Free_List_Node *new_node = (Free_List_Node *)((U8 *)alloc_node + required_size);
-        new_node->size = remaining;
-        insert_node(allocator, alloc_node, new_node);
+        U8 *grown_begin = nullptr;
+
+        Free_List_Block *next_block = get_next_physical_block(block);
+        if (new_block_size > block_size && is_block_free(next_block) && block_size + get_block_size(next_block) >= new_block_size)
+        {
+            U64 next_block_size = get_block_size(next_block);
+            remove_free_block(allocator, next_block);
+            grown_begin = (U8 *)next_block;
+
+            block->size = block_size + next_block_size;
+            get_next_physical_block(block)->prev_physical = block;
+            block_size = block->size;
+        }
+
+        if (new_block_size <= block_size)
+        {
+            split_block(allocator, block, new_block_size);
+
+            // only the part of the next block that was taken is zeroed, it can be the whole free tail of the committed heap.
+            U8 *block_end = (U8 *)get_next_physical_block(block);
+            U64 usable_size = get_block_size(block) - HE_FREE_LIST_BLOCK_HEADER_SIZE;
+            if (grown_begin)
+            {
+                zero_memory(grown_begin, (U64)(block_end - grown_begin));
+            }
+            else if (usable_size > new_size)
+            {
+                zero_memory((U8 *)memory + new_size, usable_size - new_size);
+            }
+
+            set_block_tag(block, tag);
+            allocator->used = allocator->used - used_block_size + get_block_size(block);
+            record_memory_tag_deallocation(tag, used_block_size);
+            record_memory_tag_allocation(tag, get_block_size(block));
+            return memory;
+        }
     }
 
-    remove_node(allocator, prev_node, alloc_node);
+    void *new_memory = allocate_internal(allocator, new_size, alignment, tag);
+    copy_memory(new_memory, memory, HE_MIN(block_size - HE_FREE_LIST_BLOCK_HEADER_SIZE, new_size));
+    deallocate_internal(allocator, memory);
+    return new_memory;
+}
+
+HE_FORCE_INLINE static U8 get_allocation_tag(Free_List_Allocator *allocator)
+{
+    return (U8)(allocator->tag != Memory_Tag::COUNT ? allocator->tag : get_current_memory_tag());
+}
+
+// internal allocations like thread cache spans are not charged to any tag.
+static void* allocate_untracked(Free_List_Allocator *allocator, U64 size, U16 alignment)
+{
+    platform_lock_mutex(&allocator->mutex);
+    void *result = allocate_internal(allocator, size, alignment, HE_MEMORY_TAG_UNTRACKED);
+    platform_unlock_mutex(&allocator->mutex);
+    return result;
+}
+
+#if HE_FREE_LIST_ALLOCATOR_STATS
 
-    Free_List_Allocation_Header *header = (Free_List_Allocation_Header *)((U8 *)alloc_node + padding - sizeof(Free_List_Allocation_Header));
-    header->size = required_size;
-    header->padding = padding;
+HE_FORCE_INLINE static void record_call_ticks(U64 begin, U64 *call_count, U64 *total_ticks, U64 *max_ticks)
+{
+    U64 ticks = platform_get_performance_counter() - begin;
+    (*call_count)++;
+    *total_ticks += ticks;
+    *max_ticks = HE_MAX(*max_ticks, ticks);
+}
 
-    allocator->used += required_size;
+#endif
 
-    void *result = (void *)((U8 *)alloc_node + padding);
-    zero_memory(result, size);
+void* allocate(Free_List_Allocator *allocator, U64 size, U16 alignment, Allocation_Flags flags)
+{
+#if HE_FREE_LIST_ALLOCATOR_STATS
+    U64 begin = platform_get_performance_counter();
+#endif
 
+    platform_lock_mutex(&allocator->mutex);
+    void *result = allocate_internal(allocator, size, alignment, get_allocation_tag(allocator), flags);
+
+#if HE_FREE_LIST_ALLOCATOR_STATS
+    record_call_ticks(begin, &allocator->allocate_call_count, &allocator->allocate_ticks, &allocator->max_allocate_ticks);
+#endif
+
+    platform_unlock_mutex(&allocator->mutex);
     return result;
 }
 
-void* allocate(Free_List_Allocator *allocator, U64 size, U16 alignment)
+void deallocate(Free_List_Allocator *allocator, void *memory)
+{
+#if HE_FREE_LIST_ALLOCATOR_STATS
+    U64 begin = platform_get_performance_counter();
+#endif
+
+    platform_lock_mutex(&allocator->mutex);
+    deallocate_internal(allocator, memory);
+
+#if HE_FREE_LIST_ALLOCATOR_STATS
+    record_call_ticks(begin, &allocator->deallocate_call_count, &allocator->deallocate_ticks, &allocator->max_deallocate_ticks);
+#endif
+
+    platform_unlock_mutex(&allocator->mutex);
+}
+
+void* reallocate(Free_List_Allocator *allocator, void *memory, U64 _, U64 new_size, U16 alignment)
 {
+#if HE_FREE_LIST_ALLOCATOR_STATS
+    U64 begin = platform_get_performance_counter();
+#endif
+
     platform_lock_mutex(&allocator->mutex);
-    void *result = allocate_internal(allocator, size, alignment);
+    void *result = reallocate_internal(allocator, memory, new_size, alignment, get_allocation_tag(allocator));
+
+#if HE_FREE_LIST_ALLOCATOR_STATS
+    record_call_ticks(begin, &allocator->allocate_call_count, &allocator->allocate_ticks, &allocator->max_allocate_ticks);
+#endif
+
     platform_unlock_mutex(&allocator->mutex);
     return result;
 }
 
-static void deallocate_internal(Free_List_Allocator *allocator, void *memory)
+void get_free_list_allocator_stats(Free_List_Allocator *allocator, Free_List_Allocator_Stats *out_stats)
 {
-    if (!memory)
+    HE_ASSERT(allocator);
+    HE_ASSERT(out_stats);
+
+    platform_lock_mutex(&allocator->mutex);
+
+    zero_memory(out_stats, sizeof(Free_List_Allocator_Stats));
+    out_stats->capacity = allocator->capacity;
+    out_stats->committed_size = allocator->size;
+    out_stats->used_size = allocator->used;
+    out_stats->allocation_count = allocator->allocation_count;
+    out_stats->free_block_count = allocator->free_block_count;
+
+    U8 *begin = (U8 *)align_up((uintptr_t)allocator->base, HE_FREE_LIST_ALIGNMENT);
+    out_stats->free_size = (U64)((U8 *)allocator->sentinel - begin) - allocator->used;
+
+    // the largest block is in the highest non empty size class.
+    if (allocator->first_level_bitmap)
     {
-        return;
+        U32 first_level = 63 - std::countl_zero(allocator->first_level_bitmap);
+        U32 second_level = 31 - std::countl_zero(allocator->second_level_bitmaps[first_level]);
+        for (Free_List_Block *block = allocator->free_lists[first_level][second_level]; block; block = block->next_free)
+        {
+            out_stats->largest_free_block_size = HE_MAX(out_stats->largest_free_block_size, get_block_size(block));
+        }
+    }
+
+    if (out_stats->free_size)
+    {
+        out_stats->fragmentation = 1.0f - (F32)((F64)out_stats->largest_free_block_size / (F64)out_stats->free_size);
     }
 
-    HE_ASSERT((U8*)memory >= allocator->base && (U8*)memory <= allocator->base + allocator->size);
+#if HE_FREE_LIST_ALLOCATOR_STATS
+    F64 ns_per_tick = 1000000000.0 / (F64)platform_get_performance_frequency();
+    if (allocator->allocate_call_count)
+    {
+        out_stats->average_allocate_ns = (F64)allocator->allocate_ticks * ns_per_tick / (F64)allocator->allocate_call_count;
+    }
+    if (allocator->deallocate_call_count)
+    {
+        out_stats->average_deallocate_ns = (F64)allocator->deallocate_ticks * ns_per_tick / (F64)allocator->deallocate_call_count;
+    }
+    out_stats->max_allocate_ns = (F64)allocator->max_allocate_ticks * ns_per_tick;
+    out_stats->max_deallocate_ns = (F64)allocator->max_deallocate_ticks * ns_per_tick;
+#endif
+
+    platform_unlock_mutex(&allocator->mutex);
+}
+
+void *free_list_allocator_allocate(void *free_list_allocator, U64 size, U16 alignment, Allocation_Flags flags)
+{
+    return allocate((Free_List_Allocator *)free_list_allocator, size, alignment, flags);
+}
+
+void *free_list_allocator_reallocate(void *free_list_allocator, void *memory, U64 old_size, U64 new_size, U16 alignment)
+{
+    return reallocate((Free_List_Allocator *)free_list_allocator, memory, old_size, new_size, alignment);
+}
+
+void free_list_allocator_deallocate(void *free_list_allocator, void *memory)
+{
+    return deallocate((Free_List_Allocator *)free_list_allocator, memory);
+}
+//
+// Thread Cached Allocator
+//
+
+#define HE_THREAD_CACHE_SPAN_HEADER_SIZE 64
+
+struct Thread_Cache_Free_Object
+{
+    Thread_Cache_Free_Object *next;
+};
+
+// spans are never shared between tags so a free knows what to charge from the span header alone.
+#if HE_MEMORY_TAGGING
+#define HE_THREAD_CACHE_TAG_COUNT ((U32)Memory_Tag::COUNT)
+#else
+#define HE_THREAD_CACHE_TAG_COUNT 1
+#endif
+
+struct Thread_Cache_Span
+{
+    Thread_Allocation_Cache *owner;
+    U32 size_class;
+    U32 tag;
+};
+
+static_assert(sizeof(Thread_Cache_Span) <= HE_THREAD_CACHE_SPAN_HEADER_SIZE);
+
+struct Thread_Allocation_Cache
+{
+    Thread_Cached_Allocator *allocator;
+    Thread_Cache_Free_Object *free_lists[HE_THREAD_CACHE_TAG_COUNT][HE_THREAD_CACHE_SIZE_CLASS_COUNT];
+
+    // objects not handed out yet in the current span of each size class.
+    U8 *span_cursors[HE_THREAD_CACHE_TAG_COUNT][HE_THREAD_CACHE_SIZE_CLASS_COUNT];
+    U8 *span_ends[HE_THREAD_CACHE_TAG_COUNT][HE_THREAD_CACHE_SIZE_CLASS_COUNT];
+
+    Thread_Allocation_Cache *next_cache;
+    Thread_Allocation_Cache *next_free_cache;
+
+#if HE_MEMORY_TAGGING
+    // only written by the thread using the cache, frees from other threads are charged to the freeing thread's cache.
+    Memory_Tag_Counters tag_counters[(U32)Memory_Tag::COUNT];
+    std::atomic< U64 > allocation_size_counts[HE_ALLOCATION_SIZE_BUCKET_COUNT];
+#endif
+
+    alignas(64) std::atomic< Thread_Cache_Free_Object * > remote_free_list;
+};
+
+static constexpr U32 thread_cache_size_class_sizes[HE_THREAD_CACHE_SIZE_CLASS_COUNT] =
+{
+    16, 32, 48, 64, 80, 96, 112, 128,
+    160, 192, 224, 256,
+    320, 384, 448, 512,
+    640, 768, 896, 1024
+};
+
+static std::atomic< U32 > thread_cached_allocator_count;
 
-    Free_List_Allocation_Header *header = (Free_List_Allocation_Header *)((U8*)memory - sizeof(Free_List_Allocation_Header));
+struct Thread_Allocation_Caches
+{
+    Thread_Allocation_Cache *caches[HE_MAX_THREAD_CACHED_ALLOCATOR_COUNT];
+
+    ~Thread_Allocation_Caches();
+};
 
-    HE_ASSERT(header->padding >= sizeof(Free_List_Allocation_Header));
-    HE_ASSERT(header->size > 0);
+static thread_local Thread_Allocation_Caches thread_allocation_caches;
 
-    for (Free_List_Node *node = allocator->head; node; node = node->next)
+// 16 byte steps up to 128 then 4 classes per power of two.
+HE_FORCE_INLINE static U32 get_thread_cache_size_class(U64 size)
+{
+    if (size <= 128)
     {
-        HE_ASSERT((U8*)memory < (U8*)node || (U8*)memory > (U8*)node + node->size);
+        return (U32)((size + 15) >> 4) - 1;
     }
 
-    U64 size = header->size;
-    U64 padding = header->padding;
+    U32 most_significant_bit = 63 - std::countl_zero(size - 1);
+    return 8 + (most_significant_bit - 7) * 4 + (U32)((size - 1) >> (most_significant_bit - 2)) - 4;
+}
+
+HE_FORCE_INLINE static U32 get_thread_cache_tag()
+{
+#if HE_MEMORY_TAGGING
+    return (U32)current_memory_tag;
+#else
+    return 0;
+#endif
+}
+
+HE_FORCE_INLINE static void record_thread_cache_allocation(Thread_Allocation_Cache *cache, U32 tag, U64 size)
+{
+#if HE_MEMORY_TAGGING
+    Memory_Tag_Counters *counters = &cache->tag_counters[tag];
+    counters->live_bytes.store(counters->live_bytes.load(std::memory_order_relaxed) + (S64)size, std::memory_order_relaxed);
+    counters->allocation_count.store(counters->allocation_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    counters->allocated_bytes.store(counters->allocated_bytes.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+#endif
+}
 
-    Free_List_Node *free_node = (Free_List_Node *)((U8 *)memory - padding);
-    free_node->size = size;
-    free_node->next = nullptr;
+HE_FORCE_INLINE static void record_thread_cache_allocation_size(Thread_Allocation_Cache *cache, U64 size)
+{
+#if HE_MEMORY_TAGGING
+    U32 bucket = HE_MIN((U32)(63 - std::countl_zero(size)), (U32)HE_ALLOCATION_SIZE_BUCKET_COUNT - 1);
+    std::atomic< U64 > *counter = &cache->allocation_size_counts[bucket];
+    counter->store(counter->load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+#endif
+}
 
-    Free_List_Node *prev_node = nullptr;
-    for (Free_List_Node *node = allocator->head; node; node = node->next)
+HE_FORCE_INLINE static void record_thread_cache_deallocation(Thread_Allocation_Cache *cache, U32 tag, U64 size)
+{
+#if HE_MEMORY_TAGGING
+    Memory_Tag_Counters *counters = &cache->tag_counters[tag];
+    counters->live_bytes.store(counters->live_bytes.load(std::memory_order_relaxed) - (S64)size, std::memory_order_relaxed);
+#endif
+}
+
+Thread_Allocation_Caches::~Thread_Allocation_Caches()
+{
+    for (U32 allocator_index = 0; allocator_index < HE_MAX_THREAD_CACHED_ALLOCATOR_COUNT; allocator_index++)
     {
-        if ((U8 *)node > (U8 *)memory)
+        Thread_Allocation_Cache *cache = caches[allocator_index];
+        if (!cache)
         {
-            insert_node(allocator, prev_node, free_node);
-            break;
+            continue;
         }
-        prev_node = node;
+
+        // the cache keeps its spans and free objects, frees from other threads keep arriving until a new thread adopts it.
+        Thread_Cached_Allocator *allocator = cache->allocator;
+        platform_lock_mutex(&allocator->mutex);
+        cache->next_free_cache = allocator->free_caches;
+        allocator->free_caches = cache;
+        platform_unlock_mutex(&allocator->mutex);
+
+        caches[allocator_index] = nullptr;
     }
+}
 
-    allocator->used -= size;
-    if (prev_node)
+static Thread_Allocation_Cache *get_thread_allocation_cache(Thread_Cached_Allocator *allocator)
+{
+    Thread_Allocation_Cache *&cache = thread_allocation_caches.caches[allocator->index];
+    if (cache)
     {
-        merge(allocator, prev_node, free_node);
+        return cache;
     }
 
-    if (free_node->next)
+    platform_lock_mutex(&allocator->mutex);
+    cache = allocator->free_caches;
+    if (cache)
     {
-        merge(allocator, free_node, free_node->next);
+        allocator->free_caches = cache->next_free_cache;
+    }
+    platform_unlock_mutex(&allocator->mutex);
+
+    if (!cache)
+    {
+        cache = (Thread_Allocation_Cache *)allocate_untracked(allocator->heap, sizeof(Thread_Allocation_Cache), alignof(Thread_Allocation_Cache));
+        cache->allocator = allocator;
+
+        platform_lock_mutex(&allocator->mutex);
+        cache->next_cache = allocator->caches;
+        allocator->caches = cache;
+        platform_unlock_mutex(&allocator->mutex);
     }
+
+    return cache;
 }
 
-void deallocate(Free_List_Allocator *allocator, void *memory)
+bool init_thread_cached_allocator(Thread_Cached_Allocator *allocator, Free_List_Allocator *heap)
 {
-    platform_lock_mutex(&allocator->mutex);
-    deallocate_internal(allocator, memory);
-    platform_unlock_mutex(&allocator->mutex);
+    HE_ASSERT(allocator);
+    HE_ASSERT(heap);
+
+    U32 index = thread_cached_allocator_count.fetch_add(1);
+    if (index >= HE_MAX_THREAD_CACHED_ALLOCATOR_COUNT)
+    {
+        return false;
+    }
+
+    allocator->index = index;
+    allocator->heap = heap;
+    allocator->caches = nullptr;
+    allocator->free_caches = nullptr;
+
+    U64 granule_count = (heap->capacity >> HE_THREAD_CACHE_SPAN_SIZE_LOG2) + 2;
+    allocator->span_bitmap_word_count = (granule_count + 63) / 64;
+    allocator->span_bitmap = (std::atomic< U64 > *)allocate_untracked(heap, sizeof(std::atomic< U64 >) * allocator->span_bitmap_word_count, alignof(std::atomic< U64 >));
+    if (!allocator->span_bitmap)
+    {
+        return false;
+    }
+
+    bool mutex_created = platform_create_mutex(&allocator->mutex);
+    HE_ASSERT(mutex_created);
+
+    return true;
 }
 
-void* reallocate(Free_List_Allocator *allocator, void *memory, U64 _, U64 new_size, U16 alignment)
+static Thread_Cache_Span *get_thread_cache_span(Thread_Cached_Allocator *allocator, void *memory)
 {
-    if (!memory)
+    Free_List_Allocator *heap = allocator->heap;
+    if ((U8 *)memory < heap->base || (U8 *)memory >= heap->base + heap->capacity)
     {
-        platform_lock_mutex(&allocator->mutex);
-        void *result = allocate_internal(allocator, new_size, alignment);
-        platform_unlock_mutex(&allocator->mutex);
-        return result;
+        return nullptr;
     }
 
-    platform_lock_mutex(&allocator->mutex);
+    U64 granule = ((uintptr_t)memory >> HE_THREAD_CACHE_SPAN_SIZE_LOG2) - ((uintptr_t)heap->base >> HE_THREAD_CACHE_SPAN_SIZE_LOG2);
+    U64 word = allocator->span_bitmap[granule / 64].load(std::memory_order_relaxed);
+    if ((word & (1ull << (granule % 64))) == 0)
+    {
+        return nullptr;
+    }
+
+    return (Thread_Cache_Span *)((uintptr_t)memory & ~(HE_THREAD_CACHE_SPAN_SIZE - 1));
+}
+
+static void collect_remote_frees(Thread_Allocation_Cache *cache)
+{
+    Thread_Cache_Free_Object *object = cache->remote_free_list.exchange(nullptr, std::memory_order_acquire);
+    while (object)
+    {
+        Thread_Cache_Free_Object *next = object->next;
+        Thread_Cache_Span *span = (Thread_Cache_Span *)((uintptr_t)object & ~(HE_THREAD_CACHE_SPAN_SIZE - 1));
+        object->next = cache->free_lists[span->tag][span->size_class];
+        cache->free_lists[span->tag][span->size_class] = object;
+        object = next;
+    }
+}
+
+static void* refill_thread_allocation_cache(Thread_Allocation_Cache *cache, U32 tag, U32 size_class)
+{
+    collect_remote_frees(cache);
+
+    Thread_Cache_Free_Object *object = cache->free_lists[tag][size_class];
+    if (object)
+    {
+        cache->free_lists[tag][size_class] = object->next;
+        return object;
+    }
+
+    U64 object_size = thread_cache_size_class_sizes[size_class];
+    U8 *cursor = cache->span_cursors[tag][size_class];
+    if (!cursor || cursor + object_size > cache->span_ends[tag][size_class])
+    {
+        Thread_Cached_Allocator *allocator = cache->allocator;
+        Free_List_Allocator *heap = allocator->heap;
 
+        Thread_Cache_Span *span = (Thread_Cache_Span *)allocate_untracked(heap, HE_THREAD_CACHE_SPAN_SIZE, (U16)HE_THREAD_CACHE_SPAN_SIZE);
+        span->owner = cache;
+        span->size_class = size_class;
+        span->tag = tag;
+
+        U64 granule = ((uintptr_t)span >> HE_THREAD_CACHE_SPAN_SIZE_LOG2) - ((uintptr_t)heap->base >> HE_THREAD_CACHE_SPAN_SIZE_LOG2);
+        allocator->span_bitmap[granule / 64].fetch_or(1ull << (granule % 64), std::memory_order_relaxed);
+
+        cursor = (U8 *)span + HE_THREAD_CACHE_SPAN_HEADER_SIZE;
+        cache->span_ends[tag][size_class] = (U8 *)span + HE_THREAD_CACHE_SPAN_SIZE;
+    }
+
+    cache->span_cursors[tag][size_class] = cursor + object_size;
+    return cursor;
+}
+
+void* allocate(Thread_Cached_Allocator *allocator, U64 size, U16 alignment, Allocation_Flags flags)
+{
     HE_ASSERT(allocator);
-    HE_ASSERT(memory >= allocator->base && memory <= allocator->base + allocator->size);
-    HE_ASSERT(new_size);
+    HE_ASSERT(size);
+
+    if (size > HE_THREAD_CACHE_MAX_ALLOCATION_SIZE || alignment > HE_DEFAULT_ALIGNMENT)
+    {
+#if HE_MEMORY_TAGGING
+        // threads that only make large allocations don't get a cache just for the histogram.
+        Thread_Allocation_Cache *cache = thread_allocation_caches.caches[allocator->index];
+        if (cache)
+        {
+            record_thread_cache_allocation_size(cache, size);
+        }
+#endif
+        return allocate(allocator->heap, size, alignment, flags);
+    }
+
+    Thread_Allocation_Cache *cache = get_thread_allocation_cache(allocator);
+    record_thread_cache_allocation_size(cache, size);
+    U32 tag = get_thread_cache_tag();
+    U32 size_class = get_thread_cache_size_class(size);
+    U64 object_size = thread_cache_size_class_sizes[size_class];
+
+    void *result = cache->free_lists[tag][size_class];
+    if (result)
+    {
+        cache->free_lists[tag][size_class] = cache->free_lists[tag][size_class]->next;
+    }
+    else
+    {
+        result = refill_thread_allocation_cache(cache, tag, size_class);
+    }
+
+    record_thread_cache_allocation(cache, tag, object_size);
+
+    // no zero allocations still zero the tail for reallocate.
+    U64 zero_offset = (flags & AllocationFlag_NoZero) ? size : 0;
+    if (object_size > zero_offset)
+    {
+        zero_memory((U8 *)result + zero_offset, object_size - zero_offset);
+    }
+    return result;
+}
+
+void deallocate(Thread_Cached_Allocator *allocator, void *memory)
+{
+    if (!memory)
+    {
+        return;
+    }
 
-    Free_List_Allocation_Header *header = (Free_List_Allocation_Header *)((U8*)memory - sizeof(Free_List_Allocation_Header));
-    HE_ASSERT(header->size >= 0);
-    HE_ASSERT(header->padding >= 0);
-    HE_ASSERT(header->padding < allocator->size);
-    HE_ASSERT(new_size != header->size);
+    Thread_Cache_Span *span = get_thread_cache_span(allocator, memory);
+    if (!span)
+    {
+        deallocate(allocator->heap, memory);
+        return;
+    }
+
+    Thread_Cache_Free_Object *object = (Thread_Cache_Free_Object *)memory;
+    Thread_Allocation_Cache *cache = span->owner;
+    U64 object_size = thread_cache_size_class_sizes[span->size_class];
+
+    if (cache == thread_allocation_caches.caches[allocator->index])
+    {
+        record_thread_cache_deallocation(cache, span->tag, object_size);
+        object->next = cache->free_lists[span->tag][span->size_class];
+        cache->free_lists[span->tag][span->size_class] = object;
+        return;
+    }
+
+#if HE_MEMORY_TAGGING
+    record_thread_cache_deallocation(get_thread_allocation_cache(allocator), span->tag, object_size);
+#endif
+
+    Thread_Cache_Free_Object *head = cache->remote_free_list.load(std::memory_order_relaxed);
+    do
+    {
+        object->next = head;
+    }
+    while (!cache->remote_free_list.compare_exchange_weak(head, object, std::memory_order_release, std::memory_order_relaxed));
+}
 
-    U64 old_size = header->size - header->padding;
-    if (old_size == new_size)
+void* reallocate(Thread_Cached_Allocator *allocator, void *memory, U64 old_size, U64 new_size, U16 alignment)
+{
+    if (!memory)
     {
+        return allocate(allocator, new_size, alignment);
+    }
+
+    Thread_Cache_Span *span = get_thread_cache_span(allocator, memory);
+    if (!span)
+    {
+        return reallocate(allocator->heap, memory, old_size, new_size, alignment);
+    }
+
+    U64 object_size = thread_cache_size_class_sizes[span->size_class];
+    if (new_size <= object_size && alignment <= HE_DEFAULT_ALIGNMENT)
+    {
+        // keeps the bytes past the allocation zero like a fresh one.
+        zero_memory((U8 *)memory + new_size, object_size - new_size);
         return memory;
     }
 
-    for (Free_List_Node *node = allocator->head; node; node = node->next)
+    void *new_memory = allocate(allocator, new_size, alignment);
+    copy_memory(new_memory, memory, HE_MIN(object_size, new_size));
+    deallocate(allocator, memory);
+    return new_memory;
+}
+
+void *thread_cached_allocator_allocate(void *thread_cached_allocator, U64 size, U16 alignment, Allocation_Flags flags)
+{
+    return allocate((Thread_Cached_Allocator *)thread_cached_allocator, size, alignment, flags);
+}
+
+void *thread_cached_allocator_reallocate(void *thread_cached_allocator, void *memory, U64 old_size, U64 new_size, U16 alignment)
+{
+    return reallocate((Thread_Cached_Allocator *)thread_cached_allocator, memory, old_size, new_size, alignment);
+}
+
+void thread_cached_allocator_deallocate(void *thread_cached_allocator, void *memory)
+{
+    return deallocate((Thread_Cached_Allocator *)thread_cached_allocator, memory);
+}
+
+//
+// Memory Stats
+//
+
+void memory_new_frame()
+{
+#if HE_MEMORY_TAGGING
+    S64 live_bytes[(U32)Memory_Tag::COUNT];
+    U64 allocation_counts[(U32)Memory_Tag::COUNT];
+    U64 allocated_bytes[(U32)Memory_Tag::COUNT];
+
+    for (U32 tag_index = 0; tag_index < (U32)Memory_Tag::COUNT; tag_index++)
     {
-        HE_ASSERT((U8*)memory < (U8*)node || (U8*)memory > (U8*)node + node->size);
+        Memory_Tag_Counters *counters = &heap_memory_tag_counters[tag_index];
+        live_bytes[tag_index] = counters->live_bytes.load(std::memory_order_relaxed);
+        allocation_counts[tag_index] = counters->allocation_count.load(std::memory_order_relaxed);
+        allocated_bytes[tag_index] = counters->allocated_bytes.load(std::memory_order_relaxed);
     }
-    
-    void *new_memory = allocate_internal(allocator, new_size, alignment);
-    copy_memory(new_memory, memory, HE_MIN(old_size, new_size));
-    deallocate_internal(allocator, memory);
 
+    Thread_Cached_Allocator *allocator = &memory_system_state.general_thread_cached_allocator;
+    platform_lock_mutex(&allocator->mutex);
+    for (Thread_Allocation_Cache *cache = allocator->caches; cache; cache = cache->next_cache)
+    {
+        for (U32 tag_index = 0; tag_index < (U32)Memory_Tag::COUNT; tag_index++)
+        {
+            Memory_Tag_Counters *counters = &cache->tag_counters[tag_index];
+            live_bytes[tag_index] += counters->live_bytes.load(std::memory_order_relaxed);
+            allocation_counts[tag_index] += counters->allocation_count.load(std::memory_order_relaxed);
+            allocated_bytes[tag_index] += counters->allocated_bytes.load(std::memory_order_relaxed);
+        }
+    }
     platform_unlock_mutex(&allocator->mutex);
 
-    return new_memory;
+    for (U32 tag_index = 0; tag_index < (U32)Memory_Tag::COUNT; tag_index++)
+    {
+        Memory_Tag_Stats *stats = &memory_system_state.tag_stats[tag_index];
+
+        // a free can be counted before the allocation it belongs to.
+        stats->live_bytes = (U64)HE_MAX(live_bytes[tag_index], (S64)0);
+        stats->peak_bytes = HE_MAX(stats->peak_bytes, stats->live_bytes);
+        stats->allocation_count = allocation_counts[tag_index];
+        stats->frame_allocation_count = allocation_counts[tag_index] - memory_system_state.last_frame_allocation_counts[tag_index];
+        stats->frame_allocated_bytes = allocated_bytes[tag_index] - memory_system_state.last_frame_allocated_bytes[tag_index];
+
+        memory_system_state.last_frame_allocation_counts[tag_index] = allocation_counts[tag_index];
+        memory_system_state.last_frame_allocated_bytes[tag_index] = allocated_bytes[tag_index];
+    }
+#endif
+
+    trim_thread_memory();
+    memory_system_state.frame_index++;
 }
 
-void *free_list_allocator_allocate(void *free_list_allocator, U64 size, U16 alignment)
+static void add_memory_arena_stats(Memory_Stats *stats, const char *name, U32 thread_id, Memory_Arena *arena)
 {
-    return allocate((Free_List_Allocator *)free_list_allocator, size, alignment);
+    Memory_Arena_Stats *arena_stats = &stats->arenas[stats->arena_count++];
+    arena_stats->name = name;
+    arena_stats->thread_id = thread_id;
+    arena_stats->used = arena->offset;
+    arena_stats->high_water_mark = arena->high_water_mark;
+    arena_stats->committed = arena->size;
+    arena_stats->capacity = arena->capacity;
 }
 
-void *free_list_allocator_reallocate(void *free_list_allocator, void *memory, U64 old_size, U64 new_size, U16 alignment)
+bool get_memory_stats(Memory_Stats *out_stats, Allocator allocator)
 {
-    return reallocate((Free_List_Allocator *)free_list_allocator, memory, old_size, new_size, alignment);
+    HE_ASSERT(out_stats);
+
+    Memory_Stats &stats = *out_stats;
+    stats = {};
+    stats.frame_index = memory_system_state.frame_index;
+    copy_memory(stats.tags, memory_system_state.tag_stats, sizeof(stats.tags));
+
+    platform_lock_mutex(&memory_system_state.thread_contexts_mutex);
+
+    U32 thread_context_count = 0;
+    for (Thread_Context *context = memory_system_state.thread_contexts; context; context = context->next)
+    {
+        thread_context_count++;
+    }
+
+    stats.arenas = HE_ALLOCATOR_ALLOCATE_ARRAY(allocator, Memory_Arena_Stats, 2 + HE_MAX_FRAMES_IN_FLIGHT + thread_context_count * (1 + HE_THREAD_SCRATCH_ARENA_COUNT));
+
+    static const char *frame_arena_names[] = { "frame 0", "frame 1", "frame 2" };
+    static_assert(HE_ARRAYCOUNT(frame_arena_names) == HE_MAX_FRAMES_IN_FLIGHT);
+
+    add_memory_arena_stats(&stats, "permenent", 0, &memory_system_state.permenent_arena);
+    for (U32 frame_index = 0; frame_index < HE_MAX_FRAMES_IN_FLIGHT; frame_index++)
+    {
+        add_memory_arena_stats(&stats, frame_arena_names[frame_index], 0, &memory_system_state.frame_arenas[frame_index]);
+    }
+    add_memory_arena_stats(&stats, "debug", 0, &memory_system_state.debug_arena);
+
+    // thread arenas are read while their threads use them so the numbers are a snapshot at best.
+    for (Thread_Context *context = memory_system_state.thread_contexts; context; context = context->next)
+    {
+        add_memory_arena_stats(&stats, "thread", context->thread_id, &context->arena);
+        for (U32 scratch_index = 0; scratch_index < HE_THREAD_SCRATCH_ARENA_COUNT; scratch_index++)
+        {
+            add_memory_arena_stats(&stats, "scratch", context->thread_id, &context->scratch_arenas[scratch_index]);
+        }
+    }
+
+    platform_unlock_mutex(&memory_system_state.thread_contexts_mutex);
+
+    Thread_Cached_Allocator *thread_cached_allocator = &memory_system_state.general_thread_cached_allocator;
+    platform_lock_mutex(&thread_cached_allocator->mutex);
+    for (Thread_Allocation_Cache *cache = thread_cached_allocator->caches; cache; cache = cache->next_cache)
+    {
+        stats.thread_cache_count++;
+
+#if HE_MEMORY_TAGGING
+        for (U32 bucket_index = 0; bucket_index < HE_ALLOCATION_SIZE_BUCKET_COUNT; bucket_index++)
+        {
+            stats.allocation_size_counts[bucket_index] += cache->allocation_size_counts[bucket_index].load(std::memory_order_relaxed);
+        }
+#endif
+    }
+    platform_unlock_mutex(&thread_cached_allocator->mutex);
+
+    // spans are never given back to the heap so the span bitmap has all of them.
+    U64 span_count = 0;
+    for (U64 word_index = 0; word_index < thread_cached_allocator->span_bitmap_word_count; word_index++)
+    {
+        span_count += std::popcount(thread_cached_allocator->span_bitmap[word_index].load(std::memory_order_relaxed));
+    }
+    stats.thread_cache_span_size = span_count * HE_THREAD_CACHE_SPAN_SIZE;
+
+    get_free_list_allocator_stats(&memory_system_state.general_free_list_allocator, &stats.general_heap);
+    return true;
 }
 
-void free_list_allocator_deallocate(void *free_list_allocator, void *memory)
+bool append_memory_stats_csv(const char *path)
 {
-    return deallocate((Free_List_Allocator *)free_list_allocator, memory);
-}
\ No newline at end of file
+    HE_ASSERT(path);
+
+    Memory_Context memory_context = grab_memory_context();
+
+    Memory_Stats stats = {};
+    get_memory_stats(&stats, memory_context.temp_allocator);
+
+    String_Builder builder = {};
+    begin_string_builder(&builder, memory_context.temprary_memory.arena);
+
+    Open_File_Result open_file_result = platform_open_file(path, OpenFileFlag_Write);
+    if (!open_file_result.success)
+    {
+        HE_LOG(Core, Error, "append_memory_stats_csv -- failed to open file: %s\n", path);
+        return false;
+    }
+
+    if (open_file_result.size == 0)
+    {
+        append(&builder, "frame,kind,name,thread_id,live_bytes,peak_bytes,allocation_count,frame_allocation_count,frame_allocated_bytes,used,high_water_mark,committed,capacity\n");
+    }
+
+    for (U32 tag_index = 0; tag_index < (U32)Memory_Tag::COUNT; tag_index++)
+    {
+        const Memory_Tag_Stats &tag = stats.tags[tag_index];
+        append(&builder, "%llu,tag,%s,,%llu,%llu,%llu,%llu,%llu,,,,\n", stats.frame_index, memory_tag_to_string((Memory_Tag)tag_index),
+               tag.live_bytes, tag.peak_bytes, tag.allocation_count, tag.frame_allocation_count, tag.frame_allocated_bytes);
+    }
+
+    for (U32 arena_index = 0; arena_index < stats.arena_count; arena_index++)
+    {
+        const Memory_Arena_Stats &arena = stats.arenas[arena_index];
+        append(&builder, "%llu,arena,%s,%u,,,,,,%llu,%llu,%llu,%llu\n", stats.frame_index, arena.name, arena.thread_id,
+               arena.used, arena.high_water_mark, arena.committed, arena.capacity);
+    }
+
+    const Free_List_Allocator_Stats &heap = stats.general_heap;
+    append(&builder, "%llu,heap,general,,,,%u,,,%llu,,%llu,%llu\n", stats.frame_index, heap.allocation_count, heap.used_size, heap.committed_size, heap.capacity);
+
+    // the name of a size row is the smallest size in its bucket.
+    for (U32 bucket_index = 0; bucket_index < HE_ALLOCATION_SIZE_BUCKET_COUNT; bucket_index++)
+    {
+        if (stats.allocation_size_counts[bucket_index])
+        {
+            append(&builder, "%llu,size,%llu,,,,%llu,,,,,,\n", stats.frame_index, 1ull << bucket_index, stats.allocation_size_counts[bucket_index]);
+        }
+    }
+
+    String contents = end_string_builder(&builder);
+    bool success = platform_write_data_to_file(&open_file_result, open_file_result.size, (void *)contents.data, contents.count);
+    if (!success)
+    {
+        HE_LOG(Core, Error, "append_memory_stats_csv -- failed to write file: %s\n", path);
+    }
+
+    platform_close_file(&open_file_result);
+    return success;
+}
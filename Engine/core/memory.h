@@ -3,6 +3,8 @@
 #include "defines.h"
 #include "platform.h"
 
+#include <atomic>
+
 #define HE_KILO_BYTES(x) (1024llu * (x))
 #define HE_MEGA_BYTES(x) (1024llu * 1024llu * (x))
 #define HE_GIGA_BYTES(x) (1024llu * 1024llu * 1024llu * (x))
@@ -19,6 +21,9 @@
 #define HE_ALLOCATE_ARRAY(allocator_pointer, type, count) \
 (type *)allocate((allocator_pointer), sizeof(type) * (count), alignof(type))
 
+#define HE_ALLOCATE_ARRAY_NO_ZERO(allocator_pointer, type, count) \
+(type *)allocate((allocator_pointer), sizeof(type) * (count), alignof(type), AllocationFlag_NoZero)
+
 #define HE_REALLOCATE_ARRAY(allocator_pointer, memory, type, count) \
 (type *)reallocate((allocator_pointer), memory, 0, sizeof(type) * (count), alignof(type))
 
@@ -26,13 +31,16 @@
 (type *)reallocate((allocator_pointer), memory, sizeof(type) * (old_count), sizeof(type) * (new_count), alignof(type))
 
 #define HE_ALLOCATOR_ALLOCATE(allocator, type) \
-(type *)(allocator).allocate((allocator).data, sizeof(type), HE_DEFAULT_ALIGNMENT)
+(type *)(allocator).allocate((allocator).data, sizeof(type), HE_DEFAULT_ALIGNMENT, AllocationFlag_None)
 
 #define HE_ALLOCATOR_ALLOCATE_ALIGNED(allocator, type) \
-(type *)(allocator).allocate((allocator).data, sizeof(type), alignof(type))
+(type *)(allocator).allocate((allocator).data, sizeof(type), alignof(type), AllocationFlag_None)
 
 #define HE_ALLOCATOR_ALLOCATE_ARRAY(allocator, type, count) \
-(type *)(allocator).allocate((allocator).data, sizeof(type) * (count), alignof(type))
+(type *)(allocator).allocate((allocator).data, sizeof(type) * (count), alignof(type), AllocationFlag_None)
+
+#define HE_ALLOCATOR_ALLOCATE_ARRAY_NO_ZERO(allocator, type, count) \
+(type *)(allocator).allocate((allocator).data, sizeof(type) * (count), alignof(type), AllocationFlag_NoZero)
 
 #define HE_ALLOCATOR_REALLOCATE_ARRAY(allocator, memory, type, count) \
 (type *)(allocator).reallocate((allocator).data, memory, 0, sizeof(type) * (count), alignof(type))
@@ -48,18 +56,70 @@ void copy_memory(void *dst, const void *src, U64 size);
 
 U64 get_number_of_bytes_to_align_address(uintptr_t address, U16 alignment);
 
+// without a flag the allocator decides, all allocators zero by default except arenas created with MemoryArenaFlag_NoZero.
+enum Allocation_Flags : U8
+{
+    AllocationFlag_None   = 0,
+    AllocationFlag_Zero   = 1 << 0,
+    AllocationFlag_NoZero = 1 << 1, // for buffers that are overwritten right away like staging and file data.
+};
+
 struct Allocator
 {
     void   *data;
-    void* (*allocate)(void *data, U64 size, U16 alignment);
+    void* (*allocate)(void *data, U64 size, U16 alignment, Allocation_Flags flags);
     void* (*reallocate)(void *data, void *memory, U64 old_size, U64 new_size, U16 alignment);
     void  (*deallocate)(void *data, void *memory);
 };
 
+//
+// Memory Tags
+//
+
+#define HE_MEMORY_TAGGING 1
+
+#ifdef HE_SHIPPING
+#undef HE_MEMORY_TAGGING
+#define HE_MEMORY_TAGGING 0
+#endif
+
+enum class Memory_Tag : U8
+{
+    GENERAL,
+    CORE,
+    ASSETS,
+    RENDERING,
+    JOBS,
+    EDITOR,
+    COUNT
+};
+
+const char *memory_tag_to_string(Memory_Tag tag);
+
+// allocators without a fixed tag charge allocations to the innermost scope of the allocating thread.
+struct Memory_Tag_Scope
+{
+    Memory_Tag previous_tag;
+
+    Memory_Tag_Scope(Memory_Tag tag);
+    ~Memory_Tag_Scope();
+};
+
+#define HE_MEMORY_TAG_SCOPE(tag) Memory_Tag_Scope HE_GLUE(memory_tag_scope_, __COUNTER__)(tag)
+
+Memory_Tag get_current_memory_tag();
+
 //
 // Memory Arena
 //
 
+enum Memory_Arena_Flags : U8
+{
+    MemoryArenaFlag_None       = 0,
+    MemoryArenaFlag_NoZero     = 1 << 0, // allocations are only zeroed when they ask for AllocationFlag_Zero.
+    MemoryArenaFlag_LargePages = 1 << 1, // the whole capacity is committed up front with large pages and never trimmed, falls back to normal pages.
+};
+
 struct Memory_Arena
 {
     U8 *base;
@@ -67,16 +127,23 @@ struct Memory_Arena
     U64 min_allocation_size;
     U64 size;
     U64 offset;
+    U64 high_water_mark;
+    U64 trim_high_water_mark; // since the last trim.
     S64 temp_count;
+    Memory_Arena_Flags flags;
 };
 
-bool init_memory_arena(Memory_Arena *memory_arena, U64 capacity, U64 min_allocation_size = HE_MEGA_BYTES(1));
+// numa_node -1 lets the os decide where the pages come from.
+bool init_memory_arena(Memory_Arena *memory_arena, U64 capacity, U64 min_allocation_size = HE_MEGA_BYTES(1), S32 numa_node = -1, Memory_Arena_Flags flags = MemoryArenaFlag_None);
 
-void* allocate(Memory_Arena *memory_arena, U64 size, U16 alignment);
+void* allocate(Memory_Arena *memory_arena, U64 size, U16 alignment, Allocation_Flags flags = AllocationFlag_None);
 void* reallocate(Memory_Arena *memory_arena, void *memory, U64 old_size, U64 new_size, U16 alignment);
 void deallocate(Memory_Arena *memory_arena, void *memory);
 
-void *memory_arena_allocate(void *memory_arena, U64 size, U16 alignment);
+// decommits the pages past what the arena used since the last trim when they add up to at least min_allocation_size.
+void trim_memory_arena(Memory_Arena *memory_arena);
+
+void *memory_arena_allocate(void *memory_arena, U64 size, U16 alignment, Allocation_Flags flags);
 void *memory_arena_reallocate(void *memory_arena, void *memory, U64 old_size, U64 new_size, U16 alignment);
 void memory_arena_deallocate(void *memory_arena, void *memory);
 
@@ -102,10 +169,27 @@ void end_temprary_memory(Temprary_Memory temprary_memory);
 // Free List Allocator
 //
 
-struct Free_List_Node
+// two level segregated fit (TLSF): http://www.gii.upv.es/tlsf/files/papers/ecrts04_tlsf.pdf
+// free blocks are kept in size class lists found with two bitmap lookups so allocate and deallocate are O(1).
+#define HE_FREE_LIST_SECOND_LEVEL_COUNT_LOG2 5
+#define HE_FREE_LIST_SECOND_LEVEL_COUNT (1 << HE_FREE_LIST_SECOND_LEVEL_COUNT_LOG2)
+#define HE_FREE_LIST_FIRST_LEVEL_COUNT 40 // block sizes up to 2^48 bytes.
+
+#define HE_FREE_LIST_ALLOCATOR_STATS 1
+
+#ifdef HE_SHIPPING
+#undef HE_FREE_LIST_ALLOCATOR_STATS
+#define HE_FREE_LIST_ALLOCATOR_STATS 0
+#endif
+
+struct Free_List_Block
 {
-    U64 size;
-    Free_List_Node *next;
+    Free_List_Block *prev_physical;
+    U64 size; // includes this header, the lowest bit is set while the block is free.
+
+    // only valid while the block is free, overlaps the allocation otherwise.
+    Free_List_Block *next_free;
+    Free_List_Block *prev_free;
 };
 
 struct Free_List_Allocator
@@ -116,37 +200,146 @@ struct Free_List_Allocator
     U64 size;
     U64 used;
     U64 min_allocation_size;
-    Free_List_Node *head;
+
+    U64 first_level_bitmap;
+    U32 second_level_bitmaps[HE_FREE_LIST_FIRST_LEVEL_COUNT];
+    Free_List_Block *free_lists[HE_FREE_LIST_FIRST_LEVEL_COUNT][HE_FREE_LIST_SECOND_LEVEL_COUNT];
+    Free_List_Block *sentinel; // zero sized used block at the end of the committed memory.
+
+    U32 allocation_count;
+    U32 free_block_count;
+
+    Memory_Tag tag; // Memory_Tag::COUNT uses the tag scope of the allocating thread.
+
+#if HE_FREE_LIST_ALLOCATOR_STATS
+    U64 allocate_call_count;
+    U64 allocate_ticks;
+    U64 max_allocate_ticks;
+    U64 deallocate_call_count;
+    U64 deallocate_ticks;
+    U64 max_deallocate_ticks;
+#endif
+
     Mutex mutex;
 };
 
-bool init_free_list_allocator(Free_List_Allocator *allocator, void *memory, U64 capacity, U64 size, const char *name);
+struct Free_List_Allocator_Stats
+{
+    U64 capacity;
+    U64 committed_size;
+    U64 used_size; // including block headers and alignment padding.
+    U64 free_size;
+    U64 largest_free_block_size;
+    F32 fragmentation; // 1 - largest_free_block_size / free_size.
+
+    U32 allocation_count;
+    U32 free_block_count;
+
+    F64 average_allocate_ns;
+    F64 max_allocate_ns;
+    F64 average_deallocate_ns;
+    F64 max_deallocate_ns;
+};
+
+bool init_free_list_allocator(Free_List_Allocator *allocator, void *memory, U64 capacity, U64 size, const char *name, Memory_Tag tag = Memory_Tag::COUNT);
 
-void* allocate(Free_List_Allocator *allocator, U64 size, U16 alignment);
+void* allocate(Free_List_Allocator *allocator, U64 size, U16 alignment, Allocation_Flags flags = AllocationFlag_None);
 void* reallocate(Free_List_Allocator *allocator, void *memory, U64 old_size, U64 new_size, U16 alignment);
 void deallocate(Free_List_Allocator *allocator, void *memory);
 
-void *free_list_allocator_allocate(void *free_list_allocator, U64 size, U16 alignment);
+void *free_list_allocator_allocate(void *free_list_allocator, U64 size, U16 alignment, Allocation_Flags flags);
 void *free_list_allocator_reallocate(void *free_list_allocator, void *memory, U64 old_size, U64 new_size, U16 alignment);
 void free_list_allocator_deallocate(void *free_list_allocator, void *memory);
 
+void get_free_list_allocator_stats(Free_List_Allocator *allocator, Free_List_Allocator_Stats *out_stats);
+
 HE_FORCE_INLINE Allocator to_allocator(Free_List_Allocator *allocator)
 {
     return { .data = allocator, .allocate = &free_list_allocator_allocate, .reallocate = &free_list_allocator_reallocate, .deallocate = &free_list_allocator_deallocate };
 }
 
+//
+// Thread Cached Allocator
+//
+
+// allocations up to HE_THREAD_CACHE_MAX_ALLOCATION_SIZE come from per thread size class lists that take a span at a time from the heap,
+// frees from other threads are pushed lock-free to the cache that owns the span and collected once it runs dry.
+#define HE_THREAD_CACHE_SPAN_SIZE_LOG2 15
+#define HE_THREAD_CACHE_SPAN_SIZE (1ull << HE_THREAD_CACHE_SPAN_SIZE_LOG2)
+#define HE_THREAD_CACHE_MAX_ALLOCATION_SIZE 1024
+#define HE_THREAD_CACHE_SIZE_CLASS_COUNT 20
+#define HE_MAX_THREAD_CACHED_ALLOCATOR_COUNT 4
+
+struct Thread_Allocation_Cache;
+
+struct Thread_Cached_Allocator
+{
+    U32 index;
+    Free_List_Allocator *heap;
+
+    // one bit per span sized granule of the heap, set once the granule is handed to a cache. spans are never returned to the heap.
+    std::atomic< U64 > *span_bitmap;
+    U64 span_bitmap_word_count;
+
+    Mutex mutex;
+    Thread_Allocation_Cache *caches;
+    Thread_Allocation_Cache *free_caches; // left behind by exited threads and adopted by new ones.
+};
+
+bool init_thread_cached_allocator(Thread_Cached_Allocator *allocator, Free_List_Allocator *heap);
+
+void* allocate(Thread_Cached_Allocator *allocator, U64 size, U16 alignment, Allocation_Flags flags = AllocationFlag_None);
+void* reallocate(Thread_Cached_Allocator *allocator, void *memory, U64 old_size, U64 new_size, U16 alignment);
+void deallocate(Thread_Cached_Allocator *allocator, void *memory);
+
+void *thread_cached_allocator_allocate(void *thread_cached_allocator, U64 size, U16 alignment, Allocation_Flags flags);
+void *thread_cached_allocator_reallocate(void *thread_cached_allocator, void *memory, U64 old_size, U64 new_size, U16 alignment);
+void thread_cached_allocator_deallocate(void *thread_cached_allocator, void *memory);
+
+HE_FORCE_INLINE Allocator to_allocator(Thread_Cached_Allocator *allocator)
+{
+    return { .data = allocator, .allocate = &thread_cached_allocator_allocate, .reallocate = &thread_cached_allocator_reallocate, .deallocate = &thread_cached_allocator_deallocate };
+}
+
 bool init_memory_system();
 void deinit_memory_system();
 
-struct Thread_Memory_State
+#define HE_THREAD_SCRATCH_ARENA_COUNT 2
+
+// lives in thread local storage, every thread that grabs a memory context has to init it when it starts and deinit it before it exits.
+struct Thread_Context
 {
+    U32 thread_id;
+    S32 worker_index; // -1 for threads that are not job system workers.
+
     Memory_Arena arena;
+    Memory_Arena scratch_arenas[HE_THREAD_SCRATCH_ARENA_COUNT];
+
+    void *renderer_thread_state; // owned by the renderer backend.
+
+    Thread_Context *next;
 };
 
-Thread_Memory_State *get_thread_memory_state(U32 thread_id);
+bool init_thread_context(S32 worker_index = -1, S32 numa_node = -1);
+void deinit_thread_context();
+Thread_Context *get_thread_context();
+
 Memory_Arena *get_thread_arena();
 Memory_Arena *get_frame_arena();
 
+// safe to use from any thread, the memory stays valid for HE_MAX_FRAMES_IN_FLIGHT frames so jobs using it have to finish by then.
+// the frame arena itself is only safe to allocate from through this allocator.
+Allocator get_frame_allocator();
+
+// trims the arenas of the calling thread, threads call it when they go idle.
+void trim_thread_memory();
+
+// frame memory is never freed, it is reset once the gpu is done with the last frame that used the same frame in flight index.
+void begin_frame_memory(U32 frame_in_flight_index);
+
+// pass the arena the caller's results live in so the scratch memory never overlaps them.
+Temprary_Memory begin_scratch_memory(Memory_Arena *conflict = nullptr);
+
 struct Memory_Context
 {
     Allocator permenent_allocator;
@@ -162,4 +355,53 @@ struct Memory_Context
 };
 
 Memory_Context grab_memory_context();
-bool drop_memory_context(Memory_Context *memory_context, Allocator allocator);
\ No newline at end of file
+bool drop_memory_context(Memory_Context *memory_context, Allocator allocator);
+
+//
+// Memory Stats
+//
+
+#define HE_ALLOCATION_SIZE_BUCKET_COUNT 32
+
+struct Memory_Tag_Stats
+{
+    U64 live_bytes;
+    U64 peak_bytes; // sampled once per frame.
+    U64 allocation_count;
+    U64 frame_allocation_count; // during the last finished frame.
+    U64 frame_allocated_bytes;
+};
+
+struct Memory_Arena_Stats
+{
+    const char *name;
+    U32 thread_id; // only set for thread arenas.
+    U64 used;
+    U64 high_water_mark;
+    U64 committed;
+    U64 capacity;
+};
+
+struct Memory_Stats
+{
+    U64 frame_index;
+    Memory_Tag_Stats tags[(U32)Memory_Tag::COUNT];
+
+    U32 arena_count;
+    Memory_Arena_Stats *arenas;
+
+    U32 thread_cache_count;
+    U64 thread_cache_span_size; // memory the thread caches took from the general heap.
+    Free_List_Allocator_Stats general_heap;
+
+    // general allocator allocations since startup by requested size, bucket i has the sizes in [2^i, 2^(i + 1)).
+    U64 allocation_size_counts[HE_ALLOCATION_SIZE_BUCKET_COUNT];
+};
+
+// has to be called by the main thread once per frame.
+void memory_new_frame();
+
+bool get_memory_stats(Memory_Stats *out_stats, Allocator allocator);
+
+// appends one row per tag, arena and allocation size bucket for the current frame, the header is written if the file is empty.
+bool append_memory_stats_csv(const char *path);
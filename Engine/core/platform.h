@@ -50,11 +50,17 @@ struct Event
 //
 
 U64 platform_get_total_memory_size();
+U64 platform_get_resident_memory_size(); // bytes of the process that are in physical memory right now.
 void* platform_allocate_memory(U64 size);
 void* platform_reserve_memory(U64 size);
+void* platform_reserve_memory_on_numa_node(U64 size, U32 numa_node); // pages are committed from numa_node when possible.
 bool platform_commit_memory(void *memory, U64 size);
+bool platform_decommit_memory(void *memory, U64 size); // the pages read back as zero once they are committed again.
 void platform_deallocate_memory(void *memory);
 
+U64 platform_get_large_page_size(); // 0 if the process is not allowed to use large pages.
+void* platform_allocate_large_pages(U64 size); // reserved and committed at once, size has to be a multiple of the large page size.
+
 //
 // window
 //
@@ -113,6 +119,20 @@ bool platform_write_data_to_file(const Open_File_Result *open_file_result, U64 o
 
 bool platform_close_file(Open_File_Result *open_file_result);
 
+struct Map_File_Result
+{
+    void *handle;
+    void *mapping_handle;
+    U8 *data;
+    U64 size;
+    bool success;
+};
+
+// maps the whole file read only, the view stays valid until it's unmapped.
+Map_File_Result platform_map_file(const char *filepath);
+
+bool platform_unmap_file(Map_File_Result *map_file_result);
+
 enum class Watch_Directory_Result
 {
     FILE_ADDED,
@@ -145,6 +165,13 @@ bool platform_unload_dynamic_library(Dynamic_Library *dynamic_library);
 void* platform_create_vulkan_surface(struct Engine *engine,
                                      void *instance,
                                      const void *allocator_callbacks = nullptr);
+//
+// time
+//
+
+U64 platform_get_performance_counter();
+U64 platform_get_performance_frequency();
+
 //
 // threading
 //
@@ -161,6 +188,31 @@ bool platform_create_and_start_thread(Thread *thread, Thread_Proc thread_proc, v
 U32 platform_get_thread_count();
 U32 platform_get_current_thread_id();
 U32 platform_get_thread_id(Thread *thread);
+bool platform_join_thread(Thread *thread);
+bool platform_set_thread_affinity(Thread *thread, U16 processor_group, U64 logical_processor_mask);
+
+//
+// cpu topology
+//
+
+#define HE_MAX_CPU_CORE_COUNT 256
+
+struct CPU_Core
+{
+    U16 processor_group;        // affinity masks are per group of up to 64 logical processors.
+    U64 logical_processor_mask; // the core's smt siblings.
+    U32 numa_node;
+};
+
+struct CPU_Topology
+{
+    U32 logical_processor_count;
+    U32 physical_core_count;
+    U32 numa_node_count;
+    CPU_Core cores[HE_MAX_CPU_CORE_COUNT];
+};
+
+bool platform_get_cpu_topology(CPU_Topology *topology);
 
 struct Mutex
 {
@@ -172,6 +224,18 @@ void platform_lock_mutex(Mutex *mutex);
 void platform_unlock_mutex(Mutex *mutex);
 void platform_wait_for_mutexes(Mutex *mutexes, U32 mutex_count);
 
+// many readers or one writer.
+struct Read_Write_Lock
+{
+    void *platform_read_write_lock_state;
+};
+
+bool platform_create_read_write_lock(Read_Write_Lock *read_write_lock);
+void platform_lock_read(Read_Write_Lock *read_write_lock);
+void platform_unlock_read(Read_Write_Lock *read_write_lock);
+void platform_lock_write(Read_Write_Lock *read_write_lock);
+void platform_unlock_write(Read_Write_Lock *read_write_lock);
+
 struct Semaphore
 {
     void *platform_semaphore_state;
@@ -0,0 +1,206 @@
+#pragma once
+
+#include "core/defines.h"
+#include "core/memory.h"
+#include "core/platform.h"
+
+// fixed size objects carved out of chunks taken from the backing allocator, freed objects go to an intrusive free list
+// so allocate and deallocate are O(1). chunks are only returned to the backing allocator on deinit.
+template< typename T >
+struct Pool_Allocator
+{
+    // at least HE_DEFAULT_ALIGNMENT since that is what HE_ALLOCATOR_ALLOCATE asks for.
+    union Slot
+    {
+        Slot *next;
+        alignas(alignof(T) > HE_DEFAULT_ALIGNMENT ? alignof(T) : HE_DEFAULT_ALIGNMENT) U8 data[sizeof(T)];
+    };
+
+    struct Chunk
+    {
+        Chunk *next;
+    };
+
+    static constexpr U64 chunk_header_size = (sizeof(Chunk) + alignof(Slot) - 1) & ~(alignof(Slot) - 1);
+
+    Slot *free_list;
+
+    // slots of the newest chunk that were never handed out.
+    U8 *cursor;
+    U8 *end;
+
+    Chunk *chunks;
+    U32 objects_per_chunk;
+    U32 chunk_count;
+    U32 count;
+
+    bool thread_safe; // pools used by a single thread skip the mutex.
+    Mutex mutex;
+
+    Allocator allocator;
+};
+
+template< typename T >
+void init(Pool_Allocator< T > *pool, U32 objects_per_chunk, Allocator allocator = {}, bool thread_safe = true)
+{
+    HE_ASSERT(pool);
+    HE_ASSERT(objects_per_chunk);
+
+    if (!allocator.data)
+    {
+        Memory_Context memory_context = grab_memory_context();
+        allocator = memory_context.general_allocator;
+    }
+
+    pool->free_list = nullptr;
+    pool->cursor = nullptr;
+    pool->end = nullptr;
+    pool->chunks = nullptr;
+    pool->objects_per_chunk = objects_per_chunk;
+    pool->chunk_count = 0;
+    pool->count = 0;
+    pool->thread_safe = thread_safe;
+    pool->allocator = allocator;
+
+    if (thread_safe)
+    {
+        bool mutex_created = platform_create_mutex(&pool->mutex);
+        HE_ASSERT(mutex_created);
+    }
+}
+
+template< typename T >
+void deinit(Pool_Allocator< T > *pool)
+{
+    HE_ASSERT(pool);
+    HE_ASSERT(pool->count == 0);
+
+    using Chunk = typename Pool_Allocator< T >::Chunk;
+
+    for (Chunk *chunk = pool->chunks; chunk;)
+    {
+        Chunk *next = chunk->next;
+        HE_ALLOCATOR_DEALLOCATE(pool->allocator, chunk);
+        chunk = next;
+    }
+
+    pool->free_list = nullptr;
+    pool->cursor = nullptr;
+    pool->end = nullptr;
+    pool->chunks = nullptr;
+    pool->chunk_count = 0;
+}
+
+template< typename T >
+T *allocate(Pool_Allocator< T > *pool, Allocation_Flags flags = AllocationFlag_None)
+{
+    HE_ASSERT(pool);
+
+    using Slot = typename Pool_Allocator< T >::Slot;
+    using Chunk = typename Pool_Allocator< T >::Chunk;
+
+    if (pool->thread_safe)
+    {
+        platform_lock_mutex(&pool->mutex);
+    }
+
+    Slot *slot = pool->free_list;
+    if (slot)
+    {
+        pool->free_list = slot->next;
+    }
+    else
+    {
+        if (pool->cursor == pool->end)
+        {
+            U64 chunk_size = Pool_Allocator< T >::chunk_header_size + sizeof(Slot) * pool->objects_per_chunk;
+            Chunk *chunk = (Chunk *)pool->allocator.allocate(pool->allocator.data, chunk_size, alignof(Slot), AllocationFlag_NoZero);
+            chunk->next = pool->chunks;
+            pool->chunks = chunk;
+            pool->chunk_count++;
+
+            pool->cursor = (U8 *)chunk + Pool_Allocator< T >::chunk_header_size;
+            pool->end = pool->cursor + sizeof(Slot) * pool->objects_per_chunk;
+        }
+
+        slot = (Slot *)pool->cursor;
+        pool->cursor += sizeof(Slot);
+    }
+
+    pool->count++;
+
+    if (pool->thread_safe)
+    {
+        platform_unlock_mutex(&pool->mutex);
+    }
+
+    if (!(flags & AllocationFlag_NoZero))
+    {
+        zero_memory(slot, sizeof(Slot));
+    }
+
+    return (T *)slot;
+}
+
+template< typename T >
+void deallocate(Pool_Allocator< T > *pool, void *memory)
+{
+    HE_ASSERT(pool);
+
+    if (!memory)
+    {
+        return;
+    }
+
+    using Slot = typename Pool_Allocator< T >::Slot;
+    Slot *slot = (Slot *)memory;
+
+    if (pool->thread_safe)
+    {
+        platform_lock_mutex(&pool->mutex);
+    }
+
+    HE_ASSERT(pool->count);
+    slot->next = pool->free_list;
+    pool->free_list = slot;
+    pool->count--;
+
+    if (pool->thread_safe)
+    {
+        platform_unlock_mutex(&pool->mutex);
+    }
+}
+
+template< typename T >
+void *pool_allocator_allocate(void *pool, U64 size, U16 alignment, Allocation_Flags flags)
+{
+    HE_ASSERT(size <= sizeof(T));
+    HE_ASSERT(alignment <= alignof(typename Pool_Allocator< T >::Slot));
+    return allocate((Pool_Allocator< T > *)pool, flags);
+}
+
+// objects never move, growing past sizeof(T) is not supported.
+template< typename T >
+void *pool_allocator_reallocate(void *pool, void *memory, U64 old_size, U64 new_size, U16 alignment)
+{
+    HE_ASSERT(new_size <= sizeof(T));
+
+    if (!memory)
+    {
+        return pool_allocator_allocate< T >(pool, new_size, alignment, AllocationFlag_None);
+    }
+
+    return memory;
+}
+
+template< typename T >
+void pool_allocator_deallocate(void *pool, void *memory)
+{
+    deallocate((Pool_Allocator< T > *)pool, memory);
+}
+
+template< typename T >
+HE_FORCE_INLINE Allocator to_allocator(Pool_Allocator< T > *pool)
+{
+    return { .data = pool, .allocate = &pool_allocator_allocate< T >, .reallocate = &pool_allocator_reallocate< T >, .deallocate = &pool_allocator_deallocate< T > };
+}
@@ -21,6 +21,8 @@
 #pragma warning(push, 0)
 #include <strsafe.h>
 #include <windows.h>
+#include <psapi.h>
+#include <intrin.h>
 #pragma warning(pop)
 
 struct Win32_Window_State
@@ -451,6 +453,16 @@ U64 platform_get_total_memory_size()
     return size * 1024;
 }
 
+U64 platform_get_resident_memory_size()
+{
+    PROCESS_MEMORY_COUNTERS counters = {};
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return 0;
+    }
+    return counters.WorkingSetSize;
+}
+
 void* platform_allocate_memory(U64 size)
 {
     HE_ASSERT(size);
@@ -463,6 +475,12 @@ void* platform_reserve_memory(U64 size)
     return VirtualAlloc(0, size, MEM_RESERVE, PAGE_NOACCESS);
 }
 
+void* platform_reserve_memory_on_numa_node(U64 size, U32 numa_node)
+{
+    HE_ASSERT(size);
+    return VirtualAllocExNuma(GetCurrentProcess(), 0, size, MEM_RESERVE, PAGE_NOACCESS, numa_node);
+}
+
 bool platform_commit_memory(void *memory, U64 size)
 {
     HE_ASSERT(memory);
@@ -471,6 +489,59 @@ bool platform_commit_memory(void *memory, U64 size)
     return result != nullptr;
 }
 
+bool platform_decommit_memory(void *memory, U64 size)
+{
+    HE_ASSERT(memory);
+    HE_ASSERT(size);
+    return VirtualFree(memory, size, MEM_DECOMMIT) != 0;
+}
+
+U64 platform_get_large_page_size()
+{
+    // large pages need the "lock pages in memory" privilege granted to the user and enabled on the process token.
+    // arenas are initialized from several threads, racing threads all compute and store the same value.
+    static std::atomic< S64 > cached_large_page_size = -1;
+    S64 large_page_size = cached_large_page_size.load(std::memory_order_acquire);
+    if (large_page_size != -1)
+    {
+        return (U64)large_page_size;
+    }
+
+    large_page_size = 0;
+
+    HANDLE token = NULL;
+    if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES|TOKEN_QUERY, &token))
+    {
+        cached_large_page_size.store(large_page_size, std::memory_order_release);
+        return 0;
+    }
+
+    TOKEN_PRIVILEGES privileges = {};
+    privileges.PrivilegeCount = 1;
+    privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+
+    bool enabled = LookupPrivilegeValueA(NULL, "SeLockMemoryPrivilege", &privileges.Privileges[0].Luid) &&
+                   AdjustTokenPrivileges(token, FALSE, &privileges, 0, NULL, NULL) &&
+                   GetLastError() == ERROR_SUCCESS;
+    CloseHandle(token);
+
+    if (enabled)
+    {
+        large_page_size = (S64)GetLargePageMinimum();
+    }
+
+    cached_large_page_size.store(large_page_size, std::memory_order_release);
+    return (U64)large_page_size;
+}
+
+void* platform_allocate_large_pages(U64 size)
+{
+    HE_ASSERT(size);
+    U64 large_page_size = platform_get_large_page_size();
+    HE_ASSERT(large_page_size && size % large_page_size == 0);
+    return VirtualAlloc(0, size, MEM_RESERVE|MEM_COMMIT|MEM_LARGE_PAGES, PAGE_READWRITE);
+}
+
 void platform_deallocate_memory(void *memory)
 {
     HE_ASSERT(memory);
@@ -801,6 +872,62 @@ bool platform_close_file(Open_File_Result *open_file_result)
     return result;
 }
 
+Map_File_Result platform_map_file(const char *filepath)
+{
+    Map_File_Result result = {};
+
+    HANDLE file_handle = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file_handle == INVALID_HANDLE_VALUE)
+    {
+        return result;
+    }
+
+    LARGE_INTEGER file_size = {};
+    BOOL success = GetFileSizeEx(file_handle, &file_size);
+    HE_ASSERT(success);
+
+    // empty files can't be mapped.
+    if (file_size.QuadPart == 0)
+    {
+        CloseHandle(file_handle);
+        return result;
+    }
+
+    HANDLE mapping_handle = CreateFileMappingA(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping_handle == NULL)
+    {
+        win32_log_last_error();
+        CloseHandle(file_handle);
+        return result;
+    }
+
+    void *data = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+    if (!data)
+    {
+        win32_log_last_error();
+        CloseHandle(mapping_handle);
+        CloseHandle(file_handle);
+        return result;
+    }
+
+    result.handle = file_handle;
+    result.mapping_handle = mapping_handle;
+    result.data = (U8 *)data;
+    result.size = file_size.QuadPart;
+    result.success = true;
+    return result;
+}
+
+bool platform_unmap_file(Map_File_Result *map_file_result)
+{
+    HE_ASSERT(map_file_result->success);
+    bool result = UnmapViewOfFile(map_file_result->data) != 0;
+    result &= CloseHandle(map_file_result->mapping_handle) != 0;
+    result &= CloseHandle(map_file_result->handle) != 0;
+    *map_file_result = {};
+    return result;
+}
+
 struct Watch_Directory_Info
 {
     HANDLE                  directory_handle;
@@ -974,6 +1101,24 @@ void* platform_create_vulkan_surface(Engine *engine, void *instance, const void
     return surface;
 }
 
+//
+// time
+//
+
+U64 platform_get_performance_counter()
+{
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (U64)counter.QuadPart;
+}
+
+U64 platform_get_performance_frequency()
+{
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    return (U64)frequency.QuadPart;
+}
+
 //
 // threading
 //
@@ -1028,6 +1173,92 @@ U32 platform_get_thread_id(Thread *thread)
     return GetThreadId((HANDLE)thread->platform_thread_state);
 }
 
+bool platform_set_thread_affinity(Thread *thread, U16 processor_group, U64 logical_processor_mask)
+{
+    HE_ASSERT(logical_processor_mask);
+
+    GROUP_AFFINITY group_affinity = {};
+    group_affinity.Group = processor_group;
+    group_affinity.Mask = (KAFFINITY)logical_processor_mask;
+    return SetThreadGroupAffinity((HANDLE)thread->platform_thread_state, &group_affinity, nullptr) != 0;
+}
+
+bool platform_get_cpu_topology(CPU_Topology *topology)
+{
+    HE_ASSERT(topology);
+    zero_memory(topology, sizeof(CPU_Topology));
+
+    DWORD length = 0;
+    GetLogicalProcessorInformationEx(RelationAll, nullptr, &length);
+    if (GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+    {
+        return false;
+    }
+
+    U8 *buffer = (U8 *)platform_allocate_memory(length);
+    HE_DEFER { platform_deallocate_memory(buffer); };
+
+    if (!GetLogicalProcessorInformationEx(RelationAll, (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX)buffer, &length))
+    {
+        return false;
+    }
+
+    for (DWORD offset = 0; offset < length;)
+    {
+        PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX info = (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX)(buffer + offset);
+        offset += info->Size;
+
+        if (info->Relationship != RelationProcessorCore || topology->physical_core_count == HE_MAX_CPU_CORE_COUNT)
+        {
+            continue;
+        }
+
+        CPU_Core *core = &topology->cores[topology->physical_core_count++];
+        core->processor_group = info->Processor.GroupMask[0].Group;
+        core->logical_processor_mask = (U64)info->Processor.GroupMask[0].Mask;
+        core->numa_node = 0;
+        topology->logical_processor_count += (U32)__popcnt64(core->logical_processor_mask);
+    }
+
+    // numa nodes are reported as group masks so match them to the cores they contain.
+    topology->numa_node_count = 1;
+
+    for (DWORD offset = 0; offset < length;)
+    {
+        PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX info = (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX)(buffer + offset);
+        offset += info->Size;
+
+        if (info->Relationship != RelationNumaNode)
+        {
+            continue;
+        }
+
+        U32 numa_node = info->NumaNode.NodeNumber;
+        topology->numa_node_count = HE_MAX(topology->numa_node_count, numa_node + 1);
+
+        const GROUP_AFFINITY &group_mask = info->NumaNode.GroupMask;
+        for (U32 core_index = 0; core_index < topology->physical_core_count; core_index++)
+        {
+            CPU_Core *core = &topology->cores[core_index];
+            if (core->processor_group == group_mask.Group && (core->logical_processor_mask & (U64)group_mask.Mask))
+            {
+                core->numa_node = numa_node;
+            }
+        }
+    }
+
+    return topology->physical_core_count != 0;
+}
+
+bool platform_join_thread(Thread *thread)
+{
+    HANDLE thread_handle = (HANDLE)thread->platform_thread_state;
+    DWORD result = WaitForSingleObject(thread_handle, INFINITE);
+    CloseHandle(thread_handle);
+    thread->platform_thread_state = nullptr;
+    return result == WAIT_OBJECT_0;
+}
+
 bool platform_create_mutex(Mutex *mutex)
 {
     CRITICAL_SECTION *critical_section = (CRITICAL_SECTION *)VirtualAlloc(0, sizeof(CRITICAL_SECTION), MEM_RESERVE|MEM_COMMIT, PAGE_READWRITE);
@@ -1057,6 +1288,35 @@ void platform_wait_for_mutexes(Mutex *mutexes, U32 mutex_count)
     WaitForMultipleObjects(mutex_count, (HANDLE *)mutexes, true, INFINITE);
 }
 
+// an SRWLOCK is pointer sized so it lives in the state pointer itself.
+static_assert(sizeof(SRWLOCK) == sizeof(void *));
+
+bool platform_create_read_write_lock(Read_Write_Lock *read_write_lock)
+{
+    InitializeSRWLock((SRWLOCK *)&read_write_lock->platform_read_write_lock_state);
+    return true;
+}
+
+void platform_lock_read(Read_Write_Lock *read_write_lock)
+{
+    AcquireSRWLockShared((SRWLOCK *)&read_write_lock->platform_read_write_lock_state);
+}
+
+void platform_unlock_read(Read_Write_Lock *read_write_lock)
+{
+    ReleaseSRWLockShared((SRWLOCK *)&read_write_lock->platform_read_write_lock_state);
+}
+
+void platform_lock_write(Read_Write_Lock *read_write_lock)
+{
+    AcquireSRWLockExclusive((SRWLOCK *)&read_write_lock->platform_read_write_lock_state);
+}
+
+void platform_unlock_write(Read_Write_Lock *read_write_lock)
+{
+    ReleaseSRWLockExclusive((SRWLOCK *)&read_write_lock->platform_read_write_lock_state);
+}
+
 bool platform_create_semaphore(Semaphore *semaphore, U32 init_count)
 {
     HANDLE semaphore_handle = CreateSemaphoreA(0, init_count, LONG_MAX, NULL);
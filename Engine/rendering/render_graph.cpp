@@ -510,6 +510,7 @@ struct Record_Commands_Job_Data
 
 Job_Result record_render_graph_node_commands_job(const Job_Parameters &params)
 {
+    HE_MEMORY_TAG_SCOPE(Memory_Tag::RENDERING);
     HE_ASSERT(params.size == sizeof(Record_Commands_Job_Data));
     HE_ASSERT(params.alignment == alignof(Record_Commands_Job_Data));
 
@@ -596,7 +597,9 @@ void render(Render_Graph *render_graph, Renderer *renderer, Renderer_State *rend
             Job_Data job_data =
             {
                 .parameters = job_parameters,
-                .proc = &record_render_graph_node_commands_job
+                .proc = &record_render_graph_node_commands_job,
+                .priority = Job_Priority::CRITICAL,
+                .name = "record_render_graph_node_commands"
             };
             node.job_handle = execute_job(job_data);
         }
@@ -10,6 +10,7 @@
 #include "containers/array.h"
 #include "containers/counted_array.h"
 #include "containers/dynamic_array.h"
+#include "containers/small_array.h"
 #include "containers/hash_map.h"
 
 #include <functional>
@@ -98,7 +99,7 @@ struct Render_Graph_Node
 
     Counted_Array< Clear_Value, HE_MAX_ATTACHMENT_COUNT > clear_values;
 
-    Dynamic_Array< Render_Graph_Node_Handle > edges;
+    Small_Array< Render_Graph_Node_Handle, 8 > edges;
 
     Execute_Render_Graph_Node_Proc execute;
 
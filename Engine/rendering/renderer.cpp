@@ -10,6 +10,7 @@
 #include "core/file_system.h"
 #include "core/job_system.h"
 #include "core/logging.h"
+#include "core/pool_allocator.h"
 
 #include "containers/string.h"
 #include "containers/queue.h"
@@ -40,6 +41,16 @@
 static Renderer_State *renderer_state;
 static Renderer *renderer;
 
+struct Shaderc_UserData
+{
+    Allocator allocator;
+    String include_path;
+};
+
+// one of each per shader compile and include, compiles run on worker threads.
+static Pool_Allocator< Shaderc_UserData > shaderc_userdata_pool;
+static Pool_Allocator< shaderc_include_result > shaderc_include_result_pool;
+
 bool request_renderer(RenderingAPI rendering_api, Renderer *renderer)
 {
     bool result = true;
@@ -117,6 +128,7 @@ bool request_renderer(RenderingAPI rendering_api, Renderer *renderer)
 
 bool init_renderer_state(Engine *engine)
 {
+    HE_MEMORY_TAG_SCOPE(Memory_Tag::RENDERING);
     Memory_Context memory_context = grab_memory_context();
 
     renderer_state = HE_ALLOCATOR_ALLOCATE(memory_context.permenent_allocator, Renderer_State);
@@ -133,6 +145,9 @@ bool init_renderer_state(Engine *engine)
 
     bool render_commands_mutex_created = platform_create_mutex(&renderer_state->render_commands_mutex);
     HE_ASSERT(render_commands_mutex_created);
+
+    init(&shaderc_userdata_pool, 16, memory_context.general_allocator);
+    init(&shaderc_include_result_pool, 64, memory_context.general_allocator);
     
     init(&renderer_state->buffers, HE_MAX_BUFFER_COUNT, memory_context.permenent_allocator);
     init(&renderer_state->textures, HE_MAX_TEXTURE_COUNT, memory_context.permenent_allocator);
@@ -218,7 +233,7 @@ bool init_renderer_state(Engine *engine)
     renderer_state->transfer_buffer = renderer_create_buffer(transfer_buffer_descriptor);
 
     Buffer *transfer_buffer = get(&renderer_state->buffers, renderer_state->transfer_buffer);
-    init_free_list_allocator(&renderer_state->transfer_allocator, transfer_buffer->data, transfer_buffer->size, transfer_buffer->size, "transfer_allocator");
+    init_free_list_allocator(&renderer_state->transfer_allocator, transfer_buffer->data, transfer_buffer->size, transfer_buffer->size, "transfer_allocator", Memory_Tag::RENDERING);
 
     // default resources
     Renderer_Semaphore_Descriptor semaphore_descriptor =
@@ -289,7 +304,7 @@ bool init_renderer_state(Engine *engine)
         glm::vec4 _tangents[] = { { 1.000000f, -0.000000f, -0.000000f, -1.000000f },{ 1.000000f, -0.000000f, -0.000000f, -1.000000f },{ 1.000000f, -0.000000f, -0.000000f, -1.000000f },{ 1.000000f, 0.000000f, 0.000000f, 1.000000f },{ 1.000000f, 0.000000f, 0.000000f, 1.000000f },{ 1.000000f, -0.000000f, 0.000000f, 1.000000f },{ 0.000000f, 0.000000f, -1.000000f, 1.000000f },{ 0.000000f, 0.000000f, -1.000000f, 1.000000f },{ 0.000000f, 0.000000f, -1.000000f, 1.000000f },{ 1.000000f, 0.000000f, 0.000000f, 1.000000f },{ 1.000000f, 0.000000f, 0.000000f, 1.000000f },{ 1.000000f, 0.000000f, 0.000000f, 1.000000f },{ 0.000000f, -0.000000f, -1.000000f, -1.000000f },{ 0.000000f, -0.000000f, -1.000000f, -1.000000f },{ 0.000000f, -0.000000f, -1.000000f, -1.000000f },{ 1.000000f, -0.000000f, 0.000000f, -1.000000f },{ 1.000000f, -0.000000f, 0.000000f, -1.000000f },{ 1.000000f, -0.000000f, 0.000000f, -1.000000f },{ 1.000000f, -0.000000f, -0.000000f, -1.000000f },{ 1.000000f, 0.000000f, -0.000000f, -1.000000f },{ 1.000000f, -0.000000f, -0.000000f, -1.000000f },{ 1.000000f, 0.000000f, 0.000000f, 1.000000f },{ 1.000000f, 0.000000f, 0.000000f, 1.000000f },{ 1.000000f, 0.000000f, 0.000000f, 1.000000f },{ 0.000001f, 0.000000f, -1.000000f, 1.000000f },{ 0.000001f, 0.000000f, -1.000000f, 1.000000f },{ 0.000001f, 0.000000f, -1.000000f, 1.000000f },{ 1.000000f, 0.000000f, 0.000000f, 1.000000f },{ 1.000000f, 0.000000f, 0.000000f, 1.000000f },{ 1.000000f, 0.000000f, 0.000000f, 1.000000f },{ 0.000000f, -0.000000f, -1.000000f, -1.000000f },{ 0.000000f, -0.000000f, -1.000000f, -1.000000f },{ 0.000000f, -0.000000f, -1.000000f, -1.000000f },{ 1.000000f, -0.000000f, 0.000000f, -1.000000f },{ 1.000000f, -0.000000f, 0.000000f, -1.000000f },{ 1.000000f, -0.000000f, 0.000000f, -1.000000f } };
 
         U64 size = sizeof(U16) * (U64)index_count + (sizeof(glm::vec3) + sizeof(glm::vec3) + sizeof(glm::vec2) + sizeof(glm::vec4)) * (U64)vertex_count;
-        U8 *data = HE_ALLOCATE_ARRAY(&renderer_state->transfer_allocator, U8, size);
+        U8 *data = HE_ALLOCATE_ARRAY_NO_ZERO(&renderer_state->transfer_allocator, U8, size);
 
         U16 *indices = (U16 *)data;
         copy_memory(indices, _indices, sizeof(U16) * HE_ARRAYCOUNT(_indices));
@@ -400,11 +415,13 @@ bool init_renderer_state(Engine *engine)
         Shader *default_shader = get(&renderer_state->shaders, renderer_state->default_shader);
 
         Frame_Render_Data *render_data = &renderer_state->render_data;
-        // init(&render_data->skybox_commands);
-        // init(&render_data->opaque_commands);
-        // init(&render_data->alpha_cutoff_commands);
-        // init(&render_data->transparent_commands);
-        // init(&render_data->outline_commands);
+
+        // the lists are reset every frame and keep their capacity, reserving up front keeps frame building off the general heap.
+        reserve(&render_data->skybox_commands, HE_DRAW_COMMAND_INITIAL_CAPACITY);
+        reserve(&render_data->opaque_commands, HE_DRAW_COMMAND_INITIAL_CAPACITY);
+        reserve(&render_data->alpha_cutoff_commands, HE_DRAW_COMMAND_INITIAL_CAPACITY);
+        reserve(&render_data->transparent_commands, HE_DRAW_COMMAND_INITIAL_CAPACITY);
+        reserve(&render_data->outline_commands, HE_DRAW_COMMAND_INITIAL_CAPACITY);
 
         render_data->light_bin_count = HE_LIGHT_BIN_COUNT;
 
@@ -1086,12 +1103,6 @@ static shaderc_shader_kind shader_stage_to_shaderc_kind(Shader_Stage stage)
     return shaderc_vertex_shader;
 }
 
-struct Shaderc_UserData
-{
-    Allocator allocator;
-    String include_path;
-};
-
 shaderc_include_result *shaderc_include_resolve(void *user_data, const char *requested_source, int type, const char *requesting_source, size_t include_depth)
 {
     Shaderc_UserData *ud = (Shaderc_UserData *)user_data;
@@ -1102,7 +1113,7 @@ shaderc_include_result *shaderc_include_resolve(void *user_data, const char *req
     String path = format_string(memory_context.temp_allocator, "%.*s/%.*s", HE_EXPAND_STRING(ud->include_path), HE_EXPAND_STRING(source));
     Read_Entire_File_Result file_result = read_entire_file(path, ud->allocator);
     HE_ASSERT(file_result.success);
-    shaderc_include_result *result = HE_ALLOCATOR_ALLOCATE(ud->allocator, shaderc_include_result);
+    shaderc_include_result *result = allocate(&shaderc_include_result_pool);
     result->source_name = requested_source;
     result->source_name_length = string_length(requested_source);
     result->user_data = ud;
@@ -1115,7 +1126,7 @@ void shaderc_include_result_release(void *user_data, shaderc_include_result *inc
 {
     Shaderc_UserData *ud = (Shaderc_UserData *)user_data;
     HE_ALLOCATOR_DEALLOCATE(ud->allocator, (void *)include_result->content);
-    HE_ALLOCATOR_DEALLOCATE(ud->allocator, include_result);
+    deallocate(&shaderc_include_result_pool, include_result);
 }
 
 Shader_Compilation_Result renderer_compile_shader(String source, String include_path)
@@ -1125,11 +1136,11 @@ Shader_Compilation_Result renderer_compile_shader(String source, String include_
 
     Memory_Context memory_context = grab_memory_context();
 
-    Shaderc_UserData *shaderc_userdata = HE_ALLOCATOR_ALLOCATE(memory_context.general_allocator, Shaderc_UserData);
+    Shaderc_UserData *shaderc_userdata = allocate(&shaderc_userdata_pool);
     shaderc_userdata->allocator = memory_context.general_allocator;
     shaderc_userdata->include_path = include_path;
 
-    HE_DEFER { HE_ALLOCATOR_DEALLOCATE(memory_context.general_allocator, shaderc_userdata); };
+    HE_DEFER { deallocate(&shaderc_userdata_pool, shaderc_userdata); };
 
     shaderc_compile_options_set_include_callbacks(options, shaderc_include_resolve, shaderc_include_result_release, shaderc_userdata);
     shaderc_compile_options_set_target_env(options, shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_0);
@@ -1706,6 +1717,7 @@ Material_Handle renderer_create_material(const Material_Descriptor &descriptor)
 
         Material_Property *property = &material->properties[property_index];
         property->name = member->name;
+        property->name_id = intern_string(member->name);
         property->data_type = member->data_type;
         property->offset_in_buffer = member->offset;
 
@@ -1766,11 +1778,18 @@ void renderer_destroy_material(Material_Handle &material_handle)
 
 S32 find_property(Material_Handle material_handle, String name)
 {
+    // property names are interned when the material is created, a name that was never interned isn't a property.
+    String_Id name_id = find_string_id(name);
+    if (!name_id)
+    {
+        return -1;
+    }
+
     Material *material = get(&renderer_state->materials, material_handle);
     for (U32 property_index = 0; property_index < material->properties.count; property_index++)
     {
         Material_Property *property = &material->properties[property_index];
-        if (property->name == name)
+        if (property->name_id == name_id)
         {
             return (S32)property_index;
         }
@@ -2766,6 +2785,7 @@ void renderer_destroy_upload_request(Upload_Request_Handle upload_request_handle
 
 void renderer_handle_upload_requests()
 {
+    HE_MEMORY_TAG_SCOPE(Memory_Tag::RENDERING);
     platform_lock_mutex(&renderer_state->pending_upload_requests_mutex);
 
     for (S32 index = 0; index < (S32)renderer_state->pending_upload_requests.count; index++)
@@ -2887,7 +2907,9 @@ void begin_rendering(const Camera *camera)
 
     renderer->begin_frame();
 
+    // begin_frame waited for the gpu to finish the last frame that used this index.
     U32 frame_index = renderer_state->current_frame_in_flight_index;
+    begin_frame_memory(frame_index);
 
     Frame_Render_Data *render_data = &renderer_state->render_data;
     Buffer *global_uniform_buffer = get(&renderer_state->buffers, render_data->globals_uniform_buffers[frame_index]);
@@ -2980,30 +3002,37 @@ void begin_rendering(const Camera *camera)
     reset(&render_data->outline_commands);
     reset(&render_data->lights);
 
+    // the bindless table is rebuilt every frame so it lives in the frame arena begin_frame_memory just reset.
+    Allocator frame_allocator = get_frame_allocator();
     U32 texture_count = renderer_state->textures.capacity;
-    Texture_Handle *textures = HE_ALLOCATOR_ALLOCATE_ARRAY(memory_context.temp_allocator, Texture_Handle, texture_count);
-    Sampler_Handle *samplers = HE_ALLOCATOR_ALLOCATE_ARRAY(memory_context.temp_allocator, Sampler_Handle, texture_count);
+    Texture_Handle *textures = HE_ALLOCATOR_ALLOCATE_ARRAY(frame_allocator, Texture_Handle, texture_count);
+    Sampler_Handle *samplers = HE_ALLOCATOR_ALLOCATE_ARRAY(frame_allocator, Sampler_Handle, texture_count);
 
-    platform_lock_mutex(&renderer_state->textures.mutex);
+    // free slots are skipped by the iteration below, zeroed handles there would never be valid.
+    for (U32 texture_index = 0; texture_index < texture_count; texture_index++)
+    {
+        textures[texture_index] = renderer_state->white_pixel_texture;
+        samplers[texture_index] = renderer_state->default_texture_sampler;
+    }
 
+    // loader threads destroy textures without a lock, a slot can be released and reused between next() and reading it.
+    // the fields are read first and only trusted if the handle is still valid afterwards.
     for (auto it = iterator(&renderer_state->textures); next(&renderer_state->textures, it);)
     {
-        Texture *texture = get(&renderer_state->textures, it);
+        const Texture *texture = &renderer_state->textures.data[it.index];
+        bool is_sampled = !texture->is_attachment && texture->is_uploaded_to_gpu && !texture->is_storage;
+        bool is_cubemap = texture->is_cubemap;
 
-        if (texture->is_attachment || !texture->is_uploaded_to_gpu || texture->is_storage)
-        {
-            textures[it.index] = renderer_state->white_pixel_texture;
-        }
-        else
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (!is_valid_handle(&renderer_state->textures, it))
         {
-            textures[it.index] = it;
+            continue;
         }
 
-        samplers[it.index] = texture->is_cubemap ? renderer_state->default_cubemap_sampler : renderer_state->default_texture_sampler;
+        textures[it.index] = is_sampled ? it : renderer_state->white_pixel_texture;
+        samplers[it.index] = is_cubemap ? renderer_state->default_cubemap_sampler : renderer_state->default_texture_sampler;
     }
 
-    platform_unlock_mutex(&renderer_state->textures.mutex);
-
     Update_Binding_Descriptor update_globals_bindings[] =
     {
         {
@@ -29,6 +29,8 @@
 #define HE_MAX_LIGHT_COUNT 512
 #define HE_LIGHT_BIN_COUNT 32
 
+#define HE_DRAW_COMMAND_INITIAL_CAPACITY 1024
+
 enum RenderingAPI
 {
     RenderingAPI_Vulkan
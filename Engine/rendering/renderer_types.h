@@ -557,6 +557,7 @@ union Material_Property_Data
 struct Material_Property
 {
     String name;
+    String_Id name_id;
 
     Shader_Data_Type data_type;
     Material_Property_Data data;
@@ -173,18 +173,18 @@ static VkPhysicalDevice pick_physical_device(VkInstance instance, VkSurfaceKHR s
 static void* vulkan_allocate(void *user_data, size_t size, size_t alignment, VkSystemAllocationScope allocation_scope)
 {
     HE_ASSERT(alignment <= HE_MAX_U16);
-    return allocate((Free_List_Allocator *)user_data, size, (U16)alignment);
+    return allocate((Thread_Cached_Allocator *)user_data, size, (U16)alignment);
 }
 
 static void vulkan_deallocate(void *user_data, void *memory)
 {
-    return deallocate((Free_List_Allocator *)user_data, memory);
+    return deallocate((Thread_Cached_Allocator *)user_data, memory);
 }
 
 static void* vulkan_reallocate(void *user_data, void *original, size_t size, size_t alignment, VkSystemAllocationScope allocation_scope)
 {
     HE_ASSERT(alignment <= HE_MAX_U16);
-    return reallocate((Free_List_Allocator *)user_data, original, 0, size, (U16)alignment);
+    return reallocate((Thread_Cached_Allocator *)user_data, original, 0, size, (U16)alignment);
 }
 
 static VkDescriptorPool create_descriptor_bool(U32 set_count)
@@ -596,30 +596,14 @@ static bool init_vulkan(Vulkan_Context *context, Engine *engine, Renderer_State
 
     HE_CHECK_VKRESULT(vkCreatePipelineCache(context->logical_device, &pipeline_cache_create_info, &context->allocation_callbacks, &context->pipeline_cache));
 
-    init(&context->thread_states, get_effective_thread_count(),  memory_context.permenent_allocator);
-    
-    S32 slot_index = insert(&context->thread_states, platform_get_current_thread_id());
-    HE_ASSERT(slot_index != -1);
-    Vulkan_Thread_State *main_thread_state = &context->thread_states.values[slot_index];
-
-    VkCommandPoolCreateInfo graphics_command_pool_create_info = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
-    graphics_command_pool_create_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-    graphics_command_pool_create_info.queueFamilyIndex = context->graphics_queue_family_index;
-    HE_CHECK_VKRESULT(vkCreateCommandPool(context->logical_device, &graphics_command_pool_create_info, &context->allocation_callbacks, &main_thread_state->graphics_command_pool));
-
-    VkCommandPoolCreateInfo compute_command_pool_create_info = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
-    compute_command_pool_create_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-    compute_command_pool_create_info.queueFamilyIndex = context->compute_queue_family_index;
-    HE_CHECK_VKRESULT(vkCreateCommandPool(context->logical_device, &compute_command_pool_create_info, &context->allocation_callbacks, &main_thread_state->compute_command_pool));
+    bool thread_states_mutex_created = platform_create_mutex(&context->thread_states_mutex);
+    HE_ASSERT(thread_states_mutex_created);
+    context->thread_states = nullptr;
 
+    Vulkan_Thread_State *main_thread_state = get_thread_state(context);
     context->graphics_command_pool = main_thread_state->graphics_command_pool;
     context->compute_command_pool = main_thread_state->compute_command_pool;
 
-    VkCommandPoolCreateInfo transfer_command_pool_create_info = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
-    transfer_command_pool_create_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-    transfer_command_pool_create_info.queueFamilyIndex = context->transfer_queue_family_index;
-    HE_CHECK_VKRESULT(vkCreateCommandPool(context->logical_device, &transfer_command_pool_create_info, &context->allocation_callbacks, &main_thread_state->transfer_command_pool));
-
     VkCommandBufferAllocateInfo graphics_command_buffer_allocate_info = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
     graphics_command_buffer_allocate_info.commandPool = main_thread_state->graphics_command_pool;
     graphics_command_buffer_allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
@@ -710,13 +694,8 @@ void deinit_vulkan(Vulkan_Context *context)
         vkDestroySemaphore(context->logical_device, context->rendering_finished_semaphores[frame_index], &context->allocation_callbacks);
     }
 
-    for (U32 slot_index = 0; slot_index < context->thread_states.capacity; slot_index++)
+    for (Vulkan_Thread_State *thread_state = context->thread_states; thread_state; thread_state = thread_state->next)
     {
-        if (context->thread_states.states[slot_index] != Slot_State::OCCUPIED)
-        {
-            continue;
-        }
-        Vulkan_Thread_State *thread_state = &context->thread_states.values[slot_index];
         vkDestroyCommandPool(context->logical_device, thread_state->graphics_command_pool, &context->allocation_callbacks);
         vkDestroyCommandPool(context->logical_device, thread_state->transfer_command_pool, &context->allocation_callbacks);
         vkDestroyCommandPool(context->logical_device, thread_state->compute_command_pool, &context->allocation_callbacks);
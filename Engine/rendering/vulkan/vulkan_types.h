@@ -7,8 +7,6 @@
 #include "core/memory.h"
 #include "core/platform.h"
 
-#include "containers/hash_map.h"
-
 #include "rendering/renderer_types.h"
 
 #define HE_VULKAN_PIPELINE_CACHE_FILE_PATH "vulkan/pipeline_cache.bin"
@@ -143,6 +141,8 @@ struct Vulkan_Thread_State
     VkCommandPool compute_command_pool;
 
     Dynamic_Array< Vulkan_Command_Buffer > command_buffers;
+
+    Vulkan_Thread_State *next;
 };
 
 struct Vulkan_Upload_Request
@@ -183,7 +183,9 @@ struct Vulkan_Context
     Counted_Array< Vulkan_Descriptor_Pool_Size_Ratio, HE_MAX_DESCRIPTOR_POOL_SIZE_RATIO_COUNT > descriptor_pool_ratios;
     Vulkan_Descriptor_Pool_Allocator descriptor_pool_allocators[HE_MAX_FRAMES_IN_FLIGHT];
     
-    Hash_Map< U32, Vulkan_Thread_State > thread_states;
+    // created on first use by each thread and reached through its thread context.
+    Mutex thread_states_mutex;
+    Vulkan_Thread_State *thread_states;
 
     VkCommandPool graphics_command_pool;
     VkCommandPool compute_command_pool;
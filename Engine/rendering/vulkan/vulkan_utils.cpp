@@ -393,17 +393,14 @@ void copy_data_to_image(Vulkan_Context *context, Vulkan_Command_Buffer *command_
 
 Vulkan_Thread_State *get_thread_state(Vulkan_Context *context)
 {
-    U32 thread_id = platform_get_current_thread_id();
-    auto it = find(&context->thread_states, thread_id);
-    if (is_valid(it))
+    Thread_Context *thread_context = get_thread_context();
+    if (thread_context->renderer_thread_state)
     {
-        return it.value;
+        return (Vulkan_Thread_State *)thread_context->renderer_thread_state;
     }
 
-    S32 slot_index = insert(&context->thread_states, thread_id);
-    HE_ASSERT(slot_index != -1);
-
-    Vulkan_Thread_State *thread_state = &context->thread_states.values[slot_index];
+    Memory_Context memory_context = grab_memory_context();
+    Vulkan_Thread_State *thread_state = HE_ALLOCATOR_ALLOCATE(memory_context.general_allocator, Vulkan_Thread_State);
 
     VkCommandPoolCreateInfo graphics_command_pool_create_info = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
     graphics_command_pool_create_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
@@ -422,6 +419,12 @@ Vulkan_Thread_State *get_thread_state(Vulkan_Context *context)
 
     // sinit(&thread_state->command_buffers);
 
+    platform_lock_mutex(&context->thread_states_mutex);
+    thread_state->next = context->thread_states;
+    context->thread_states = thread_state;
+    platform_unlock_mutex(&context->thread_states_mutex);
+
+    thread_context->renderer_thread_state = thread_state;
     return thread_state;
 }
 
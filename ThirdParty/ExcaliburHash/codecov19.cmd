@@ -1,3 +0,0 @@
-if exist ./codecov_report/ (rd /S /Q ./codecov_report/)
-rem Install OpenCppCoverage from here https://github.com/OpenCppCoverage/OpenCppCoverage/releases
-OpenCppCoverage.exe --export_type html:codecov_report --stop_on_assert --sources ExcaliburHashTest*.* --sources ExcaliburHash.h --excluded_sources *googletest* --modules *.exe -- .\build2019\Debug\ExcaliburHashTest.exe
\ No newline at end of file
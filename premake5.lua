@@ -50,7 +50,7 @@ project "Engine"
 
     files { "Engine/**.h", "Engine/**.hpp", "Engine/**.cpp", "ThirdParty/ImGuizmo/ImGuizmo.h", "ThirdParty/ImGuizmo/ImGuizmo.cpp" }
 
-    includedirs { "Engine", "ThirdParty", "ThirdParty/ExcaliburHash", "ThirdParty/ExcaliburHash/ExcaliburHash", "ThirdParty/ImGui", "ThirdParty/include" }
+    includedirs { "Engine", "ThirdParty", "ThirdParty/ImGui", "ThirdParty/include" }
     libdirs { "ThirdParty/lib" }
 
     links
@@ -111,9 +111,31 @@ project "Editor"
         "Engine"
     }
 
-    includedirs { "Engine", "ThirdParty", "ThirdParty/ImGui", "ThirdParty/ExcaliburHash", "ThirdParty/ExcaliburHash/ExcaliburHash", "ThirdParty/include" }
+    includedirs { "Engine", "ThirdParty", "ThirdParty/ImGui", "ThirdParty/include" }
 
     debugdir "Data"
     targetdir "bin/%{prj.name}"
     objdir "bin/intermediates/%{prj.name}"
-    targetname "Elpis"
\ No newline at end of file
+    targetname "Elpis"
+
+project "Benchmarks"
+
+    dependson { "Engine" }
+
+    kind "ConsoleApp"
+    location "Benchmarks"
+    language "C++"
+    cppdialect "C++20"
+    staticruntime "off"
+
+    files { "Benchmarks/**.h", "Benchmarks/**.cpp" }
+
+    links
+    {
+        "Engine"
+    }
+
+    includedirs { "Engine", "ThirdParty", "ThirdParty/ImGui", "ThirdParty/include" }
+
+    targetdir "bin/%{prj.name}"
+    objdir "bin/intermediates/%{prj.name}"